@@ -0,0 +1,310 @@
+/**
+ * @file calor.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Mapa de calor dos efeitos nefastos (numero de efeitos por celula)
+ * @details As listas de antenas e efeitos sao percorridas para um array com a celula de cada
+ * efeito, ja agrupado por frequencia numa unica passagem (ordenacao por contagem), pelo que cada
+ * frequencia e so uma fatia do array. A contagem e feita em paralelo com OpenMP sem grelhas
+ * privadas: os efeitos sao distribuidos por faixas de linhas (ordenacao por contagem paralela)
+ * e cada faixa e somada por uma unica thread diretamente na grelha final. A memoria extra e
+ * proporcional ao numero de efeitos, nao a threads x celulas. O resultado e exportado em PGM
+ * binario (P5).
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @brief Efeitos ja convertidos para celulas da grelha, agrupados por frequencia
+ */
+typedef struct EfeitosGrelha {
+    int linhas;
+    int colunas;
+    long long* celulas;         // celula de cada efeito dentro da grelha, agrupadas por frequencia
+    long long inicio[257];      // efeitos da frequencia f em celulas[inicio[f] .. inicio[f+1]-1]
+} EfeitosGrelha;
+
+/**
+ * @brief Par id/frequencia para procurar a frequencia de uma antena pelo id
+ */
+typedef struct IdFrequencia {
+    int id;
+    char frequencia;
+} IdFrequencia;
+
+static int compararIds(const void* a, const void* b) {
+    int x = ((const IdFrequencia*)a)->id;
+    int y = ((const IdFrequencia*)b)->id;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Converte as listas no array de celulas dos efeitos, agrupado por frequencia
+ * A grelha tem as dimensoes usadas por gravarMatrizTxt; efeitos fora dela nao sao guardados
+ *
+ * @param h (apontador para o inicio da lista de antenas)
+ * @param efeitos (apontador para o inicio da lista de efeitos)
+ * @param grelha (estrutura a preencher)
+ * @return true
+ * @return false
+ */
+static bool prepararEfeitos(Antena* h, Nefasto* efeitos, EfeitosGrelha* grelha) {
+    int maxLinha = 0, maxColuna = 0;
+    long long numAntenas = 0, numEfeitos = 0;
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        if (aux->linha > maxLinha) maxLinha = aux->linha;
+        if (aux->coluna > maxColuna) maxColuna = aux->coluna;
+        numAntenas++;
+    }
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next) {
+        if (aux->linha > maxLinha) maxLinha = aux->linha;
+        if (aux->coluna > maxColuna) maxColuna = aux->coluna;
+        numEfeitos++;
+    }
+    grelha->linhas = maxLinha;
+    grelha->colunas = maxColuna;
+    unsigned char* frequencias = (unsigned char*)malloc(numEfeitos > 0 ? (size_t)numEfeitos : 1);
+    IdFrequencia* ids = (IdFrequencia*)malloc((numAntenas > 0 ? (size_t)numAntenas : 1) * sizeof(IdFrequencia));
+    if (frequencias == NULL || ids == NULL) {
+        free(frequencias);
+        free(ids);
+        return false;
+    }
+    // a lista esta ordenada por posicao, por isso os ids sao ordenados para a procura binaria
+    long long k = 0;
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        ids[k].id = aux->id;
+        ids[k].frequencia = aux->frequencia;
+        k++;
+    }
+    qsort(ids, (size_t)numAntenas, sizeof(IdFrequencia), compararIds);
+
+    // primeira passagem: frequencia de cada efeito e quantos efeitos dentro da grelha tem cada uma
+    long long contagem[256] = { 0 };
+    k = 0;
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next, k++) {
+        IdFrequencia chave = { aux->idAntena1, 0 };
+        IdFrequencia* antena = (IdFrequencia*)bsearch(&chave, ids, (size_t)numAntenas, sizeof(IdFrequencia), compararIds);
+        frequencias[k] = antena != NULL ? (unsigned char)antena->frequencia : 0;
+        if (aux->linha >= 1 && aux->coluna >= 1) contagem[frequencias[k]]++;
+    }
+    free(ids);
+    grelha->inicio[0] = 0;
+    for (int f = 0; f < 256; f++) grelha->inicio[f + 1] = grelha->inicio[f] + contagem[f];
+    grelha->celulas = (long long*)malloc((grelha->inicio[256] > 0 ? (size_t)grelha->inicio[256] : 1) * sizeof(long long));
+    if (grelha->celulas == NULL) {
+        free(frequencias);
+        return false;
+    }
+    // segunda passagem: cada celula vai para a fatia da sua frequencia
+    long long posicao[256];
+    for (int f = 0; f < 256; f++) posicao[f] = grelha->inicio[f];
+    k = 0;
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next, k++) {
+        if (aux->linha < 1 || aux->coluna < 1) continue;
+        grelha->celulas[posicao[frequencias[k]]++] = (long long)(aux->linha - 1) * maxColuna + (aux->coluna - 1);
+    }
+    free(frequencias);
+    return true;
+}
+
+/**
+ * @brief Conta os efeitos de cada celula: distribui-os por faixas de linhas e soma cada faixa numa so thread
+ *
+ * @param grelha (efeitos ja convertidos)
+ * @param celulas (fatia de celulas a contar)
+ * @param numEfeitos (tamanho da fatia)
+ * @return MapaCalor*
+ */
+static MapaCalor* acumularMapa(const EfeitosGrelha* grelha, const long long* celulas, long long numEfeitos) {
+    MapaCalor* mapa = (MapaCalor*)malloc(sizeof(MapaCalor));
+    if (mapa == NULL) return NULL;
+    long long numCelulas = (long long)grelha->linhas * grelha->colunas;
+    mapa->linhas = grelha->linhas;
+    mapa->colunas = grelha->colunas;
+    mapa->maximo = 0;
+    mapa->total = numEfeitos;
+    mapa->contagens = (unsigned int*)calloc(numCelulas > 0 ? (size_t)numCelulas : 1, sizeof(unsigned int));
+    if (mapa->contagens == NULL) return DestroiMapaCalor(mapa);
+    if (numEfeitos == 0) return mapa;
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    // varias faixas por thread para equilibrar mapas com efeitos concentrados
+    int numFaixas = numThreads * 8 < grelha->linhas ? numThreads * 8 : grelha->linhas;
+    long long linhasFaixa = (grelha->linhas + numFaixas - 1) / numFaixas;
+    long long celulasFaixa = linhasFaixa * grelha->colunas;
+    long long* posicoes = (long long*)calloc((size_t)numThreads * numFaixas, sizeof(long long));
+    long long* inicioFaixa = (long long*)malloc(((size_t)numFaixas + 1) * sizeof(long long));
+    long long* ordenadas = (long long*)malloc((size_t)numEfeitos * sizeof(long long));
+    if (posicoes == NULL || inicioFaixa == NULL || ordenadas == NULL) {
+        free(posicoes);
+        free(inicioFaixa);
+        free(ordenadas);
+        return DestroiMapaCalor(mapa);
+    }
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        int t = 0;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+#endif
+        long long* minhas = posicoes + (size_t)t * numFaixas;
+        // contagem por faixa em cada thread (histogramas pequenos: threads x faixas)
+        #pragma omp for schedule(static)
+        for (long long i = 0; i < numEfeitos; i++) minhas[celulas[i] / celulasFaixa]++;
+        #pragma omp single
+        {
+            long long soma = 0;
+            for (int f = 0; f < numFaixas; f++) {
+                inicioFaixa[f] = soma;
+                for (int p = 0; p < numThreads; p++) {
+                    long long n = posicoes[(size_t)p * numFaixas + f];
+                    posicoes[(size_t)p * numFaixas + f] = soma;
+                    soma += n;
+                }
+            }
+            inicioFaixa[numFaixas] = soma;
+        }
+        // a mesma divisao estatica do primeiro ciclo: cada thread escreve nas posicoes que reservou
+        #pragma omp for schedule(static)
+        for (long long i = 0; i < numEfeitos; i++) ordenadas[minhas[celulas[i] / celulasFaixa]++] = celulas[i];
+        // cada faixa cobre linhas diferentes da grelha, por isso nao ha escritas concorrentes
+        #pragma omp for schedule(dynamic)
+        for (int f = 0; f < numFaixas; f++) {
+            for (long long i = inicioFaixa[f]; i < inicioFaixa[f + 1]; i++) mapa->contagens[ordenadas[i]]++;
+        }
+    }
+    free(posicoes);
+    free(inicioFaixa);
+    free(ordenadas);
+    for (long long c = 0; c < numCelulas; c++) {
+        if (mapa->contagens[c] > mapa->maximo) mapa->maximo = mapa->contagens[c];
+    }
+    return mapa;
+}
+
+/**
+ * @brief Cria o mapa de calor dos efeitos nefastos
+ * A grelha tem as mesmas dimensoes da matriz de gravarMatrizTxt; efeitos fora dela sao ignorados
+ *
+ * @param h (apontador para o inicio da lista de antenas)
+ * @param efeitos (apontador para o inicio da lista de efeitos)
+ * @param frequencia (so conta efeitos de antenas desta frequencia; negativo para todas)
+ * @return MapaCalor*
+ */
+MapaCalor* criarMapaCalor(Antena* h, Nefasto* efeitos, int frequencia) {
+    if (h == NULL) return NULL;
+    EfeitosGrelha grelha;
+    if (!prepararEfeitos(h, efeitos, &grelha)) return NULL;
+    MapaCalor* mapa = frequencia < 0
+        ? acumularMapa(&grelha, grelha.celulas, grelha.inicio[256])
+        : acumularMapa(&grelha, grelha.celulas + grelha.inicio[frequencia & 0xFF], grelha.inicio[(frequencia & 0xFF) + 1] - grelha.inicio[frequencia & 0xFF]);
+    free(grelha.celulas);
+    return mapa;
+}
+
+/**
+ * @brief Grava o mapa de calor numa imagem PGM binaria (P5)
+ * Com ate 65535 efeitos por celula os valores sao as contagens exatas (8 bits se o maximo
+ * couber num byte, 16 bits caso contrario); acima disso sao escalados para 0..65535
+ *
+ * @param mapa (mapa de calor)
+ * @param ficheiro (nome do ficheiro)
+ * @return true
+ * @return false
+ */
+bool gravarMapaCalorPGM(MapaCalor* mapa, const char* ficheiro) {
+    if (mapa == NULL || mapa->linhas <= 0 || mapa->colunas <= 0) return false;
+    FILE* fp = fopen(ficheiro, "wb");
+    if (fp == NULL) return false;
+    unsigned int valorMaximo = mapa->maximo > 0 ? mapa->maximo : 1;
+    if (valorMaximo > 65535) valorMaximo = 65535;
+    int bytes = valorMaximo > 255 ? 2 : 1;
+    fprintf(fp, "P5\n%d %d\n%u\n", mapa->colunas, mapa->linhas, valorMaximo);
+
+    unsigned char* linha = (unsigned char*)malloc((size_t)mapa->colunas * bytes);
+    bool sucesso = linha != NULL;
+    for (int i = 0; sucesso && i < mapa->linhas; i++) {
+        for (int j = 0; j < mapa->colunas; j++) {
+            unsigned int valor = mapa->contagens[(long long)i * mapa->colunas + j];
+            if (mapa->maximo > 65535) valor = (unsigned int)((double)valor * 65535.0 / mapa->maximo);
+            if (bytes == 1) linha[j] = (unsigned char)valor;
+            else {
+                linha[2 * j] = (unsigned char)(valor >> 8); // o formato usa o byte mais significativo primeiro
+                linha[2 * j + 1] = (unsigned char)(valor & 0xFF);
+            }
+        }
+        if (fwrite(linha, bytes, mapa->colunas, fp) != (size_t)mapa->colunas) sucesso = false;
+    }
+    free(linha);
+    if (fclose(fp) != 0) sucesso = false;
+    return sucesso;
+}
+
+/**
+ * @brief Grava um mapa de calor por frequencia (<prefixo>_<codigo>.pgm) e um resumo (<prefixo>.txt)
+ * Os efeitos sao agrupados por frequencia uma unica vez; cada mapa conta so a fatia da sua frequencia
+ *
+ * @param h (apontador para o inicio da lista de antenas)
+ * @param efeitos (apontador para o inicio da lista de efeitos)
+ * @param prefixo (prefixo dos ficheiros)
+ * @return true
+ * @return false
+ */
+bool gravarMapasCalorFrequencias(Antena* h, Nefasto* efeitos, const char* prefixo) {
+    if (h == NULL || prefixo == NULL) return false;
+    EfeitosGrelha grelha;
+    if (!prepararEfeitos(h, efeitos, &grelha)) return false;
+    bool presentes[256] = { false };
+    for (Antena* aux = h; aux != NULL; aux = aux->next) presentes[(unsigned char)aux->frequencia] = true;
+
+    char nome[512];
+    snprintf(nome, sizeof(nome), "%s.txt", prefixo);
+    FILE* resumo = fopen(nome, "w");
+    bool sucesso = resumo != NULL;
+    if (sucesso) fprintf(resumo, "frequencia codigo efeitos celulas maximo\n");
+    for (int f = 0; sucesso && f < 256; f++) {
+        if (!presentes[f]) continue;
+        MapaCalor* mapa = acumularMapa(&grelha, grelha.celulas + grelha.inicio[f], grelha.inicio[f + 1] - grelha.inicio[f]);
+        if (mapa == NULL) {
+            sucesso = false;
+            break;
+        }
+        long long afetadas = 0;
+        for (long long c = 0; c < (long long)mapa->linhas * mapa->colunas; c++) afetadas += mapa->contagens[c] > 0;
+        fprintf(resumo, "%c %d %lld %lld %u\n", (f >= 33 && f < 127) ? f : '?', f, mapa->total, afetadas, mapa->maximo);
+        snprintf(nome, sizeof(nome), "%s_%d.pgm", prefixo, f);
+        if (!gravarMapaCalorPGM(mapa, nome)) sucesso = false;
+        DestroiMapaCalor(mapa);
+    }
+    if (resumo != NULL && fclose(resumo) != 0) sucesso = false;
+    free(grelha.celulas);
+    return sucesso;
+}
+
+/**
+ * @brief Liberta a memoria de um mapa de calor
+ *
+ * @param mapa (mapa de calor)
+ * @return MapaCalor* Retorna NULL
+ */
+MapaCalor* DestroiMapaCalor(MapaCalor* mapa) {
+    if (mapa != NULL) {
+        free(mapa->contagens);
+        free(mapa);
+    }
+    return NULL;
+}
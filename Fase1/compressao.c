@@ -0,0 +1,412 @@
+/**
+ * @file compressao.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Instantaneo comprimido das antenas e efeitos (deltas + varint LEB128)
+ * @details Os registos sao agrupados por frequencia (os efeitos pela frequencia da antena que
+ * os causa) e, dentro de cada grupo, mantem a ordem por linha e coluna das listas. Cada grupo
+ * e cortado em blocos independentes: o primeiro registo do bloco e absoluto e os seguintes
+ * guardam so as diferencas para o anterior, em varint (7 bits por byte). Um diretorio no inicio
+ * do ficheiro indica o tamanho de cada bloco, para que os blocos possam ser codificados e
+ * descodificados em paralelo (OpenMP).
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+#include <stdint.h>
+#include <limits.h>
+
+#define COMPRIMIDO_MAGICO 0x5A414445u   // "EDAZ"
+#define COMPRIMIDO_VERSAO 1u
+#define COMPRIMIDO_BLOCO 4096           // registos por bloco
+#define COMPRIMIDO_MAX_ANTENA 15        // bytes maximos de uma antena codificada (3 varints)
+#define COMPRIMIDO_MAX_EFEITO 20        // bytes maximos de um efeito codificado (4 varints)
+#define BLOCO_ANTENAS 0
+#define BLOCO_EFEITOS 1
+
+/**
+ * @brief Entrada do diretorio de blocos
+ */
+typedef struct EntradaBloco {
+    uint8_t tipo;           // BLOCO_ANTENAS ou BLOCO_EFEITOS
+    uint8_t frequencia;     // frequencia do grupo
+    uint16_t reservado;
+    uint32_t numRegistos;   // registos no bloco
+    uint32_t tamanho;       // bytes codificados
+    uint32_t soma;          // soma de verificacao (FNV-1a) dos bytes
+} EntradaBloco;
+
+/**
+ * @brief Registo de trabalho (antena ou efeito) usado na codificacao e descodificacao
+ */
+typedef struct RegistoComprimido {
+    int linha;
+    int coluna;
+    int a;                  // id da antena ou idAntena1
+    int b;                  // frequencia da antena ou idAntena2
+} RegistoComprimido;
+
+static uint32_t somaBloco(const unsigned char* dados, size_t tamanho) {
+    uint32_t soma = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        soma ^= dados[i];
+        soma *= 16777619u;
+    }
+    return soma;
+}
+
+/**
+ * @brief Converte uma diferenca de 32 bits para sem sinal (zigzag: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ...)
+ * As diferencas sao calculadas em uint32_t com aritmetica modular, pelo que qualquer par de int
+ * (por exemplo -1 e INT_MAX) e codificado sem perda
+ */
+static uint32_t zigzag(uint32_t diferenca) {
+    return (diferenca << 1) ^ (0u - (diferenca >> 31));
+}
+
+static uint32_t desfazerZigzag(uint32_t valor) {
+    return (valor >> 1) ^ (0u - (valor & 1));
+}
+
+/**
+ * @brief Converte os 32 bits de volta para int (complemento para dois) sem depender da implementacao
+ */
+static int paraInt(uint32_t valor) {
+    return valor <= (uint32_t)INT_MAX ? (int)valor : -(int)(~valor) - 1;
+}
+
+static size_t escreverVarint(unsigned char* destino, uint32_t valor) {
+    size_t n = 0;
+    while (valor >= 0x80) {
+        destino[n++] = (unsigned char)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[n++] = (unsigned char)valor;
+    return n;
+}
+
+/**
+ * @brief Le um varint sem passar do fim do bloco
+ * @return size_t (bytes lidos, 0 se o varint for invalido)
+ */
+static size_t lerVarint(const unsigned char* origem, size_t disponiveis, uint32_t* valor) {
+    uint32_t resultado = 0;
+    for (size_t n = 0; n < disponiveis && n < 5; n++) {
+        resultado |= (uint32_t)(origem[n] & 0x7F) << (7 * n);
+        if ((origem[n] & 0x80) == 0) {
+            *valor = resultado;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Codifica um bloco de registos
+ * Linha: diferenca para a anterior (zigzag). Coluna: diferenca se a linha for igual, absoluta caso
+ * contrario (zigzag). Ids: diferenca para o anterior; nos efeitos idAntena2 e relativo a idAntena1.
+ * Nas antenas o campo b (frequencia) e implicito no grupo e nao e gravado.
+ *
+ * @param registos (registos do bloco)
+ * @param n (numero de registos)
+ * @param tipo (BLOCO_ANTENAS ou BLOCO_EFEITOS)
+ * @param destino (buffer com espaco para o pior caso)
+ * @return size_t (bytes escritos)
+ */
+static size_t codificarBloco(const RegistoComprimido* registos, size_t n, int tipo, unsigned char* destino) {
+    size_t p = 0;
+    RegistoComprimido anterior = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < n; i++) {
+        const RegistoComprimido* r = &registos[i];
+        p += escreverVarint(destino + p, zigzag((uint32_t)r->linha - (uint32_t)anterior.linha));
+        p += escreverVarint(destino + p, zigzag(r->linha == anterior.linha ? (uint32_t)r->coluna - (uint32_t)anterior.coluna : (uint32_t)r->coluna));
+        p += escreverVarint(destino + p, zigzag((uint32_t)r->a - (uint32_t)anterior.a));
+        if (tipo == BLOCO_EFEITOS) p += escreverVarint(destino + p, zigzag((uint32_t)r->b - (uint32_t)r->a));
+        anterior = *r;
+    }
+    return p;
+}
+
+/**
+ * @brief Descodifica um bloco de registos
+ * @return true (false se o bloco estiver corrompido)
+ */
+static bool descodificarBloco(const unsigned char* origem, size_t tamanho, const EntradaBloco* entrada, RegistoComprimido* registos) {
+    size_t p = 0;
+    RegistoComprimido anterior = { 0, 0, 0, 0 };
+    for (uint32_t i = 0; i < entrada->numRegistos; i++) {
+        uint32_t v[4];
+        int campos = entrada->tipo == BLOCO_EFEITOS ? 4 : 3;
+        for (int k = 0; k < campos; k++) {
+            size_t lidos = lerVarint(origem + p, tamanho - p, &v[k]);
+            if (lidos == 0) return false;
+            p += lidos;
+        }
+        RegistoComprimido r;
+        r.linha = paraInt((uint32_t)anterior.linha + desfazerZigzag(v[0]));
+        r.coluna = paraInt(v[0] == 0 ? (uint32_t)anterior.coluna + desfazerZigzag(v[1]) : desfazerZigzag(v[1]));
+        r.a = paraInt((uint32_t)anterior.a + desfazerZigzag(v[2]));
+        r.b = entrada->tipo == BLOCO_EFEITOS ? paraInt((uint32_t)r.a + desfazerZigzag(v[3])) : entrada->frequencia;
+        registos[i] = r;
+        anterior = r;
+    }
+    return p == tamanho;
+}
+
+/**
+ * @brief Agrupa registos por frequencia mantendo a ordem dentro de cada grupo (ordenacao por contagem)
+ *
+ * @param registos (registos pela ordem da lista)
+ * @param frequencias (frequencia de cada registo)
+ * @param n (numero de registos)
+ * @param agrupados (destino)
+ * @param inicio (inicio de cada frequencia em agrupados, 257 posicoes)
+ */
+static void agruparPorFrequencia(const RegistoComprimido* registos, const unsigned char* frequencias, long n, RegistoComprimido* agrupados, long* inicio) {
+    for (int f = 0; f <= 256; f++) inicio[f] = 0;
+    for (long i = 0; i < n; i++) inicio[frequencias[i] + 1]++;
+    for (int f = 0; f < 256; f++) inicio[f + 1] += inicio[f];
+    long posicao[256];
+    for (int f = 0; f < 256; f++) posicao[f] = inicio[f];
+    for (long i = 0; i < n; i++) agrupados[posicao[frequencias[i]]++] = registos[i];
+}
+
+static int compararIdFrequencia(const void* a, const void* b) {
+    int x = ((const RegistoComprimido*)a)->a;
+    int y = ((const RegistoComprimido*)b)->a;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Grava as listas de antenas e efeitos num instantaneo comprimido
+ *
+ * @param h (apontador para o inicio da lista de antenas)
+ * @param efeitos (apontador para o inicio da lista de efeitos)
+ * @param nomeFicheiro
+ * @return true
+ * @return false
+ */
+bool gravarFicheiroComprimido(Antena* h, Nefasto* efeitos, const char* nomeFicheiro) {
+    if (nomeFicheiro == NULL) return false;
+    long numAntenas = 0, numEfeitos = 0;
+    for (Antena* aux = h; aux != NULL; aux = aux->next) numAntenas++;
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next) numEfeitos++;
+    long total = numAntenas + numEfeitos;
+    RegistoComprimido* registos = (RegistoComprimido*)malloc((total > 0 ? total : 1) * sizeof(RegistoComprimido));
+    RegistoComprimido* agrupados = (RegistoComprimido*)malloc((total > 0 ? total : 1) * sizeof(RegistoComprimido));
+    RegistoComprimido* ids = (RegistoComprimido*)malloc((numAntenas > 0 ? numAntenas : 1) * sizeof(RegistoComprimido));
+    unsigned char* frequencias = (unsigned char*)malloc(total > 0 ? total : 1);
+    if (registos == NULL || agrupados == NULL || ids == NULL || frequencias == NULL) {
+        free(registos);
+        free(agrupados);
+        free(ids);
+        free(frequencias);
+        return false;
+    }
+    long k = 0;
+    for (Antena* aux = h; aux != NULL; aux = aux->next, k++) {
+        RegistoComprimido r = { aux->linha, aux->coluna, aux->id, (unsigned char)aux->frequencia };
+        registos[k] = r;
+        ids[k] = r;
+        frequencias[k] = (unsigned char)aux->frequencia;
+    }
+    qsort(ids, numAntenas, sizeof(RegistoComprimido), compararIdFrequencia);
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next, k++) {
+        RegistoComprimido r = { aux->linha, aux->coluna, aux->idAntena1, aux->idAntena2 };
+        registos[k] = r;
+        RegistoComprimido* antena = (RegistoComprimido*)bsearch(&r, ids, numAntenas, sizeof(RegistoComprimido), compararIdFrequencia);
+        frequencias[k] = antena != NULL ? (unsigned char)antena->b : 0;
+    }
+    free(ids);
+    long inicioAntenas[257], inicioEfeitos[257];
+    agruparPorFrequencia(registos, frequencias, numAntenas, agrupados, inicioAntenas);
+    agruparPorFrequencia(registos + numAntenas, frequencias + numAntenas, numEfeitos, agrupados + numAntenas, inicioEfeitos);
+    free(registos);
+    free(frequencias);
+
+    // diretorio: cada grupo e cortado em blocos de COMPRIMIDO_BLOCO registos
+    int numBlocos = 0;
+    for (int tipo = 0; tipo < 2; tipo++) {
+        long* inicio = tipo == BLOCO_ANTENAS ? inicioAntenas : inicioEfeitos;
+        for (int f = 0; f < 256; f++) numBlocos += (int)((inicio[f + 1] - inicio[f] + COMPRIMIDO_BLOCO - 1) / COMPRIMIDO_BLOCO);
+    }
+    EntradaBloco* diretorio = (EntradaBloco*)calloc(numBlocos > 0 ? numBlocos : 1, sizeof(EntradaBloco));
+    long* primeiro = (long*)malloc((numBlocos > 0 ? numBlocos : 1) * sizeof(long));
+    size_t* deslocamento = (size_t*)malloc(((size_t)numBlocos + 1) * sizeof(size_t));
+    if (diretorio == NULL || primeiro == NULL || deslocamento == NULL) {
+        free(diretorio);
+        free(primeiro);
+        free(deslocamento);
+        free(agrupados);
+        return false;
+    }
+    int b = 0;
+    size_t maximo = 0;
+    for (int tipo = 0; tipo < 2; tipo++) {
+        long* inicio = tipo == BLOCO_ANTENAS ? inicioAntenas : inicioEfeitos;
+        long base = tipo == BLOCO_ANTENAS ? 0 : numAntenas;
+        for (int f = 0; f < 256; f++) {
+            for (long i = inicio[f]; i < inicio[f + 1]; i += COMPRIMIDO_BLOCO) {
+                long n = inicio[f + 1] - i < COMPRIMIDO_BLOCO ? inicio[f + 1] - i : COMPRIMIDO_BLOCO;
+                diretorio[b].tipo = (uint8_t)tipo;
+                diretorio[b].frequencia = (uint8_t)f;
+                diretorio[b].numRegistos = (uint32_t)n;
+                primeiro[b] = base + i;
+                deslocamento[b] = maximo;
+                maximo += (size_t)n * (tipo == BLOCO_ANTENAS ? COMPRIMIDO_MAX_ANTENA : COMPRIMIDO_MAX_EFEITO);
+                b++;
+            }
+        }
+    }
+    unsigned char* dados = (unsigned char*)malloc(maximo > 0 ? maximo : 1);
+    if (dados == NULL) {
+        free(diretorio);
+        free(primeiro);
+        free(deslocamento);
+        free(agrupados);
+        return false;
+    }
+
+    // os blocos sao independentes, por isso cada um e codificado na sua zona do buffer
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numBlocos; i++) {
+        unsigned char* destino = dados + deslocamento[i];
+        diretorio[i].tamanho = (uint32_t)codificarBloco(agrupados + primeiro[i], diretorio[i].numRegistos, diretorio[i].tipo, destino);
+        diretorio[i].soma = somaBloco(destino, diretorio[i].tamanho);
+    }
+    free(agrupados);
+
+    FILE* fp = fopen(nomeFicheiro, "wb");
+    bool sucesso = fp != NULL;
+    uint32_t cabecalho[4] = { COMPRIMIDO_MAGICO, COMPRIMIDO_VERSAO, (uint32_t)numBlocos, 0 };
+    if (sucesso) sucesso = fwrite(cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+        fwrite(diretorio, sizeof(EntradaBloco), numBlocos, fp) == (size_t)numBlocos;
+    for (int i = 0; sucesso && i < numBlocos; i++) {
+        sucesso = fwrite(dados + deslocamento[i], 1, diretorio[i].tamanho, fp) == diretorio[i].tamanho;
+    }
+    if (fp != NULL && fclose(fp) != 0) sucesso = false;
+    free(dados);
+    free(diretorio);
+    free(primeiro);
+    free(deslocamento);
+    return sucesso;
+}
+
+/**
+ * @brief Compara registos por linha e coluna (e ids, para uma ordem estavel dos efeitos)
+ */
+static int compararPosicao(const void* a, const void* b) {
+    const RegistoComprimido* r1 = (const RegistoComprimido*)a;
+    const RegistoComprimido* r2 = (const RegistoComprimido*)b;
+    if (r1->linha != r2->linha) return r1->linha < r2->linha ? -1 : 1;
+    if (r1->coluna != r2->coluna) return r1->coluna < r2->coluna ? -1 : 1;
+    if (r1->a != r2->a) return r1->a < r2->a ? -1 : 1;
+    if (r1->b != r2->b) return r1->b < r2->b ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Le um instantaneo comprimido e reconstroi as listas, ordenadas por linha e coluna
+ * Os efeitos na mesma celula ficam ordenados pelos ids
+ *
+ * @param nomeFicheiro
+ * @param antenas (apontador para a lista de antenas criada)
+ * @param efeitos (apontador para a lista de efeitos criada, pode ser NULL)
+ * @return true
+ * @return false
+ */
+bool lerFicheiroComprimido(const char* nomeFicheiro, Antena** antenas, Nefasto** efeitos) {
+    if (nomeFicheiro == NULL || antenas == NULL) return false;
+    *antenas = NULL;
+    if (efeitos != NULL) *efeitos = NULL;
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    if (fp == NULL) return false;
+    uint32_t cabecalho[4];
+    if (fread(cabecalho, sizeof(cabecalho), 1, fp) != 1 || cabecalho[0] != COMPRIMIDO_MAGICO || cabecalho[1] != COMPRIMIDO_VERSAO) {
+        fclose(fp);
+        return false;
+    }
+    int numBlocos = (int)cabecalho[2];
+    EntradaBloco* diretorio = (EntradaBloco*)malloc((numBlocos > 0 ? numBlocos : 1) * sizeof(EntradaBloco));
+    size_t* deslocamento = (size_t*)malloc(((size_t)numBlocos + 1) * sizeof(size_t));
+    long* primeiro = (long*)malloc(((size_t)numBlocos + 1) * sizeof(long));
+    bool sucesso = diretorio != NULL && deslocamento != NULL && primeiro != NULL &&
+        fread(diretorio, sizeof(EntradaBloco), numBlocos, fp) == (size_t)numBlocos;
+    long numAntenas = 0, numEfeitos = 0;
+    size_t totalBytes = 0;
+    for (int i = 0; sucesso && i < numBlocos; i++) {
+        if (diretorio[i].tipo > BLOCO_EFEITOS || diretorio[i].numRegistos > COMPRIMIDO_BLOCO) sucesso = false;
+        deslocamento[i] = totalBytes;
+        totalBytes += diretorio[i].tamanho;
+        if (diretorio[i].tipo == BLOCO_ANTENAS) numAntenas += diretorio[i].numRegistos;
+        else numEfeitos += diretorio[i].numRegistos;
+    }
+    // antenas primeiro, efeitos depois, cada bloco na sua zona
+    long proximaAntena = 0, proximoEfeito = numAntenas;
+    for (int i = 0; sucesso && i < numBlocos; i++) {
+        if (diretorio[i].tipo == BLOCO_ANTENAS) {
+            primeiro[i] = proximaAntena;
+            proximaAntena += diretorio[i].numRegistos;
+        }
+        else {
+            primeiro[i] = proximoEfeito;
+            proximoEfeito += diretorio[i].numRegistos;
+        }
+    }
+    unsigned char* dados = sucesso ? (unsigned char*)malloc(totalBytes > 0 ? totalBytes : 1) : NULL;
+    RegistoComprimido* registos = sucesso ? (RegistoComprimido*)malloc((numAntenas + numEfeitos > 0 ? numAntenas + numEfeitos : 1) * sizeof(RegistoComprimido)) : NULL;
+    if (dados == NULL || registos == NULL || fread(dados, 1, totalBytes, fp) != totalBytes) sucesso = false;
+    fclose(fp);
+
+    if (sucesso) {
+        #pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < numBlocos; i++) {
+            const unsigned char* origem = dados + deslocamento[i];
+            if (somaBloco(origem, diretorio[i].tamanho) != diretorio[i].soma ||
+                !descodificarBloco(origem, diretorio[i].tamanho, &diretorio[i], registos + primeiro[i])) {
+                #pragma omp atomic write
+                sucesso = false;
+            }
+        }
+    }
+    free(dados);
+    free(diretorio);
+    free(deslocamento);
+    free(primeiro);
+
+    // os grupos estao ordenados por frequencia; volta-se a ordem das listas e constroi-se pelo fim
+    if (sucesso) {
+        qsort(registos, numAntenas, sizeof(RegistoComprimido), compararPosicao);
+        qsort(registos + numAntenas, numEfeitos, sizeof(RegistoComprimido), compararPosicao);
+        Antena* ultima = NULL;
+        for (long i = 0; sucesso && i < numAntenas; i++) {
+            Antena* nova = criaAntena(registos[i].linha, registos[i].coluna, registos[i].a, (char)registos[i].b);
+            if (nova == NULL) sucesso = false;
+            else if (ultima == NULL) *antenas = nova;
+            else ultima->next = nova;
+            ultima = nova;
+        }
+        Nefasto* ultimo = NULL;
+        for (long i = numAntenas; sucesso && efeitos != NULL && i < numAntenas + numEfeitos; i++) {
+            Nefasto* novo = criaEfeito(registos[i].linha, registos[i].coluna, registos[i].a, registos[i].b);
+            if (novo == NULL) {
+                sucesso = false;
+                break;
+            }
+            if (ultimo == NULL) *efeitos = novo;
+            else ultimo->next = novo;
+            ultimo = novo;
+        }
+    }
+    free(registos);
+    if (!sucesso) {
+        *antenas = DestroiListaAntenas(*antenas);
+        if (efeitos != NULL) *efeitos = DestroiListaEfeitos(*efeitos);
+    }
+    return sucesso;
+}
@@ -9,12 +9,29 @@
  *
  */
 #pragma once
+#if !defined(_WIN32)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64    // off_t de 64 bits para fseeko/ftello
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // declara fseeko/ftello com -std=c11
+#endif
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <malloc.h>
 #include <stdbool.h>    
 #include <string.h>
 
+// posicoes em ficheiros de mais de 2 GiB (long tem 32 bits no Windows)
+#ifdef _WIN32
+#define fseekGrande(fp, posicao, origem) _fseeki64((fp), (long long)(posicao), (origem))
+#define ftellGrande(fp) ((long long)_ftelli64(fp))
+#else
+#define fseekGrande(fp, posicao, origem) fseeko((fp), (off_t)(posicao), (origem))
+#define ftellGrande(fp) ((long long)ftello(fp))
+#endif
+
 typedef struct Antena {
     int linha;
     int coluna;
@@ -30,3 +47,59 @@ typedef struct Nefasto {
     int idAntena2;
     struct Nefasto* next;
 } Nefasto;
+
+typedef struct MapaCalor {
+    int linhas;                 // numero de linhas (1..linhas)
+    int colunas;                // numero de colunas (1..colunas)
+    unsigned int* contagens;    // efeitos em cada celula, indice (linha-1)*colunas + (coluna-1)
+    unsigned int maximo;        // maior contagem
+    long long total;            // efeitos contados dentro da grelha
+} MapaCalor;
+
+typedef struct MapaCelulas {
+    int linhas;                 // numero de linhas da grelha (1..linhas)
+    int colunas;                // numero de colunas da grelha (1..colunas)
+    unsigned char* bits;        // um bit por celula, indice (linha-1)*colunas + (coluna-1)
+    long marcadas;              // numero de celulas marcadas
+} MapaCelulas;
+
+typedef struct Diario {
+    char* ficheiroInstantaneo;  // ultimo instantaneo compactado
+    char* ficheiroDiario;       // alteracoes desde o instantaneo
+    FILE* fp;                   // diario aberto para acrescentar
+    unsigned int geracao;       // geracao do instantaneo a que o diario se aplica
+    long registos;              // registos no diario desde a ultima compactacao
+    long limiteRegistos;        // compacta automaticamente ao atingir (0 para so compactar a pedido)
+    Antena* antenas;            // estado atual das antenas
+    Nefasto* efeitos;           // estado atual dos efeitos
+} Diario;
+
+#define INDICE_NIVEL_MAX 16     // niveis da skip list (suficiente para 4^16 celulas com p = 1/4)
+
+typedef struct CelulaIndice {
+    int linha;
+    int coluna;
+    bool temAntena;             // a celula tem uma antena
+    Antena antena;              // copia da antena (next sempre NULL)
+    Nefasto* efeitos;           // efeitos nesta celula
+    int nivel;                  // numero de niveis do no
+    struct CelulaIndice* seguinte[]; // seguinte em cada nivel
+} CelulaIndice;
+
+typedef struct IndiceCelulas {
+    CelulaIndice* cabeca;       // sentinela com INDICE_NIVEL_MAX niveis
+    int nivel;                  // maior nivel em uso
+    long numCelulas;
+    long numAntenas;
+    long numEfeitos;
+    unsigned int semente;       // estado do gerador de niveis
+} IndiceCelulas;
+
+typedef struct CursorIndice {
+    const IndiceCelulas* indice;
+    CelulaIndice* atual;        // proxima celula candidata
+    int linha0;                 // retangulo [linha0, linha1] x [coluna0, coluna1]
+    int linha1;
+    int coluna0;
+    int coluna1;
+} CursorIndice;
@@ -0,0 +1,496 @@
+/**
+ * @file diario.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Diario de alteracoes (write-ahead) sobre um instantaneo das antenas e efeitos
+ * @details Cada insercao, remocao ou alteracao de uma antena acrescenta um registo de tamanho
+ * fixo ao diario, em vez de regravar tudo como gravarFicheiroB. O registo e escrito antes de a
+ * alteracao ser aplicada em memoria, que so muda depois de o registo estar no ficheiro. Os efeitos sao mantidos de
+ * forma incremental: so os efeitos da antena alterada sao retirados ou acrescentados.
+ * Na recuperacao le-se o instantaneo (antenas e efeitos ja calculados) e aplicam-se os registos
+ * do diario. A compactacao grava um novo instantaneo e esvazia o diario; a geracao gravada nos
+ * dois ficheiros evita aplicar duas vezes um diario que ja foi incorporado no instantaneo.
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+
+#define INSTANTANEO_MAGICO 0x31414445u  // "EDA1"
+#define DIARIO_MAGICO 0x4A414445u       // "EDAJ"
+#define DIARIO_TAMANHO_REGISTO 15       // tipo + 3 inteiros + frequencia + verificacao
+
+/**
+ * @brief Copia uma string para memoria nova
+ */
+static char* copiarTexto(const char* texto) {
+    size_t tamanho = strlen(texto) + 1;
+    char* copia = (char*)malloc(tamanho);
+    if (copia != NULL) memcpy(copia, texto, tamanho);
+    return copia;
+}
+
+#pragma region EFEITOS
+
+/**
+ * @brief Retira todos os efeitos causados por uma antena
+ *
+ * @param efeitos (inicio da lista de efeitos)
+ * @param id (id da antena)
+ * @return Nefasto* (lista atualizada)
+ */
+static Nefasto* removerEfeitosAntena(Nefasto* efeitos, int id) {
+    Nefasto* head = efeitos;
+    Nefasto* anterior = NULL;
+    Nefasto* atual = efeitos;
+    while (atual != NULL) {
+        Nefasto* seguinte = atual->next;
+        if (atual->idAntena1 == id || atual->idAntena2 == id) {
+            if (anterior == NULL) head = seguinte;
+            else anterior->next = seguinte;
+            destroiEfeito(atual);
+        }
+        else anterior = atual;
+        atual = seguinte;
+    }
+    return head;
+}
+
+/**
+ * @brief Acrescenta os efeitos entre uma antena e as restantes da mesma frequencia
+ * (os dois pontos por par de pontosEfeito, como em atualizaEfeito)
+ *
+ * @param efeitos (inicio da lista de efeitos)
+ * @param antenas (inicio da lista de antenas)
+ * @param a (antena nova ou alterada)
+ * @return Nefasto* (lista atualizada)
+ */
+static Nefasto* adicionarEfeitosAntena(Nefasto* efeitos, Antena* antenas, Antena* a) {
+    for (Antena* b = antenas; b != NULL; b = b->next) {
+        if (b == a || b->frequencia != a->frequencia) continue;
+        int linhas[2], colunas[2];
+        pontosEfeito(a->linha, a->coluna, b->linha, b->coluna, linhas, colunas);
+        efeitos = inserirEfeito(efeitos, linhas[0], colunas[0], a->id, b->id);
+        efeitos = inserirEfeito(efeitos, linhas[1], colunas[1], b->id, a->id);
+    }
+    return efeitos;
+}
+
+/**
+ * @brief Procura uma antena pela posicao
+ */
+static Antena* procurarPosicao(Antena* h, int linha, int coluna) {
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        if (aux->linha == linha && aux->coluna == coluna) return aux;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Procura uma antena pelo id (a lista esta ordenada por posicao, nao por id)
+ */
+static Antena* procurarId(Antena* h, int id) {
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        if (aux->id == id) return aux;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Retira uma antena da lista sem a libertar
+ */
+static Antena* desligarAntena(Antena* h, Antena* antena) {
+    if (h == antena) return h->next;
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        if (aux->next == antena) {
+            aux->next = antena->next;
+            break;
+        }
+    }
+    return h;
+}
+
+/**
+ * @brief Verifica se uma alteracao pode ser aplicada ao estado em memoria, sem o alterar
+ *
+ * @param d (diario)
+ * @param tipo ('I' inserir, 'R' remover, 'A' alterar)
+ * @param linha
+ * @param coluna
+ * @param id
+ * @return true
+ * @return false
+ */
+static bool validarAlteracao(Diario* d, char tipo, int linha, int coluna, int id) {
+    if (tipo == 'I') return procurarPosicao(d->antenas, linha, coluna) == NULL && procurarId(d->antenas, id) == NULL;
+    if (tipo == 'R') return procurarPosicao(d->antenas, linha, coluna) != NULL;
+    if (tipo == 'A') {
+        Antena* antena = procurarId(d->antenas, id);
+        Antena* ocupante = procurarPosicao(d->antenas, linha, coluna);
+        return antena != NULL && (ocupante == NULL || ocupante == antena);
+    }
+    return false;
+}
+
+/**
+ * @brief Aplica uma alteracao ja validada ao estado em memoria (nao falha)
+ * A antena de uma insercao e alocada antes, para que a alteracao nao possa falhar a meio
+ *
+ * @param d (diario)
+ * @param tipo ('I' inserir, 'R' remover, 'A' alterar)
+ * @param linha
+ * @param coluna
+ * @param id
+ * @param frequencia
+ * @param nova (antena ja alocada, so na insercao)
+ */
+static void executarAlteracao(Diario* d, char tipo, int linha, int coluna, int id, char frequencia, Antena* nova) {
+    if (tipo == 'I') {
+        d->antenas = inserirOrdenado(d->antenas, nova);
+        d->efeitos = adicionarEfeitosAntena(d->efeitos, d->antenas, nova);
+    }
+    else if (tipo == 'R') {
+        Antena* antena = procurarPosicao(d->antenas, linha, coluna);
+        d->efeitos = removerEfeitosAntena(d->efeitos, antena->id);
+        d->antenas = removeAntena(d->antenas, linha, coluna);
+    }
+    else if (tipo == 'A') {
+        // o mesmo no e retirado e volta a ser inserido para a lista continuar ordenada por posicao
+        Antena* antena = procurarId(d->antenas, id);
+        d->efeitos = removerEfeitosAntena(d->efeitos, id);
+        d->antenas = desligarAntena(d->antenas, antena);
+        antena->linha = linha;
+        antena->coluna = coluna;
+        antena->frequencia = frequencia;
+        antena->next = NULL;
+        d->antenas = inserirOrdenado(d->antenas, antena);
+        d->efeitos = adicionarEfeitosAntena(d->efeitos, d->antenas, antena);
+    }
+}
+
+/**
+ * @brief Valida e aplica uma alteracao ao estado em memoria (usado ao reaplicar o diario)
+ *
+ * @param d (diario)
+ * @param tipo ('I' inserir, 'R' remover, 'A' alterar)
+ * @param linha
+ * @param coluna
+ * @param id
+ * @param frequencia
+ * @return true
+ * @return false
+ */
+static bool aplicarAlteracao(Diario* d, char tipo, int linha, int coluna, int id, char frequencia) {
+    if (!validarAlteracao(d, tipo, linha, coluna, id)) return false;
+    Antena* nova = NULL;
+    if (tipo == 'I' && (nova = criaAntena(linha, coluna, id, frequencia)) == NULL) return false;
+    executarAlteracao(d, tipo, linha, coluna, id, frequencia, nova);
+    return true;
+}
+
+#pragma endregion
+
+#pragma region FICHEIROS
+
+/**
+ * @brief Grava o instantaneo: cabecalho (magico, geracao, numero de antenas e de efeitos),
+ * antenas como em gravarFicheiroB e efeitos como em gravarFicheiroB
+ * Grava primeiro num ficheiro temporario e so depois o troca pelo instantaneo
+ *
+ * @param d (diario)
+ * @param geracao (geracao do novo instantaneo)
+ * @return true
+ * @return false
+ */
+static bool gravarInstantaneo(Diario* d, unsigned int geracao) {
+    char temporario[1024];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", d->ficheiroInstantaneo);
+    FILE* fp = fopen(temporario, "wb");
+    if (fp == NULL) return false;
+    unsigned int cabecalho[4] = { INSTANTANEO_MAGICO, geracao, 0, 0 };
+    for (Antena* aux = d->antenas; aux != NULL; aux = aux->next) cabecalho[2]++;
+    for (Nefasto* aux = d->efeitos; aux != NULL; aux = aux->next) cabecalho[3]++;
+    bool sucesso = fwrite(cabecalho, sizeof(cabecalho), 1, fp) == 1;
+    for (Antena* aux = d->antenas; sucesso && aux != NULL; aux = aux->next) {
+        sucesso = fwrite(&aux->linha, sizeof(int), 1, fp) == 1 && fwrite(&aux->coluna, sizeof(int), 1, fp) == 1 &&
+            fwrite(&aux->frequencia, sizeof(char), 1, fp) == 1 && fwrite(&aux->id, sizeof(int), 1, fp) == 1;
+    }
+    for (Nefasto* aux = d->efeitos; sucesso && aux != NULL; aux = aux->next) {
+        int registo[4] = { aux->linha, aux->coluna, aux->idAntena1, aux->idAntena2 };
+        sucesso = fwrite(registo, sizeof(registo), 1, fp) == 1;
+    }
+    if (fclose(fp) != 0) sucesso = false;
+    if (!sucesso) {
+        remove(temporario);
+        return false;
+    }
+    // rename nao substitui ficheiros existentes em todas as plataformas;
+    // se falhar a meio, a leitura usa o temporario
+    remove(d->ficheiroInstantaneo);
+    return rename(temporario, d->ficheiroInstantaneo) == 0;
+}
+
+/**
+ * @brief Le o instantaneo para as listas do diario
+ * As listas sao construidas pelo fim, porque o instantaneo ja esta ordenado
+ *
+ * @param d (diario)
+ * @param nome (ficheiro a ler)
+ * @return true (tambem se o ficheiro nao existir: estado vazio, geracao 0)
+ * @return false (ficheiro invalido)
+ */
+static bool lerInstantaneo(Diario* d, const char* nome) {
+    FILE* fp = fopen(nome, "rb");
+    if (fp == NULL) return true;
+    unsigned int cabecalho[4];
+    bool sucesso = fread(cabecalho, sizeof(cabecalho), 1, fp) == 1 && cabecalho[0] == INSTANTANEO_MAGICO;
+    if (sucesso) d->geracao = cabecalho[1];
+    Antena* ultima = NULL;
+    for (unsigned int i = 0; sucesso && i < cabecalho[2]; i++) {
+        int l, c, id;
+        char f;
+        sucesso = fread(&l, sizeof(int), 1, fp) == 1 && fread(&c, sizeof(int), 1, fp) == 1 &&
+            fread(&f, sizeof(char), 1, fp) == 1 && fread(&id, sizeof(int), 1, fp) == 1;
+        Antena* nova = sucesso ? criaAntena(l, c, id, f) : NULL;
+        if (nova == NULL) {
+            sucesso = false;
+            break;
+        }
+        if (ultima == NULL) d->antenas = nova;
+        else ultima->next = nova;
+        ultima = nova;
+    }
+    Nefasto* ultimo = NULL;
+    for (unsigned int i = 0; sucesso && i < cabecalho[3]; i++) {
+        int registo[4];
+        if (fread(registo, sizeof(registo), 1, fp) != 1) {
+            sucesso = false;
+            break;
+        }
+        Nefasto* novo = criaEfeito(registo[0], registo[1], registo[2], registo[3]);
+        if (novo == NULL) {
+            sucesso = false;
+            break;
+        }
+        if (ultimo == NULL) d->efeitos = novo;
+        else ultimo->next = novo;
+        ultimo = novo;
+    }
+    fclose(fp);
+    return sucesso;
+}
+
+/**
+ * @brief Soma de verificacao de um registo do diario
+ */
+static unsigned char verificacaoRegisto(const unsigned char* registo) {
+    unsigned char soma = 0x5A;
+    for (int i = 0; i < DIARIO_TAMANHO_REGISTO - 1; i++) soma = (unsigned char)((soma << 1 | soma >> 7) ^ registo[i]);
+    return soma;
+}
+
+/**
+ * @brief Aplica os registos do diario, se pertencer a geracao do instantaneo
+ * Um registo incompleto ou corrompido no fim (escrita interrompida) termina a leitura
+ *
+ * @param d (diario)
+ */
+static void reaplicarDiario(Diario* d) {
+    FILE* fp = fopen(d->ficheiroDiario, "rb");
+    if (fp == NULL) return;
+    unsigned int cabecalho[2];
+    if (fread(cabecalho, sizeof(cabecalho), 1, fp) != 1 || cabecalho[0] != DIARIO_MAGICO || cabecalho[1] != d->geracao) {
+        fclose(fp); // diario de outra geracao: ja foi incorporado no instantaneo
+        return;
+    }
+    unsigned char registo[DIARIO_TAMANHO_REGISTO];
+    while (fread(registo, DIARIO_TAMANHO_REGISTO, 1, fp) == 1) {
+        if (verificacaoRegisto(registo) != registo[DIARIO_TAMANHO_REGISTO - 1]) break;
+        int valores[3];
+        memcpy(valores, registo + 1, sizeof(valores));
+        aplicarAlteracao(d, (char)registo[0], valores[0], valores[1], valores[2], (char)registo[13]);
+        d->registos++;
+    }
+    fclose(fp);
+}
+
+/**
+ * @brief Comeca um diario vazio para a geracao atual
+ */
+static bool reiniciarDiario(Diario* d) {
+    if (d->fp != NULL) fclose(d->fp);
+    d->fp = fopen(d->ficheiroDiario, "wb");
+    if (d->fp == NULL) return false;
+    unsigned int cabecalho[2] = { DIARIO_MAGICO, d->geracao };
+    if (fwrite(cabecalho, sizeof(cabecalho), 1, d->fp) != 1 || fflush(d->fp) != 0) return false;
+    d->registos = 0;
+    return true;
+}
+
+/**
+ * @brief Acrescenta um registo ao diario (uma unica escrita de tamanho fixo)
+ * Se a escrita falhar o ficheiro volta ao fim do ultimo registo valido, para que o proximo
+ * registo substitua o que tiver ficado escrito a meio
+ */
+static bool acrescentarRegisto(Diario* d, char tipo, int linha, int coluna, int id, char frequencia) {
+    unsigned char registo[DIARIO_TAMANHO_REGISTO];
+    int valores[3] = { linha, coluna, id };
+    registo[0] = (unsigned char)tipo;
+    memcpy(registo + 1, valores, sizeof(valores));
+    registo[13] = (unsigned char)frequencia;
+    registo[14] = verificacaoRegisto(registo);
+    if (fwrite(registo, DIARIO_TAMANHO_REGISTO, 1, d->fp) != 1 || fflush(d->fp) != 0) {
+        clearerr(d->fp);
+        fseekGrande(d->fp, 2 * (long long)sizeof(unsigned int) + (long long)d->registos * DIARIO_TAMANHO_REGISTO, SEEK_SET);
+        return false;
+    }
+    d->registos++;
+    return true;
+}
+
+/**
+ * @brief Regista uma alteracao no diario e so depois a aplica em memoria (write-ahead)
+ * Se o registo nao for escrito a memoria fica como estava. A compactacao automatica e feita
+ * depois de aplicar, para que o novo instantaneo ja inclua a alteracao; se falhar, a alteracao
+ * continua no diario e a compactacao e tentada de novo no proximo registo.
+ *
+ * @param d (diario)
+ * @param tipo ('I' inserir, 'R' remover, 'A' alterar)
+ * @param linha
+ * @param coluna
+ * @param id
+ * @param frequencia
+ * @return true
+ * @return false (alteracao invalida ou erro de escrita)
+ */
+static bool registarAlteracao(Diario* d, char tipo, int linha, int coluna, int id, char frequencia) {
+    if (d == NULL || d->fp == NULL || !validarAlteracao(d, tipo, linha, coluna, id)) return false;
+    Antena* nova = NULL;
+    if (tipo == 'I' && (nova = criaAntena(linha, coluna, id, frequencia)) == NULL) return false;
+    if (!acrescentarRegisto(d, tipo, linha, coluna, id, frequencia)) {
+        DestroiListaAntenas(nova);
+        return false;
+    }
+    executarAlteracao(d, tipo, linha, coluna, id, frequencia, nova);
+    if (d->limiteRegistos > 0 && d->registos >= d->limiteRegistos) compactarDiario(d);
+    return true;
+}
+
+#pragma endregion
+
+/**
+ * @brief Abre (ou cria) o diario e recupera o estado: le o instantaneo e aplica o diario
+ *
+ * @param ficheiroInstantaneo (nome do instantaneo)
+ * @param ficheiroDiario (nome do diario)
+ * @param limiteRegistos (compacta automaticamente ao atingir este numero de registos, 0 para nunca)
+ * @return Diario* (NULL em caso de erro)
+ */
+Diario* abrirDiario(const char* ficheiroInstantaneo, const char* ficheiroDiario, long limiteRegistos) {
+    if (ficheiroInstantaneo == NULL || ficheiroDiario == NULL) return NULL;
+    Diario* d = (Diario*)calloc(1, sizeof(Diario));
+    if (d == NULL) return NULL;
+    d->ficheiroInstantaneo = copiarTexto(ficheiroInstantaneo);
+    d->ficheiroDiario = copiarTexto(ficheiroDiario);
+    d->limiteRegistos = limiteRegistos;
+    if (d->ficheiroInstantaneo == NULL || d->ficheiroDiario == NULL) return fecharDiario(d);
+
+    // se a compactacao foi interrompida entre apagar e renomear, o temporario e o instantaneo valido
+    char temporario[1024];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", ficheiroInstantaneo);
+    FILE* existe = fopen(ficheiroInstantaneo, "rb");
+    if (existe != NULL) fclose(existe);
+    const char* origem = existe != NULL ? ficheiroInstantaneo : temporario;
+    if (!lerInstantaneo(d, origem)) return fecharDiario(d);
+    reaplicarDiario(d);
+
+    // o diario reaplicado continua valido: novos registos sao acrescentados no fim
+    if (d->registos > 0) {
+        d->fp = fopen(ficheiroDiario, "r+b");
+        if (d->fp != NULL && fseekGrande(d->fp, 2 * (long long)sizeof(unsigned int) + (long long)d->registos * DIARIO_TAMANHO_REGISTO, SEEK_SET) != 0) {
+            fclose(d->fp);
+            d->fp = NULL;
+        }
+        if (d->fp == NULL) return fecharDiario(d);
+    }
+    else if (!reiniciarDiario(d)) return fecharDiario(d);
+    return d;
+}
+
+/**
+ * @brief Insere uma antena e regista a insercao no diario
+ *
+ * @param d (diario)
+ * @param linha
+ * @param coluna
+ * @param id
+ * @param frequencia
+ * @return true
+ * @return false (posicao ou id ja usados, ou erro de escrita)
+ */
+bool diarioInserirAntena(Diario* d, int linha, int coluna, int id, char frequencia) {
+    return registarAlteracao(d, 'I', linha, coluna, id, frequencia);
+}
+
+/**
+ * @brief Remove a antena de uma posicao e regista a remocao no diario
+ *
+ * @param d (diario)
+ * @param linha
+ * @param coluna
+ * @return true
+ * @return false
+ */
+bool diarioRemoverAntena(Diario* d, int linha, int coluna) {
+    return registarAlteracao(d, 'R', linha, coluna, 0, 0);
+}
+
+/**
+ * @brief Altera a posicao e frequencia de uma antena e regista a alteracao no diario
+ *
+ * @param d (diario)
+ * @param id (id da antena)
+ * @param linha (nova linha)
+ * @param coluna (nova coluna)
+ * @param frequencia (nova frequencia)
+ * @return true
+ * @return false
+ */
+bool diarioAlterarAntena(Diario* d, int id, int linha, int coluna, char frequencia) {
+    return registarAlteracao(d, 'A', linha, coluna, id, frequencia);
+}
+
+/**
+ * @brief Incorpora o diario num novo instantaneo e esvazia o diario
+ *
+ * @param d (diario)
+ * @return true
+ * @return false
+ */
+bool compactarDiario(Diario* d) {
+    if (d == NULL) return false;
+    if (!gravarInstantaneo(d, d->geracao + 1)) return false;
+    d->geracao++;
+    return reiniciarDiario(d);
+}
+
+/**
+ * @brief Fecha o diario e liberta o estado em memoria (os ficheiros ficam como estao)
+ *
+ * @param d (diario)
+ * @return Diario* Retorna NULL
+ */
+Diario* fecharDiario(Diario* d) {
+    if (d == NULL) return NULL;
+    if (d->fp != NULL) fclose(d->fp);
+    d->antenas = DestroiListaAntenas(d->antenas);
+    d->efeitos = DestroiListaEfeitos(d->efeitos);
+    free(d->ficheiroInstantaneo);
+    free(d->ficheiroDiario);
+    free(d);
+    return NULL;
+}
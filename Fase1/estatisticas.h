@@ -0,0 +1,81 @@
+/**
+ * @file estatisticas.h
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Instrumentacao das funcoes criticas (contadores, tempos e alocacoes)
+ * @details A recolha so e compilada com EDA_ESTATISTICAS definido (ex.: /D EDA_ESTATISTICAS ou
+ * -DEDA_ESTATISTICAS). Sem essa definicao as macros ESTAT_* nao geram codigo e as funcoes de
+ * consulta devolvem estatisticas vazias.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include <stdio.h>
+#include <stdbool.h>
+
+typedef enum FuncaoEstatistica {
+    ESTAT_ATUALIZA_EFEITO,
+    ESTAT_INSERIR_EFEITO,
+    ESTAT_INSERIR_ORDENADO,
+    ESTAT_REMOVE_ANTENA,
+    ESTAT_PROCURA_ANTENA,
+    NUM_ESTAT_FUNCOES
+} FuncaoEstatistica;
+
+typedef enum EstruturaEstatistica {
+    ESTAT_ANTENA,
+    ESTAT_NEFASTO,
+    NUM_ESTAT_ESTRUTURAS
+} EstruturaEstatistica;
+
+typedef struct ContadorFuncao {
+    unsigned long long chamadas;
+    unsigned long long nanossegundos;   // tempo acumulado nas saidas normais
+    unsigned long long nosVisitados;    // nos das listas percorridos
+    unsigned long long paresVisitados;  // pares de antenas comparados
+} ContadorFuncao;
+
+typedef struct ContadorEstrutura {
+    unsigned long long alocacoes;
+    unsigned long long libertacoes;
+    unsigned long long bytesAlocados;
+    unsigned long long bytesLibertados;
+} ContadorEstrutura;
+
+typedef struct Estatisticas {
+    bool ativas;                        // false se compilado sem EDA_ESTATISTICAS
+    ContadorFuncao funcoes[NUM_ESTAT_FUNCOES];
+    ContadorEstrutura estruturas[NUM_ESTAT_ESTRUTURAS];
+} Estatisticas;
+
+unsigned long long estatisticasRelogio(void);
+void estatisticasTempo(FuncaoEstatistica funcao, unsigned long long inicio);
+void estatisticasChamada(FuncaoEstatistica funcao);
+void estatisticasVisitas(FuncaoEstatistica funcao, unsigned long long nos, unsigned long long pares);
+void estatisticasAlocacao(EstruturaEstatistica estrutura, unsigned long long bytes);
+void estatisticasLibertacao(EstruturaEstatistica estrutura, unsigned long long bytes);
+bool obterEstatisticas(Estatisticas* destino);
+bool reiniciarEstatisticas(void);
+bool gravarEstatisticasJSON(const Estatisticas* estatisticas, FILE* fp);
+
+#ifdef EDA_ESTATISTICAS
+// conta a chamada e guarda o instante de entrada numa variavel local
+#define ESTAT_INICIO(funcao) unsigned long long estatInicio = estatisticasRelogio(); estatisticasChamada(funcao)
+#define ESTAT_FIM(funcao) estatisticasTempo(funcao, estatInicio)
+#define ESTAT_VISITAS(funcao, nos, pares) estatisticasVisitas(funcao, nos, pares)
+#define ESTAT_ALOCACAO(estrutura, bytes) estatisticasAlocacao(estrutura, bytes)
+#define ESTAT_LIBERTACAO(estrutura, bytes) estatisticasLibertacao(estrutura, bytes)
+// contagem local (variavel so existe com a instrumentacao ligada)
+#define ESTAT_CONTADOR(nome) unsigned long long nome = 0
+#define ESTAT_INCREMENTA(nome) (nome)++
+#else
+#define ESTAT_INICIO(funcao) ((void)0)
+#define ESTAT_FIM(funcao) ((void)0)
+#define ESTAT_VISITAS(funcao, nos, pares) ((void)0)
+#define ESTAT_ALOCACAO(estrutura, bytes) ((void)0)
+#define ESTAT_LIBERTACAO(estrutura, bytes) ((void)0)
+#define ESTAT_CONTADOR(nome) ((void)0)
+#define ESTAT_INCREMENTA(nome) ((void)0)
+#endif
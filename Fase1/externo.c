@@ -0,0 +1,413 @@
+/**
+ * @file externo.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Calculo dos efeitos nefastos em memoria externa, para mapas maiores que a memoria
+ * @details O mapa de texto e lido uma unica vez e as antenas sao espalhadas por ficheiros
+ * temporarios, um por frequencia. Cada frequencia e depois processada sozinha: um bloco de
+ * antenas que cabe no orcamento de memoria e cruzado com o resto do ficheiro (block nested loop)
+ * e os efeitos vao para um buffer que, quando cheio, e ordenado e gravado como uma sequencia
+ * ordenada (run). No fim as runs sao fundidas com uma fusao de k vias para o ficheiro final.
+ * Os efeitos finais usam o mesmo registo que gravarFicheiroB (linha, coluna, idAntena1, idAntena2)
+ * e sao os mesmos que atualizaEfeito calcularia, ordenados por linha, coluna e ids.
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+
+#define EXTERNO_FREQUENCIAS 256 // uma run de antenas por valor de char
+#define EXTERNO_MAX_ABERTOS 64  // numero maximo de runs abertas em simultaneo na fusao
+#define EXTERNO_MIN_REGISTOS 16 // minimo de registos por buffer, mesmo com orcamentos muito pequenos
+
+/**
+ * @brief Registo de uma antena nas runs de cada frequencia
+ */
+typedef struct RegistoAntena {
+    int linha;
+    int coluna;
+    int id;
+} RegistoAntena;
+
+/**
+ * @brief Registo de um efeito nefasto (mesma disposicao que gravarFicheiroB)
+ */
+typedef struct RegistoEfeito {
+    int linha;
+    int coluna;
+    int idAntena1;
+    int idAntena2;
+} RegistoEfeito;
+
+/**
+ * @brief Estado do calculo: buffer de efeitos e runs ja gravadas
+ */
+typedef struct EstadoExterno {
+    const char* prefixo;    // prefixo dos ficheiros temporarios
+    RegistoEfeito* efeitos; // buffer de efeitos por ordenar
+    size_t numEfeitos;      // efeitos no buffer
+    size_t capacidade;      // capacidade do buffer
+    int* runs;              // numeros das runs gravadas
+    int numRuns;
+    int capacidadeRuns;
+    int proximaRun;         // numero da proxima run a criar
+    long long totalEfeitos; // total de efeitos calculados (cresce com o quadrado das antenas)
+    bool erro;
+} EstadoExterno;
+
+/**
+ * @brief Cursor de leitura de uma run durante a fusao
+ */
+typedef struct CursorRun {
+    FILE* fp;
+    RegistoEfeito* buffer;
+    size_t posicao;
+    size_t tamanho;
+} CursorRun;
+
+/**
+ * @brief Gera o nome de um ficheiro temporario
+ *
+ * @param destino (buffer para o nome)
+ * @param tamanho (tamanho do buffer)
+ * @param prefixo (prefixo dos ficheiros temporarios)
+ * @param tipo ("f" para antenas de uma frequencia, "r" para runs de efeitos)
+ * @param numero (frequencia ou numero da run)
+ */
+static void nomeTemporario(char* destino, size_t tamanho, const char* prefixo, const char* tipo, int numero) {
+    snprintf(destino, tamanho, "%s_%s%05d.bin", prefixo, tipo, numero);
+}
+
+/**
+ * @brief Compara dois efeitos por linha, coluna e ids
+ */
+static int compararEfeitos(const void* a, const void* b) {
+    const RegistoEfeito* e1 = (const RegistoEfeito*)a;
+    const RegistoEfeito* e2 = (const RegistoEfeito*)b;
+    if (e1->linha != e2->linha) return e1->linha < e2->linha ? -1 : 1;
+    if (e1->coluna != e2->coluna) return e1->coluna < e2->coluna ? -1 : 1;
+    if (e1->idAntena1 != e2->idAntena1) return e1->idAntena1 < e2->idAntena1 ? -1 : 1;
+    if (e1->idAntena2 != e2->idAntena2) return e1->idAntena2 < e2->idAntena2 ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Le o mapa uma vez e grava as antenas de cada frequencia na sua run
+ * As linhas e colunas comecam em 1, como em gravarMatrizTxt; '.' e ' ' sao posicoes vazias
+ *
+ * @param ficheiroMapa (nome do mapa de texto)
+ * @param prefixo (prefixo dos ficheiros temporarios)
+ * @param contagens (numero de antenas de cada frequencia)
+ * @return true
+ * @return false
+ */
+static bool distribuirPorFrequencia(const char* ficheiroMapa, const char* prefixo, long long* contagens) {
+    FILE* mapa = fopen(ficheiroMapa, "rb");
+    if (mapa == NULL) return false;
+    FILE* runs[EXTERNO_FREQUENCIAS] = { NULL };
+    bool sucesso = true;
+    int linha = 1, coluna = 1, id = 0;
+    int c;
+    while (sucesso && (c = getc(mapa)) != EOF) {
+        if (c == '\n') {
+            linha++;
+            coluna = 1;
+            continue;
+        }
+        if (c == '\r') continue;
+        if (c != '.' && c != ' ') {
+            unsigned char f = (unsigned char)c;
+            if (runs[f] == NULL) {
+                char nome[512];
+                nomeTemporario(nome, sizeof(nome), prefixo, "f", f);
+                runs[f] = fopen(nome, "wb");
+            }
+            RegistoAntena registo = { linha, coluna, ++id };
+            if (runs[f] == NULL || fwrite(&registo, sizeof(registo), 1, runs[f]) != 1) sucesso = false;
+            contagens[f]++;
+        }
+        coluna++;
+    }
+    fclose(mapa);
+    for (int f = 0; f < EXTERNO_FREQUENCIAS; f++) {
+        if (runs[f] != NULL && fclose(runs[f]) != 0) sucesso = false;
+    }
+    return sucesso;
+}
+
+/**
+ * @brief Ordena o buffer de efeitos e grava-o como uma nova run
+ *
+ * @param estado (estado do calculo)
+ */
+static void despejarEfeitos(EstadoExterno* estado) {
+    if (estado->numEfeitos == 0 || estado->erro) return;
+    qsort(estado->efeitos, estado->numEfeitos, sizeof(RegistoEfeito), compararEfeitos);
+    if (estado->numRuns == estado->capacidadeRuns) {
+        int novaCapacidade = estado->capacidadeRuns > 0 ? estado->capacidadeRuns * 2 : 16;
+        int* novas = (int*)realloc(estado->runs, novaCapacidade * sizeof(int));
+        if (novas == NULL) {
+            estado->erro = true;
+            return;
+        }
+        estado->runs = novas;
+        estado->capacidadeRuns = novaCapacidade;
+    }
+    char nome[512];
+    int numero = estado->proximaRun++;
+    nomeTemporario(nome, sizeof(nome), estado->prefixo, "r", numero);
+    FILE* fp = fopen(nome, "wb");
+    if (fp == NULL) {
+        estado->erro = true;
+        return;
+    }
+    if (fwrite(estado->efeitos, sizeof(RegistoEfeito), estado->numEfeitos, fp) != estado->numEfeitos) estado->erro = true;
+    if (fclose(fp) != 0) estado->erro = true;
+    estado->runs[estado->numRuns++] = numero;
+    estado->numEfeitos = 0;
+}
+
+/**
+ * @brief Acrescenta os dois efeitos de um par de antenas (a1 antes de a2 no mapa), como atualizaEfeito
+ *
+ * @param estado (estado do calculo)
+ * @param a1 (primeira antena)
+ * @param a2 (segunda antena)
+ */
+static void emitirPar(EstadoExterno* estado, const RegistoAntena* a1, const RegistoAntena* a2) {
+    if (estado->numEfeitos + 2 > estado->capacidade) despejarEfeitos(estado);
+    if (estado->erro) return; // o buffer nao foi despejado
+    RegistoEfeito* e = &estado->efeitos[estado->numEfeitos];
+    int linhas[2], colunas[2];
+    pontosEfeito(a1->linha, a1->coluna, a2->linha, a2->coluna, linhas, colunas);
+    e[0].linha = linhas[0];
+    e[0].coluna = colunas[0];
+    e[0].idAntena1 = a1->id;
+    e[0].idAntena2 = a2->id;
+    e[1].linha = linhas[1];
+    e[1].coluna = colunas[1];
+    e[1].idAntena1 = a2->id;
+    e[1].idAntena2 = a1->id;
+    estado->numEfeitos += 2;
+    estado->totalEfeitos += 2;
+}
+
+/**
+ * @brief Calcula os efeitos de uma frequencia com blocos que cabem na memoria (block nested loop)
+ *
+ * @param estado (estado do calculo)
+ * @param frequencia (frequencia a processar)
+ * @param numAntenas (numero de antenas da frequencia)
+ * @param bloco (buffer para o bloco exterior)
+ * @param leitura (buffer para as antenas lidas do resto da run)
+ * @param capacidade (capacidade de cada um dos buffers)
+ * @return true
+ * @return false
+ */
+static bool efeitosFrequencia(EstadoExterno* estado, int frequencia, long long numAntenas, RegistoAntena* bloco, RegistoAntena* leitura, size_t capacidade) {
+    char nome[512];
+    nomeTemporario(nome, sizeof(nome), estado->prefixo, "f", frequencia);
+    FILE* fp = fopen(nome, "rb");
+    if (fp == NULL) return false;
+    bool sucesso = true;
+    for (long long inicio = 0; sucesso && inicio < numAntenas; inicio += (long long)capacidade) {
+        size_t k = (unsigned long long)(numAntenas - inicio) < capacidade ? (size_t)(numAntenas - inicio) : capacidade;
+        if (fseekGrande(fp, inicio * (long long)sizeof(RegistoAntena), SEEK_SET) != 0 ||
+            fread(bloco, sizeof(RegistoAntena), k, fp) != k) {
+            sucesso = false;
+            break;
+        }
+        // pares dentro do bloco
+        for (size_t i = 0; i < k; i++) {
+            for (size_t j = i + 1; j < k; j++) emitirPar(estado, &bloco[i], &bloco[j]);
+        }
+        // pares do bloco com as antenas seguintes, lidas aos pedacos
+        size_t lidos;
+        while ((lidos = fread(leitura, sizeof(RegistoAntena), capacidade, fp)) > 0) {
+            for (size_t j = 0; j < lidos; j++) {
+                for (size_t i = 0; i < k; i++) emitirPar(estado, &bloco[i], &leitura[j]);
+            }
+        }
+        if (ferror(fp) || estado->erro) sucesso = false;
+    }
+    fclose(fp);
+    remove(nome);
+    return sucesso;
+}
+
+/**
+ * @brief Le o proximo pedaco de uma run para o buffer do cursor
+ */
+static bool recarregarCursor(CursorRun* cursor, size_t capacidade) {
+    cursor->posicao = 0;
+    cursor->tamanho = fread(cursor->buffer, sizeof(RegistoEfeito), capacidade, cursor->fp);
+    return cursor->tamanho > 0;
+}
+
+/**
+ * @brief Repoe a propriedade de monte (minimo na raiz) a partir de uma posicao
+ */
+static void descerMonte(CursorRun** monte, int tamanho, int i) {
+    for (;;) {
+        int menor = i;
+        int esq = 2 * i + 1;
+        int dir = esq + 1;
+        if (esq < tamanho && compararEfeitos(&monte[esq]->buffer[monte[esq]->posicao], &monte[menor]->buffer[monte[menor]->posicao]) < 0) menor = esq;
+        if (dir < tamanho && compararEfeitos(&monte[dir]->buffer[monte[dir]->posicao], &monte[menor]->buffer[monte[menor]->posicao]) < 0) menor = dir;
+        if (menor == i) return;
+        CursorRun* aux = monte[i];
+        monte[i] = monte[menor];
+        monte[menor] = aux;
+        i = menor;
+    }
+}
+
+/**
+ * @brief Funde varias runs ordenadas num unico ficheiro ordenado (fusao de k vias com um monte)
+ * As runs de origem sao apagadas
+ *
+ * @param prefixo (prefixo dos ficheiros temporarios)
+ * @param runs (numeros das runs a fundir)
+ * @param numRuns (numero de runs, no maximo EXTERNO_MAX_ABERTOS)
+ * @param destino (nome do ficheiro de saida)
+ * @param memoriaMaxima (orcamento de memoria em bytes)
+ * @return true
+ * @return false
+ */
+static bool fundirRuns(const char* prefixo, const int* runs, int numRuns, const char* destino, size_t memoriaMaxima) {
+    size_t capacidade = memoriaMaxima / ((size_t)numRuns + 1) / sizeof(RegistoEfeito);
+    if (capacidade < EXTERNO_MIN_REGISTOS) capacidade = EXTERNO_MIN_REGISTOS;
+    CursorRun* cursores = (CursorRun*)calloc(numRuns > 0 ? numRuns : 1, sizeof(CursorRun));
+    CursorRun** monte = (CursorRun**)malloc((numRuns > 0 ? numRuns : 1) * sizeof(CursorRun*));
+    RegistoEfeito* saida = (RegistoEfeito*)malloc(capacidade * sizeof(RegistoEfeito));
+    FILE* out = fopen(destino, "wb");
+    bool sucesso = cursores != NULL && monte != NULL && saida != NULL && out != NULL;
+    int tamanhoMonte = 0;
+    char nome[512];
+    for (int i = 0; sucesso && i < numRuns; i++) {
+        nomeTemporario(nome, sizeof(nome), prefixo, "r", runs[i]);
+        cursores[i].fp = fopen(nome, "rb");
+        cursores[i].buffer = (RegistoEfeito*)malloc(capacidade * sizeof(RegistoEfeito));
+        if (cursores[i].fp == NULL || cursores[i].buffer == NULL) sucesso = false;
+        else if (recarregarCursor(&cursores[i], capacidade)) monte[tamanhoMonte++] = &cursores[i];
+    }
+    for (int i = tamanhoMonte / 2 - 1; sucesso && i >= 0; i--) descerMonte(monte, tamanhoMonte, i);
+
+    size_t numSaida = 0;
+    while (sucesso && tamanhoMonte > 0) {
+        CursorRun* topo = monte[0];
+        saida[numSaida++] = topo->buffer[topo->posicao++];
+        if (numSaida == capacidade) {
+            if (fwrite(saida, sizeof(RegistoEfeito), numSaida, out) != numSaida) sucesso = false;
+            numSaida = 0;
+        }
+        if (topo->posicao == topo->tamanho && !recarregarCursor(topo, capacidade)) {
+            monte[0] = monte[--tamanhoMonte];
+        }
+        descerMonte(monte, tamanhoMonte, 0);
+    }
+    if (sucesso && numSaida > 0 && fwrite(saida, sizeof(RegistoEfeito), numSaida, out) != numSaida) sucesso = false;
+
+    for (int i = 0; cursores != NULL && i < numRuns; i++) {
+        if (cursores[i].fp != NULL) {
+            if (ferror(cursores[i].fp)) sucesso = false;
+            fclose(cursores[i].fp);
+        }
+        free(cursores[i].buffer);
+        nomeTemporario(nome, sizeof(nome), prefixo, "r", runs[i]);
+        remove(nome);
+    }
+    if (out != NULL && fclose(out) != 0) sucesso = false;
+    if (!sucesso && out != NULL) remove(destino);
+    free(cursores);
+    free(monte);
+    free(saida);
+    return sucesso;
+}
+
+/**
+ * @brief Calcula os efeitos nefastos de um mapa de texto sem o carregar para memoria
+ * O resultado e um ficheiro binario de registos (linha, coluna, idAntena1, idAntena2) ordenados
+ * por linha e coluna; os ids das antenas sao atribuidos pela ordem do mapa, a comecar em 1
+ *
+ * @param ficheiroMapa (nome do mapa de texto)
+ * @param ficheiroEfeitos (nome do ficheiro binario de saida)
+ * @param prefixoTemporarios (prefixo, com diretorio se necessario, dos ficheiros temporarios)
+ * @param memoriaMaxima (orcamento de memoria em bytes para os buffers)
+ * @param numEfeitos (apontador para o numero de efeitos gravados, pode ser NULL)
+ * @return true
+ * @return false
+ */
+bool calcularEfeitosExterno(const char* ficheiroMapa, const char* ficheiroEfeitos, const char* prefixoTemporarios, size_t memoriaMaxima, long long* numEfeitos) {
+    if (ficheiroMapa == NULL || ficheiroEfeitos == NULL || prefixoTemporarios == NULL) return false;
+    long long contagens[EXTERNO_FREQUENCIAS] = { 0 };
+    if (!distribuirPorFrequencia(ficheiroMapa, prefixoTemporarios, contagens)) {
+        char nome[512];
+        for (int f = 0; f < EXTERNO_FREQUENCIAS; f++) {
+            nomeTemporario(nome, sizeof(nome), prefixoTemporarios, "f", f);
+            if (contagens[f] > 0) remove(nome);
+        }
+        return false;
+    }
+
+    // metade do orcamento para o buffer de efeitos, um quarto para cada buffer de antenas
+    size_t capacidadeAntenas = memoriaMaxima / 4 / sizeof(RegistoAntena);
+    if (capacidadeAntenas < EXTERNO_MIN_REGISTOS) capacidadeAntenas = EXTERNO_MIN_REGISTOS;
+    EstadoExterno estado = { 0 };
+    estado.prefixo = prefixoTemporarios;
+    estado.capacidade = memoriaMaxima / 2 / sizeof(RegistoEfeito);
+    if (estado.capacidade < EXTERNO_MIN_REGISTOS) estado.capacidade = EXTERNO_MIN_REGISTOS;
+    estado.efeitos = (RegistoEfeito*)malloc(estado.capacidade * sizeof(RegistoEfeito));
+    RegistoAntena* bloco = (RegistoAntena*)malloc(capacidadeAntenas * sizeof(RegistoAntena));
+    RegistoAntena* leitura = (RegistoAntena*)malloc(capacidadeAntenas * sizeof(RegistoAntena));
+    if (estado.efeitos == NULL || bloco == NULL || leitura == NULL) estado.erro = true;
+
+    // uma frequencia de cada vez; as runs de antenas sao apagadas depois de usadas
+    for (int f = 0; f < EXTERNO_FREQUENCIAS; f++) {
+        if (contagens[f] == 0) continue;
+        if (estado.erro || !efeitosFrequencia(&estado, f, contagens[f], bloco, leitura, capacidadeAntenas)) {
+            estado.erro = true;
+            char nome[512];
+            nomeTemporario(nome, sizeof(nome), prefixoTemporarios, "f", f);
+            remove(nome);
+        }
+    }
+    despejarEfeitos(&estado);
+    free(bloco);
+    free(leitura);
+    free(estado.efeitos);
+
+    // fusao em varias passagens se houver mais runs do que ficheiros abertos permitidos
+    bool sucesso = !estado.erro;
+    while (sucesso && estado.numRuns > EXTERNO_MAX_ABERTOS) {
+        int numNovas = 0;
+        for (int i = 0; sucesso && i < estado.numRuns; i += EXTERNO_MAX_ABERTOS) {
+            int grupo = estado.numRuns - i < EXTERNO_MAX_ABERTOS ? estado.numRuns - i : EXTERNO_MAX_ABERTOS;
+            int numero = estado.proximaRun++;
+            char nome[512];
+            nomeTemporario(nome, sizeof(nome), prefixoTemporarios, "r", numero);
+            sucesso = fundirRuns(prefixoTemporarios, &estado.runs[i], grupo, nome, memoriaMaxima);
+            if (sucesso) estado.runs[numNovas++] = numero; // numNovas <= i, por isso nao sobrepoe runs por fundir
+            else {
+                // as runs do grupo ja foram apagadas; as seguintes ficam na lista para serem apagadas
+                for (int j = i + grupo; j < estado.numRuns; j++) estado.runs[numNovas++] = estado.runs[j];
+            }
+        }
+        estado.numRuns = numNovas;
+    }
+    if (sucesso) sucesso = fundirRuns(prefixoTemporarios, estado.runs, estado.numRuns, ficheiroEfeitos, memoriaMaxima);
+    else {
+        char nome[512];
+        for (int i = 0; i < estado.numRuns; i++) {
+            nomeTemporario(nome, sizeof(nome), prefixoTemporarios, "r", estado.runs[i]);
+            remove(nome);
+        }
+    }
+    free(estado.runs);
+    if (numEfeitos != NULL) *numEfeitos = sucesso ? estado.totalEfeitos : 0;
+    return sucesso;
+}
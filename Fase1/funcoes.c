@@ -15,6 +15,7 @@
 #define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
 #include "dados.h"
 #include "funcoes.h"
+#include "estatisticas.h"
 
 
 
@@ -26,10 +27,15 @@
   * @return Antena*
   */
 Antena* ProcuraAntena(Antena* h, int v) {
+    ESTAT_INICIO(ESTAT_PROCURA_ANTENA);
+    ESTAT_CONTADOR(nos);
     Antena* aux = h;
     while (aux && aux->id < v) {
         aux = aux->next;
+        ESTAT_INCREMENTA(nos);
     }
+    ESTAT_VISITAS(ESTAT_PROCURA_ANTENA, nos, 0);
+    ESTAT_FIM(ESTAT_PROCURA_ANTENA);
     if (aux && aux->id == v) return aux; //se encontrar vai retornar o apontador da antena
     return NULL;
 }
@@ -46,6 +52,7 @@ Antena* criaAntena(int linha, int coluna, int id, char frequencia) {
     Antena* aux;
     aux = (Antena*)malloc(sizeof(Antena));
     if (aux != NULL) {
+        ESTAT_ALOCACAO(ESTAT_ANTENA, sizeof(Antena));
         aux->id = id;
         aux->linha = linha;
         aux->coluna = coluna;
@@ -64,12 +71,15 @@ Antena* criaAntena(int linha, int coluna, int id, char frequencia) {
 Antena* inserirOrdenado(Antena* head, Antena* novo) {
     if (novo == NULL) return head;
     if (ProcuraAntena(head, novo->id)) return head;
+    ESTAT_INICIO(ESTAT_INSERIR_ORDENADO);
+    ESTAT_CONTADOR(nos);
 
     // Se a lista estiver vazia ou se o novo elemento for menor que o primeiro, insere no início
     if (head == NULL || (novo->linha < head->linha) ||
         (novo->linha == head->linha && novo->coluna < head->coluna)) {
         novo->next = head;
         head = novo;
+        ESTAT_FIM(ESTAT_INSERIR_ORDENADO);
         return head;
     }
 
@@ -79,9 +89,12 @@ Antena* inserirOrdenado(Antena* head, Antena* novo) {
         ((aux->next->linha < novo->linha) ||
             (aux->next->linha == novo->linha && aux->next->coluna < novo->coluna))) {
         aux = aux->next;
+        ESTAT_INCREMENTA(nos);
     }
     novo->next = aux->next;
     aux->next = novo;
+    ESTAT_VISITAS(ESTAT_INSERIR_ORDENADO, nos, 0);
+    ESTAT_FIM(ESTAT_INSERIR_ORDENADO);
     return head;
 }
 
@@ -95,11 +108,15 @@ Antena* inserirOrdenado(Antena* head, Antena* novo) {
  */
 Antena* removeAntena(Antena* h, int l, int c) {
     if (h == NULL) return NULL;
+    ESTAT_INICIO(ESTAT_REMOVE_ANTENA);
+    ESTAT_CONTADOR(nos);
 
     // Se for a primeira antena da lista
     if (h->linha == l && h->coluna == c) {
         Antena* aux = h->next;
         free(h);
+        ESTAT_LIBERTACAO(ESTAT_ANTENA, sizeof(Antena));
+        ESTAT_FIM(ESTAT_REMOVE_ANTENA);
         return aux; // Atualiza o inicio da lista
     }
 
@@ -109,12 +126,16 @@ Antena* removeAntena(Antena* h, int l, int c) {
     while (atual != NULL && (atual->linha != l || atual->coluna != c)) {
         anterior = atual;
         atual = atual->next;
+        ESTAT_INCREMENTA(nos);
     }
 
     if (atual != NULL) { // se encontrou
         anterior->next = atual->next;
         free(atual);
+        ESTAT_LIBERTACAO(ESTAT_ANTENA, sizeof(Antena));
     }
+    ESTAT_VISITAS(ESTAT_REMOVE_ANTENA, nos, 0);
+    ESTAT_FIM(ESTAT_REMOVE_ANTENA);
     return h;
 }
 
@@ -142,6 +163,40 @@ Antena* alteraAntena(Antena* h, int id, int l, int c, char f) {
         return h;
 }
 
+/**
+ * @brief Funcao para criar um novo efeito nefasto
+ * todas as alocacoes de Nefasto passam por aqui para serem contadas nas estatisticas
+ *
+ * @param l
+ * @param c
+ * @param id1 (id de uma das antenas que estao a causar o efeito)
+ * @param id2 (id da outra antena que estao a causar o efeito)
+ * @return Nefasto* (NULL se nao houver memoria)
+ */
+Nefasto* criaEfeito(int l, int c, int id1, int id2) {
+    Nefasto* novo = (Nefasto*)malloc(sizeof(Nefasto));
+    if (novo != NULL) {
+        ESTAT_ALOCACAO(ESTAT_NEFASTO, sizeof(Nefasto));
+        novo->linha = l;
+        novo->coluna = c;
+        novo->idAntena1 = id1;
+        novo->idAntena2 = id2;
+        novo->next = NULL;
+    }
+    return novo;
+}
+
+/**
+ * @brief Liberta um efeito nefasto criado com criaEfeito
+ *
+ * @param efeito
+ */
+void destroiEfeito(Nefasto* efeito) {
+    if (efeito == NULL) return;
+    free(efeito);
+    ESTAT_LIBERTACAO(ESTAT_NEFASTO, sizeof(Nefasto));
+}
+
 /**
  * @brief Funcao que vai inserir os efeitos nefastos apos serem calcualdos
  *
@@ -153,19 +208,16 @@ Antena* alteraAntena(Antena* h, int id, int l, int c, char f) {
  * @return Nefasto*
  */
 Nefasto* inserirEfeito(Nefasto* head, int l, int c, int id1, int id2) {
-    Nefasto* novo = (Nefasto*)malloc(sizeof(Nefasto));
+    ESTAT_INICIO(ESTAT_INSERIR_EFEITO);
+    ESTAT_CONTADOR(nos);
+    Nefasto* novo = criaEfeito(l, c, id1, id2);
     if (!novo) return head;
 
-    novo->linha = l;
-    novo->coluna = c;
-    novo->idAntena1 = id1;
-    novo->idAntena2 = id2;
-    novo->next = NULL;
-
     // Se lista for nula ou se for menor que o primeiro, insere a frente
     if (head == NULL ||
         (l < head->linha) || (l == head->linha && c < head->coluna)) {
         novo->next = head;
+        ESTAT_FIM(ESTAT_INSERIR_EFEITO);
         return novo;
     }
 
@@ -175,16 +227,38 @@ Nefasto* inserirEfeito(Nefasto* head, int l, int c, int id1, int id2) {
         (aux->next->linha < l ||
             (aux->next->linha == l && aux->next->coluna < c))) {
         aux = aux->next;
+        ESTAT_INCREMENTA(nos);
     }
 
     // Insere o novo no meio ou no final
     novo->next = aux->next;
     aux->next = novo;
+    ESTAT_VISITAS(ESTAT_INSERIR_EFEITO, nos, 0);
+    ESTAT_FIM(ESTAT_INSERIR_EFEITO);
 
     return head;
 }
 
 
+/**
+ * @brief Calcula os dois pontos de efeito nefasto de um par de antenas com a mesma frequencia
+ * O primeiro ponto (2a - b) pertence a antena a e o segundo (2b - a) a antena b.
+ * E a unica definicao da regra: todos os modulos que calculam efeitos usam esta funcao
+ *
+ * @param linhaA (linha da antena a)
+ * @param colunaA (coluna da antena a)
+ * @param linhaB (linha da antena b)
+ * @param colunaB (coluna da antena b)
+ * @param linhas (recebe as linhas dos dois pontos)
+ * @param colunas (recebe as colunas dos dois pontos)
+ */
+void pontosEfeito(int linhaA, int colunaA, int linhaB, int colunaB, int linhas[2], int colunas[2]) {
+    linhas[0] = 2 * linhaA - linhaB;
+    colunas[0] = 2 * colunaA - colunaB;
+    linhas[1] = 2 * linhaB - linhaA;
+    colunas[1] = 2 * colunaB - colunaA;
+}
+
 /**
  * @brief A função percorre a lista de antenas e calcula os efeitos entre antenas com a mesma frequencia
  * e atualiza a lista removendo efeitos se a antena for removida ou alterada
@@ -192,28 +266,33 @@ Nefasto* inserirEfeito(Nefasto* head, int l, int c, int id1, int id2) {
  * @return Nefasto*
  */
 Nefasto* atualizaEfeito(Antena* listaAntenas) {
+    ESTAT_INICIO(ESTAT_ATUALIZA_EFEITO);
+    ESTAT_CONTADOR(nos);
+    ESTAT_CONTADOR(pares);
     // lista de efeitos nova 
     Nefasto* listaEfeitos = NULL;
 
     // Percorre todas as antenas
     for (Antena* a1 = listaAntenas; a1 != NULL; a1 = a1->next) {
+        ESTAT_INCREMENTA(nos);
         for (Antena* a2 = a1->next; a2 != NULL; a2 = a2->next){
+            ESTAT_INCREMENTA(pares);
             // Se a frequencia for diferente, ignora
             if (a1->frequencia != a2->frequencia)
                 continue;
 
             // calculo dos pontos de efeito
-            int efeitoX1 = 2 * a1->linha - a2->linha;
-            int efeitoY1 = 2 * a1->coluna - a2->coluna;
-            int efeitoX2 = 2 * a2->linha - a1->linha;
-            int efeitoY2 = 2 * a2->coluna - a1->coluna;
+            int linhas[2], colunas[2];
+            pontosEfeito(a1->linha, a1->coluna, a2->linha, a2->coluna, linhas, colunas);
 
             // Insere os dois efeitos na lista
-            listaEfeitos = inserirEfeito(listaEfeitos, efeitoX1, efeitoY1, a1->id, a2->id);
-            listaEfeitos = inserirEfeito(listaEfeitos, efeitoX2, efeitoY2, a2->id, a1->id);
+            listaEfeitos = inserirEfeito(listaEfeitos, linhas[0], colunas[0], a1->id, a2->id);
+            listaEfeitos = inserirEfeito(listaEfeitos, linhas[1], colunas[1], a2->id, a1->id);
         }
     }
 
+    ESTAT_VISITAS(ESTAT_ATUALIZA_EFEITO, nos, pares);
+    ESTAT_FIM(ESTAT_ATUALIZA_EFEITO);
     return listaEfeitos;
 }
 
@@ -252,6 +331,7 @@ Antena* DestroiListaAntenas(Antena* h) {
         aux = h;
         h = h->next;
         free(aux);
+        ESTAT_LIBERTACAO(ESTAT_ANTENA, sizeof(Antena));
     }
     return NULL;
 }
@@ -267,7 +347,7 @@ Nefasto* DestroiListaEfeitos(Nefasto* h) {
     while (h != NULL) {
         aux = h;
         h = h->next;
-        free(aux);
+        destroiEfeito(aux);
     }
     return NULL;
 }   
@@ -339,33 +419,52 @@ bool gravarMatrizTxt(Antena* h, Nefasto* efeitos, const char* ficheiro) {
         if (aux->coluna > maxColuna) maxColuna = aux->coluna;
     }
 
+    // a grelha e preenchida numa passagem por cada lista; a primeira antena de cada posicao prevalece sobre os efeitos
+    size_t numCelulas = (size_t)maxLinha * (size_t)maxColuna;
+    char* grelha = (char*)malloc(numCelulas > 0 ? numCelulas : 1);
+    if (grelha == NULL) return false;
+    memset(grelha, '.', numCelulas);
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        if (aux->linha < 1 || aux->coluna < 1) continue;
+        char* celula = &grelha[(size_t)(aux->linha - 1) * maxColuna + (aux->coluna - 1)];
+        if (*celula == '.') *celula = aux->frequencia;
+    }
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next) {
+        if (aux->linha < 1 || aux->coluna < 1) continue;
+        char* celula = &grelha[(size_t)(aux->linha - 1) * maxColuna + (aux->coluna - 1)];
+        if (*celula == '.') *celula = '#';
+    }
+
     FILE* fp = fopen(ficheiro, "w");
-    if (fp == NULL) return false;
-
-    for (int i = 1; i <= maxLinha; i++) {
-        for (int j = 1; j <= maxColuna; j++) {
-            char elemento = '.';
-
-            for (Antena* aux = h; aux != NULL; aux = aux->next) {
-                if (aux->linha == i && aux->coluna == j) {
-                    elemento = aux->frequencia;
-                    break; //busca a antena para adicionar como elemento da matriz
-                }
-            }
-            if (elemento == '.') {
-                for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next) {
-                    if (aux->linha == i && aux->coluna == j) {
-                        elemento = '#'; //verifica se existe efeito nefasto na posicao
-                        break;
-                    }
-                }
-            }
-            fprintf(fp, "%c ", elemento);
-        }
-        fprintf(fp, "\n"); //adiciona nova linha
+    if (fp == NULL) {
+        free(grelha);
+        return false;
     }
-    fclose(fp);
-    return true;
+    bool sucesso = true;
+    for (int i = 0; i < maxLinha; i++) {
+        sucesso = escreverLinhaMatriz(fp, grelha + (size_t)i * maxColuna, (size_t)maxColuna) && sucesso;
+    }
+    free(grelha);
+    return fclose(fp) == 0 && sucesso;
+}
+
+/**
+ * @brief Escreve uma linha da matriz de texto: cada elemento seguido de um espaco e a mudanca de linha
+ * E o formato de gravarMatrizTxt, partilhado por todas as funcoes que gravam matrizes
+ *
+ * @param fp (ficheiro aberto para escrita)
+ * @param elementos (um caracter por coluna: frequencia da antena, '#' ou '.')
+ * @param colunas (numero de elementos)
+ * @return true
+ * @return false
+ */
+bool escreverLinhaMatriz(FILE* fp, const char* elementos, size_t colunas) {
+    for (size_t j = 0; j < colunas; j++) {
+        putc(elementos[j], fp);
+        putc(' ', fp);
+    }
+    putc('\n', fp);
+    return !ferror(fp);
 }
 
 /**
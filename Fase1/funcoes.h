@@ -18,11 +18,45 @@ Antena* criaAntena(int linha, int coluna, int id, char frequencia);
 Antena* inserirOrdenado(Antena* head, Antena* novo);
 Antena* removeAntena(Antena* h, int l, int c);
 Antena* alteraAntena(Antena* h, int id, int l, int c, char f);
+Nefasto* criaEfeito(int l, int c, int id1, int id2);
+void destroiEfeito(Nefasto* efeito);
 Nefasto* inserirEfeito(Nefasto* head, int l, int c, int id1, int id2);
+void pontosEfeito(int linhaA, int colunaA, int linhaB, int colunaB, int linhas[2], int colunas[2]);
 Nefasto* atualizaEfeito(Antena* h);
 void mostraLista(Antena* antenas, Nefasto* efeitos);
 bool gravarFicheiroB(Antena* h, const char* nomeFicheiro, Nefasto* efeitos);
 bool gravarMatrizTxt(Antena* h, Nefasto* efeitos, const char* ficheiro);
+bool escreverLinhaMatriz(FILE* fp, const char* elementos, size_t colunas);
 Antena* lerFicheirobinario(char* nomeFicheiro);
 Antena* DestroiListaAntenas(Antena* h);
 Nefasto* DestroiListaEfeitos(Nefasto* h);
+bool calcularEfeitosExterno(const char* ficheiroMapa, const char* ficheiroEfeitos, const char* prefixoTemporarios, size_t memoriaMaxima, long long* numEfeitos);
+MapaCalor* criarMapaCalor(Antena* h, Nefasto* efeitos, int frequencia);
+bool gravarMapaCalorPGM(MapaCalor* mapa, const char* ficheiro);
+bool gravarMapasCalorFrequencias(Antena* h, Nefasto* efeitos, const char* prefixo);
+MapaCalor* DestroiMapaCalor(MapaCalor* mapa);
+MapaCelulas* calcularHarmonicos(Antena* h, int linhas, int colunas);
+bool celulaMarcada(MapaCelulas* mapa, int linha, int coluna);
+Nefasto* celulasParaEfeitos(MapaCelulas* mapa);
+MapaCelulas* DestroiMapaCelulas(MapaCelulas* mapa);
+int processarLote(const char* entrada, const char* pastaSaida, FILE* resumo, int numTrabalhadores, int capacidadeFila);
+Diario* abrirDiario(const char* ficheiroInstantaneo, const char* ficheiroDiario, long limiteRegistos);
+bool diarioInserirAntena(Diario* d, int linha, int coluna, int id, char frequencia);
+bool diarioRemoverAntena(Diario* d, int linha, int coluna);
+bool diarioAlterarAntena(Diario* d, int id, int linha, int coluna, char frequencia);
+bool compactarDiario(Diario* d);
+Diario* fecharDiario(Diario* d);
+bool gravarFicheiroComprimido(Antena* h, Nefasto* efeitos, const char* nomeFicheiro);
+bool lerFicheiroComprimido(const char* nomeFicheiro, Antena** antenas, Nefasto** efeitos);
+int verificarPersistencia(const char* prefixo, unsigned int semente, int alteracoes);
+IndiceCelulas* criarIndice(void);
+IndiceCelulas* construirIndice(Antena* h, Nefasto* efeitos);
+CelulaIndice* procurarCelula(IndiceCelulas* indice, int linha, int coluna);
+bool indiceInserirAntena(IndiceCelulas* indice, int linha, int coluna, int id, char frequencia);
+bool indiceRemoverAntena(IndiceCelulas* indice, int linha, int coluna);
+bool indiceInserirEfeito(IndiceCelulas* indice, int linha, int coluna, int id1, int id2);
+bool indiceRemoverEfeito(IndiceCelulas* indice, int linha, int coluna, int id1, int id2);
+bool iniciarCursor(CursorIndice* cursor, const IndiceCelulas* indice, int linha0, int linha1, int coluna0, int coluna1);
+CelulaIndice* proximaCelula(CursorIndice* cursor);
+bool gravarMatrizJanelaTxt(IndiceCelulas* indice, int linha0, int linha1, int coluna0, int coluna1, const char* ficheiro);
+IndiceCelulas* DestroiIndice(IndiceCelulas* indice);
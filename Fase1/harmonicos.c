@@ -0,0 +1,204 @@
+/**
+ * @file harmonicos.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Efeitos harmonicos limitados a uma grelha
+ * @details Em vez dos dois pontos 2*a - b de atualizaEfeito, este modo marca todas as
+ * posicoes da grelha sobre a reta que passa por cada par de antenas da mesma frequencia.
+ * A reta e percorrida com o vetor direcao dividido pelo mdc das componentes, de modo a
+ * visitar todos os pontos inteiros, e o intervalo de passos e calculado antes para que so
+ * sejam gerados pontos dentro da grelha. Os pontos vao diretamente para um mapa de bits,
+ * o que elimina as repeticoes sem procurar em listas.
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "dados.h"
+#include "funcoes.h"
+
+/**
+ * @brief Maximo divisor comum (algoritmo de Euclides)
+ */
+static int mdc(int a, int b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b != 0) {
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * @brief Divisao inteira arredondada para baixo (a divisao de C arredonda para zero)
+ */
+static long divisaoBaixo(long a, long b) {
+    long q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+    return q;
+}
+
+/**
+ * @brief Intersecta o intervalo de passos t com os valores para os quais p + t*passo fica em [1, limite]
+ *
+ * @param p (coordenada inicial)
+ * @param passo (componente do passo)
+ * @param limite (dimensao da grelha neste eixo)
+ * @param tMin (limite inferior do intervalo, atualizado)
+ * @param tMax (limite superior do intervalo, atualizado)
+ */
+static void limitarPassos(int p, int passo, int limite, long* tMin, long* tMax) {
+    if (passo == 0) {
+        if (p < 1 || p > limite) *tMax = *tMin - 1; // reta fora da grelha
+        return;
+    }
+    long baixo, alto;
+    if (passo > 0) {
+        baixo = -divisaoBaixo(-(1L - p), passo);    // ceil((1 - p) / passo)
+        alto = divisaoBaixo((long)limite - p, passo);
+    }
+    else {
+        baixo = -divisaoBaixo(-((long)limite - p), passo);
+        alto = divisaoBaixo(1L - p, passo);
+    }
+    if (baixo > *tMin) *tMin = baixo;
+    if (alto < *tMax) *tMax = alto;
+}
+
+/**
+ * @brief Marca uma celula no mapa de bits
+ */
+static void marcarCelula(MapaCelulas* mapa, int linha, int coluna) {
+    long indice = (long)(linha - 1) * mapa->colunas + (coluna - 1);
+    unsigned char bit = (unsigned char)(1u << (indice & 7));
+    if ((mapa->bits[indice >> 3] & bit) == 0) {
+        mapa->bits[indice >> 3] |= bit;
+        mapa->marcadas++;
+    }
+}
+
+/**
+ * @brief Marca todas as posicoes da grelha na reta que passa por duas antenas
+ *
+ * @param mapa (mapa de bits)
+ * @param a1 (primeira antena)
+ * @param a2 (segunda antena)
+ */
+static void marcarReta(MapaCelulas* mapa, const Antena* a1, const Antena* a2) {
+    int dl = a2->linha - a1->linha;
+    int dc = a2->coluna - a1->coluna;
+    int g = mdc(dl, dc);
+    if (g == 0) return; // antenas na mesma posicao nao definem uma reta
+    int passoLinha = dl / g;
+    int passoColuna = dc / g;
+    long tMin = -2147483647L, tMax = 2147483647L;
+    limitarPassos(a1->linha, passoLinha, mapa->linhas, &tMin, &tMax);
+    limitarPassos(a1->coluna, passoColuna, mapa->colunas, &tMin, &tMax);
+    for (long t = tMin; t <= tMax; t++) {
+        marcarCelula(mapa, (int)(a1->linha + t * passoLinha), (int)(a1->coluna + t * passoColuna));
+    }
+}
+
+/**
+ * @brief Calcula os efeitos harmonicos de todas as antenas numa grelha de dimensoes dadas
+ * Cada par de antenas da mesma frequencia marca todas as posicoes da grelha na reta que as une
+ * (incluindo as proprias antenas); posicoes fora da grelha nunca sao geradas
+ *
+ * @param h (apontador para o inicio da lista de antenas)
+ * @param linhas (numero de linhas da grelha)
+ * @param colunas (numero de colunas da grelha)
+ * @return MapaCelulas*
+ */
+MapaCelulas* calcularHarmonicos(Antena* h, int linhas, int colunas) {
+    if (linhas <= 0 || colunas <= 0) return NULL;
+    MapaCelulas* mapa = (MapaCelulas*)malloc(sizeof(MapaCelulas));
+    if (mapa == NULL) return NULL;
+    mapa->linhas = linhas;
+    mapa->colunas = colunas;
+    mapa->marcadas = 0;
+    mapa->bits = (unsigned char*)calloc(((size_t)linhas * colunas + 7) / 8, 1);
+
+    // agrupa as antenas por frequencia para so percorrer pares da mesma frequencia
+    long contagens[256] = { 0 };
+    long numAntenas = 0;
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        contagens[(unsigned char)aux->frequencia]++;
+        numAntenas++;
+    }
+    long inicio[257];
+    inicio[0] = 0;
+    for (int f = 0; f < 256; f++) inicio[f + 1] = inicio[f] + contagens[f];
+    Antena** grupos = (Antena**)malloc((numAntenas > 0 ? numAntenas : 1) * sizeof(Antena*));
+    if (mapa->bits == NULL || grupos == NULL) {
+        free(grupos);
+        return DestroiMapaCelulas(mapa);
+    }
+    long posicao[256];
+    for (int f = 0; f < 256; f++) posicao[f] = inicio[f];
+    for (Antena* aux = h; aux != NULL; aux = aux->next) grupos[posicao[(unsigned char)aux->frequencia]++] = aux;
+
+    for (int f = 0; f < 256; f++) {
+        for (long i = inicio[f]; i < inicio[f + 1]; i++) {
+            for (long j = i + 1; j < inicio[f + 1]; j++) marcarReta(mapa, grupos[i], grupos[j]);
+        }
+    }
+    free(grupos);
+    return mapa;
+}
+
+/**
+ * @brief Verifica se uma celula esta marcada
+ *
+ * @param mapa (mapa de bits)
+ * @param linha
+ * @param coluna
+ * @return true
+ * @return false
+ */
+bool celulaMarcada(MapaCelulas* mapa, int linha, int coluna) {
+    if (mapa == NULL || linha < 1 || coluna < 1 || linha > mapa->linhas || coluna > mapa->colunas) return false;
+    long indice = (long)(linha - 1) * mapa->colunas + (coluna - 1);
+    return (mapa->bits[indice >> 3] >> (indice & 7)) & 1;
+}
+
+/**
+ * @brief Converte as celulas marcadas numa lista de efeitos, ordenada como a de inserirEfeito
+ * Os efeitos nao pertencem a um par especifico, por isso os ids ficam a -1
+ * A lista e construida pelo fim, sem procurar a posicao de cada efeito
+ *
+ * @param mapa (mapa de bits)
+ * @return Nefasto*
+ */
+Nefasto* celulasParaEfeitos(MapaCelulas* mapa) {
+    if (mapa == NULL) return NULL;
+    Nefasto* head = NULL;
+    Nefasto* ultimo = NULL;
+    for (int i = 1; i <= mapa->linhas; i++) {
+        for (int j = 1; j <= mapa->colunas; j++) {
+            if (!celulaMarcada(mapa, i, j)) continue;
+            Nefasto* novo = criaEfeito(i, j, -1, -1);
+            if (novo == NULL) return head;
+            if (ultimo == NULL) head = novo;
+            else ultimo->next = novo;
+            ultimo = novo;
+        }
+    }
+    return head;
+}
+
+/**
+ * @brief Liberta a memoria de um mapa de celulas
+ *
+ * @param mapa (mapa de bits)
+ * @return MapaCelulas* Retorna NULL
+ */
+MapaCelulas* DestroiMapaCelulas(MapaCelulas* mapa) {
+    if (mapa != NULL) {
+        free(mapa->bits);
+        free(mapa);
+    }
+    return NULL;
+}
@@ -0,0 +1,375 @@
+/**
+ * @file indice.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Indice ordenado das celulas do mapa (skip list por linha e coluna)
+ * @details Cada no da skip list e uma celula com a antena (se existir) e os efeitos que la caem.
+ * Insercao, remocao e procura custam O(log n) em media, contra o percurso O(n) de inserirOrdenado.
+ * Os cursores percorrem so as celulas de um retangulo: quando uma linha sai da janela o cursor
+ * salta diretamente para o inicio da janela na linha seguinte, sem visitar o resto do mapa.
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+
+#pragma region INDICE
+
+/**
+ * @brief Compara a posicao de uma celula com (linha, coluna)
+ * @return int (<0 se a celula estiver antes, 0 se for a mesma, >0 se estiver depois)
+ */
+static int compararCelula(const CelulaIndice* celula, int linha, int coluna) {
+    if (celula->linha != linha) return celula->linha < linha ? -1 : 1;
+    if (celula->coluna != coluna) return celula->coluna < coluna ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Sorteia o nivel de um novo no (cada nivel extra com probabilidade 1/4)
+ */
+static int sortearNivel(IndiceCelulas* indice) {
+    unsigned int x = indice->semente;
+    int nivel = 1;
+    for (;;) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        if ((x & 3) != 0 || nivel == INDICE_NIVEL_MAX) break;
+        nivel++;
+    }
+    indice->semente = x;
+    return nivel;
+}
+
+static CelulaIndice* alocarCelula(int linha, int coluna, int nivel) {
+    CelulaIndice* celula = (CelulaIndice*)malloc(sizeof(CelulaIndice) + nivel * sizeof(CelulaIndice*));
+    if (celula == NULL) return NULL;
+    celula->linha = linha;
+    celula->coluna = coluna;
+    celula->temAntena = false;
+    celula->efeitos = NULL;
+    celula->nivel = nivel;
+    for (int i = 0; i < nivel; i++) celula->seguinte[i] = NULL;
+    return celula;
+}
+
+/**
+ * @brief Procura o ultimo no antes de (linha, coluna) em cada nivel
+ *
+ * @param indice
+ * @param linha
+ * @param coluna
+ * @param anteriores (destino com INDICE_NIVEL_MAX posicoes, pode ser NULL)
+ * @return CelulaIndice* (primeira celula em (linha, coluna) ou depois, NULL se nao houver)
+ */
+static CelulaIndice* procurarAnteriores(const IndiceCelulas* indice, int linha, int coluna, CelulaIndice** anteriores) {
+    CelulaIndice* aux = indice->cabeca;
+    for (int i = indice->nivel - 1; i >= 0; i--) {
+        while (aux->seguinte[i] != NULL && compararCelula(aux->seguinte[i], linha, coluna) < 0) aux = aux->seguinte[i];
+        if (anteriores != NULL) anteriores[i] = aux;
+    }
+    return aux->seguinte[0];
+}
+
+/**
+ * @brief Devolve a celula (linha, coluna), criando-a se nao existir
+ */
+static CelulaIndice* obterCelula(IndiceCelulas* indice, int linha, int coluna) {
+    CelulaIndice* anteriores[INDICE_NIVEL_MAX];
+    CelulaIndice* celula = procurarAnteriores(indice, linha, coluna, anteriores);
+    if (celula != NULL && compararCelula(celula, linha, coluna) == 0) return celula;
+
+    int nivel = sortearNivel(indice);
+    celula = alocarCelula(linha, coluna, nivel);
+    if (celula == NULL) return NULL;
+    for (int i = indice->nivel; i < nivel; i++) anteriores[i] = indice->cabeca;
+    if (nivel > indice->nivel) indice->nivel = nivel;
+    for (int i = 0; i < nivel; i++) {
+        celula->seguinte[i] = anteriores[i]->seguinte[i];
+        anteriores[i]->seguinte[i] = celula;
+    }
+    indice->numCelulas++;
+    return celula;
+}
+
+/**
+ * @brief Retira a celula (linha, coluna) do indice se ficou sem antena e sem efeitos
+ */
+static void removerSeVazia(IndiceCelulas* indice, int linha, int coluna) {
+    CelulaIndice* anteriores[INDICE_NIVEL_MAX];
+    CelulaIndice* celula = procurarAnteriores(indice, linha, coluna, anteriores);
+    if (celula == NULL || compararCelula(celula, linha, coluna) != 0) return;
+    if (celula->temAntena || celula->efeitos != NULL) return;
+    for (int i = 0; i < celula->nivel; i++) anteriores[i]->seguinte[i] = celula->seguinte[i];
+    while (indice->nivel > 1 && indice->cabeca->seguinte[indice->nivel - 1] == NULL) indice->nivel--;
+    free(celula);
+    indice->numCelulas--;
+}
+
+/**
+ * @brief Cria um indice vazio
+ *
+ * @return IndiceCelulas*
+ */
+IndiceCelulas* criarIndice(void) {
+    IndiceCelulas* indice = (IndiceCelulas*)malloc(sizeof(IndiceCelulas));
+    if (indice == NULL) return NULL;
+    indice->cabeca = alocarCelula(0, 0, INDICE_NIVEL_MAX);
+    if (indice->cabeca == NULL) {
+        free(indice);
+        return NULL;
+    }
+    indice->nivel = 1;
+    indice->numCelulas = 0;
+    indice->numAntenas = 0;
+    indice->numEfeitos = 0;
+    indice->semente = 0x9E3779B9u;
+    return indice;
+}
+
+/**
+ * @brief Cria um indice com copias das antenas e efeitos das listas
+ *
+ * @param h (apontador para o inicio da lista de antenas)
+ * @param efeitos (apontador para o inicio da lista de efeitos)
+ * @return IndiceCelulas* (NULL em caso de erro)
+ */
+IndiceCelulas* construirIndice(Antena* h, Nefasto* efeitos) {
+    IndiceCelulas* indice = criarIndice();
+    if (indice == NULL) return NULL;
+    for (Antena* aux = h; aux != NULL; aux = aux->next) {
+        if (!indiceInserirAntena(indice, aux->linha, aux->coluna, aux->id, aux->frequencia)) return DestroiIndice(indice);
+    }
+    for (Nefasto* aux = efeitos; aux != NULL; aux = aux->next) {
+        if (!indiceInserirEfeito(indice, aux->linha, aux->coluna, aux->idAntena1, aux->idAntena2)) return DestroiIndice(indice);
+    }
+    return indice;
+}
+
+/**
+ * @brief Procura a celula (linha, coluna)
+ *
+ * @param indice
+ * @param linha
+ * @param coluna
+ * @return CelulaIndice* (NULL se a celula nao tiver antena nem efeitos)
+ */
+CelulaIndice* procurarCelula(IndiceCelulas* indice, int linha, int coluna) {
+    if (indice == NULL) return NULL;
+    CelulaIndice* celula = procurarAnteriores(indice, linha, coluna, NULL);
+    if (celula == NULL || compararCelula(celula, linha, coluna) != 0) return NULL;
+    return celula;
+}
+
+/**
+ * @brief Insere uma antena no indice
+ *
+ * @param indice
+ * @param linha
+ * @param coluna
+ * @param id
+ * @param frequencia
+ * @return true
+ * @return false (erro de memoria ou celula ja ocupada por outra antena)
+ */
+bool indiceInserirAntena(IndiceCelulas* indice, int linha, int coluna, int id, char frequencia) {
+    if (indice == NULL) return false;
+    CelulaIndice* celula = obterCelula(indice, linha, coluna);
+    if (celula == NULL || celula->temAntena) return false;
+    celula->temAntena = true;
+    celula->antena.linha = linha;
+    celula->antena.coluna = coluna;
+    celula->antena.frequencia = frequencia;
+    celula->antena.id = id;
+    celula->antena.next = NULL;
+    indice->numAntenas++;
+    return true;
+}
+
+/**
+ * @brief Remove a antena da celula (linha, coluna)
+ *
+ * @param indice
+ * @param linha
+ * @param coluna
+ * @return true
+ * @return false (nao existe antena na celula)
+ */
+bool indiceRemoverAntena(IndiceCelulas* indice, int linha, int coluna) {
+    CelulaIndice* celula = procurarCelula(indice, linha, coluna);
+    if (celula == NULL || !celula->temAntena) return false;
+    celula->temAntena = false;
+    indice->numAntenas--;
+    removerSeVazia(indice, linha, coluna);
+    return true;
+}
+
+/**
+ * @brief Insere um efeito nefasto no indice
+ *
+ * @param indice
+ * @param linha
+ * @param coluna
+ * @param id1 (antena que causa o efeito)
+ * @param id2 (antena do outro lado do par)
+ * @return true
+ * @return false
+ */
+bool indiceInserirEfeito(IndiceCelulas* indice, int linha, int coluna, int id1, int id2) {
+    if (indice == NULL) return false;
+    CelulaIndice* celula = obterCelula(indice, linha, coluna);
+    if (celula == NULL) return false;
+    Nefasto* novo = criaEfeito(linha, coluna, id1, id2);
+    if (novo == NULL) {
+        removerSeVazia(indice, linha, coluna);
+        return false;
+    }
+    novo->next = celula->efeitos;
+    celula->efeitos = novo;
+    indice->numEfeitos++;
+    return true;
+}
+
+/**
+ * @brief Remove um efeito nefasto (linha, coluna, id1, id2) do indice
+ *
+ * @param indice
+ * @param linha
+ * @param coluna
+ * @param id1
+ * @param id2
+ * @return true
+ * @return false (efeito nao encontrado)
+ */
+bool indiceRemoverEfeito(IndiceCelulas* indice, int linha, int coluna, int id1, int id2) {
+    CelulaIndice* celula = procurarCelula(indice, linha, coluna);
+    if (celula == NULL) return false;
+    Nefasto** ligacao = &celula->efeitos;
+    while (*ligacao != NULL && ((*ligacao)->idAntena1 != id1 || (*ligacao)->idAntena2 != id2)) ligacao = &(*ligacao)->next;
+    if (*ligacao == NULL) return false;
+    Nefasto* removido = *ligacao;
+    *ligacao = removido->next;
+    destroiEfeito(removido);
+    indice->numEfeitos--;
+    removerSeVazia(indice, linha, coluna);
+    return true;
+}
+
+/**
+ * @brief Liberta o indice e todas as celulas
+ *
+ * @param indice
+ * @return IndiceCelulas* (sempre NULL)
+ */
+IndiceCelulas* DestroiIndice(IndiceCelulas* indice) {
+    if (indice == NULL) return NULL;
+    CelulaIndice* aux = indice->cabeca->seguinte[0];
+    while (aux != NULL) {
+        CelulaIndice* seguinte = aux->seguinte[0];
+        DestroiListaEfeitos(aux->efeitos);
+        free(aux);
+        aux = seguinte;
+    }
+    free(indice->cabeca);
+    free(indice);
+    return NULL;
+}
+#pragma endregion
+
+#pragma region CURSORES
+
+/**
+ * @brief Prepara um cursor para as celulas do retangulo [linha0, linha1] x [coluna0, coluna1]
+ *
+ * @param cursor
+ * @param indice
+ * @param linha0
+ * @param linha1
+ * @param coluna0
+ * @param coluna1
+ * @return true
+ * @return false (retangulo vazio)
+ */
+bool iniciarCursor(CursorIndice* cursor, const IndiceCelulas* indice, int linha0, int linha1, int coluna0, int coluna1) {
+    if (cursor == NULL || indice == NULL || linha0 > linha1 || coluna0 > coluna1) return false;
+    cursor->indice = indice;
+    cursor->linha0 = linha0;
+    cursor->linha1 = linha1;
+    cursor->coluna0 = coluna0;
+    cursor->coluna1 = coluna1;
+    cursor->atual = procurarAnteriores(indice, linha0, coluna0, NULL);
+    return true;
+}
+
+/**
+ * @brief Devolve a proxima celula do retangulo, por ordem de linha e coluna
+ * Celulas fora das colunas da janela nao sao percorridas: o cursor salta com uma procura O(log n)
+ *
+ * @param cursor
+ * @return CelulaIndice* (NULL quando o retangulo terminou)
+ */
+CelulaIndice* proximaCelula(CursorIndice* cursor) {
+    if (cursor == NULL) return NULL;
+    while (cursor->atual != NULL && cursor->atual->linha <= cursor->linha1) {
+        CelulaIndice* celula = cursor->atual;
+        if (celula->coluna < cursor->coluna0) {
+            cursor->atual = procurarAnteriores(cursor->indice, celula->linha, cursor->coluna0, NULL);
+        }
+        else if (celula->coluna > cursor->coluna1) {
+            if (celula->linha == cursor->linha1) break;
+            cursor->atual = procurarAnteriores(cursor->indice, celula->linha + 1, cursor->coluna0, NULL);
+        }
+        else {
+            cursor->atual = celula->seguinte[0];
+            return celula;
+        }
+    }
+    cursor->atual = NULL;
+    return NULL;
+}
+
+/**
+ * @brief Grava em texto so a janela [linha0, linha1] x [coluna0, coluna1] do mapa
+ * Usa a mesma representacao de gravarMatrizTxt: frequencia da antena, "#" para efeitos e "." vazio
+ *
+ * @param indice
+ * @param linha0
+ * @param linha1
+ * @param coluna0
+ * @param coluna1
+ * @param ficheiro (o nome do ficheiro passado como argumento)
+ * @return true
+ * @return false
+ */
+bool gravarMatrizJanelaTxt(IndiceCelulas* indice, int linha0, int linha1, int coluna0, int coluna1, const char* ficheiro) {
+    CursorIndice cursor;
+    if (!iniciarCursor(&cursor, indice, linha0, linha1, coluna0, coluna1)) return false;
+    size_t largura = (size_t)coluna1 - (size_t)coluna0 + 1;
+    char* linhaTexto = (char*)malloc(largura);
+    if (linhaTexto == NULL) return false;
+    FILE* fp = fopen(ficheiro, "w");
+    if (fp == NULL) {
+        free(linhaTexto);
+        return false;
+    }
+
+    bool sucesso = true;
+    CelulaIndice* celula = proximaCelula(&cursor);
+    for (long i = linha0; i <= linha1; i++) {
+        memset(linhaTexto, '.', largura);
+        // o cursor devolve as celulas por ordem, por isso so se consomem as desta linha
+        for (; celula != NULL && celula->linha == i; celula = proximaCelula(&cursor)) {
+            size_t j = (size_t)((long)celula->coluna - coluna0);
+            linhaTexto[j] = celula->temAntena ? celula->antena.frequencia : '#';
+        }
+        sucesso = escreverLinhaMatriz(fp, linhaTexto, largura) && sucesso;
+    }
+    free(linhaTexto);
+    return fclose(fp) == 0 && sucesso;
+}
+#pragma endregion
@@ -0,0 +1,492 @@
+/**
+ * @file lote.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Processamento em lote de muitos mapas com um conjunto fixo de threads
+ * @details A thread principal le a lista de mapas (diretorio ou ficheiro manifesto) e coloca
+ * cada caminho numa fila limitada; quando a fila esta cheia fica bloqueada ate haver espaco,
+ * o que limita a memoria usada. Cada trabalhador retira um mapa, le-o, calcula os efeitos
+ * (pontosEfeito, a regra de atualizaEfeito), conta as celulas afetadas e, se pedido, grava a
+ * matriz de texto. Toda a memoria de um mapa vem da arena do trabalhador, que e limpa e
+ * reutilizada no mapa seguinte. Cada mapa produz uma linha de resumo.
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+#include <threads.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+#define LOTE_TAMANHO_BLOCO (1u << 20) // tamanho minimo de cada bloco da arena
+
+/**
+ * @brief Bloco de memoria de uma arena
+ */
+typedef struct BlocoArena {
+    struct BlocoArena* anterior;
+    size_t capacidade;
+    size_t usado;
+    unsigned char* dados;
+} BlocoArena;
+
+/**
+ * @brief Arena de um trabalhador: reservas sem libertacao individual, limpa entre mapas
+ */
+typedef struct Arena {
+    BlocoArena* atual;
+    size_t total;           // capacidade somada de todos os blocos
+} Arena;
+
+/**
+ * @brief Fila limitada de caminhos de mapas
+ */
+typedef struct FilaLote {
+    char** caminhos;
+    int capacidade;
+    int inicio;
+    int tamanho;
+    bool fechada;           // nao vao chegar mais mapas
+    mtx_t trinco;
+    cnd_t naoVazia;
+    cnd_t naoCheia;
+} FilaLote;
+
+/**
+ * @brief Estado partilhado pelos trabalhadores
+ */
+typedef struct Lote {
+    FilaLote fila;
+    const char* pastaSaida; // onde gravar as matrizes (NULL para nao gravar)
+    FILE* resumo;           // destino das linhas de resumo
+    mtx_t trincoResumo;
+    int sucessos;
+    int falhas;
+} Lote;
+
+/**
+ * @brief Antena lida de um mapa
+ */
+typedef struct AntenaLote {
+    int linha;
+    int coluna;
+    char frequencia;
+} AntenaLote;
+
+/**
+ * @brief Resultado do processamento de um mapa
+ */
+typedef struct ResultadoLote {
+    long long antenas;
+    long long efeitos;
+    long long celulas;
+    double msCarregar;
+    double msEfeitos;
+    double msGravar;
+} ResultadoLote;
+
+#pragma region ARENA
+
+/**
+ * @brief Reserva memoria da arena (alinhada a 16 bytes)
+ *
+ * @param arena
+ * @param bytes
+ * @return void* (NULL se nao houver memoria)
+ */
+static void* reservarArena(Arena* arena, size_t bytes) {
+    bytes = (bytes + 15) & ~(size_t)15;
+    BlocoArena* bloco = arena->atual;
+    if (bloco == NULL || bloco->capacidade - bloco->usado < bytes) {
+        size_t capacidade = bytes > LOTE_TAMANHO_BLOCO ? bytes : LOTE_TAMANHO_BLOCO;
+        BlocoArena* novo = (BlocoArena*)malloc(sizeof(BlocoArena));
+        if (novo == NULL) return NULL;
+        novo->dados = (unsigned char*)malloc(capacidade);
+        if (novo->dados == NULL) {
+            free(novo);
+            return NULL;
+        }
+        novo->capacidade = capacidade;
+        novo->usado = 0;
+        novo->anterior = bloco;
+        arena->atual = novo;
+        arena->total += capacidade;
+        bloco = novo;
+    }
+    void* memoria = bloco->dados + bloco->usado;
+    bloco->usado += bytes;
+    return memoria;
+}
+
+/**
+ * @brief Liberta todos os blocos da arena
+ */
+static void destruirArena(Arena* arena) {
+    while (arena->atual != NULL) {
+        BlocoArena* anterior = arena->atual->anterior;
+        free(arena->atual->dados);
+        free(arena->atual);
+        arena->atual = anterior;
+    }
+    arena->total = 0;
+}
+
+/**
+ * @brief Limpa a arena para o proximo mapa
+ * Se o mapa precisou de varios blocos, sao trocados por um unico com a capacidade total,
+ * para que mapas do mesmo tamanho caibam num so bloco
+ */
+static void limparArena(Arena* arena) {
+    if (arena->atual == NULL) return;
+    if (arena->atual->anterior != NULL) {
+        size_t total = arena->total;
+        destruirArena(arena);
+        if (reservarArena(arena, total) != NULL) arena->atual->usado = 0;
+        return;
+    }
+    arena->atual->usado = 0;
+}
+
+#pragma endregion
+
+#pragma region FILA
+
+static bool iniciarFila(FilaLote* fila, int capacidade) {
+    fila->caminhos = (char**)malloc(capacidade * sizeof(char*));
+    fila->capacidade = capacidade;
+    fila->inicio = 0;
+    fila->tamanho = 0;
+    fila->fechada = false;
+    if (fila->caminhos == NULL) return false;
+    if (mtx_init(&fila->trinco, mtx_plain) != thrd_success) {
+        free(fila->caminhos);
+        return false;
+    }
+    cnd_init(&fila->naoVazia);
+    cnd_init(&fila->naoCheia);
+    return true;
+}
+
+static void destruirFila(FilaLote* fila) {
+    for (int i = 0; i < fila->tamanho; i++) free(fila->caminhos[(fila->inicio + i) % fila->capacidade]);
+    free(fila->caminhos);
+    mtx_destroy(&fila->trinco);
+    cnd_destroy(&fila->naoVazia);
+    cnd_destroy(&fila->naoCheia);
+}
+
+/**
+ * @brief Coloca um caminho na fila, esperando enquanto estiver cheia
+ */
+static bool colocarFila(FilaLote* fila, const char* caminho) {
+    size_t tamanho = strlen(caminho) + 1;
+    char* copia = (char*)malloc(tamanho);
+    if (copia == NULL) return false;
+    memcpy(copia, caminho, tamanho);
+    mtx_lock(&fila->trinco);
+    while (fila->tamanho == fila->capacidade) cnd_wait(&fila->naoCheia, &fila->trinco);
+    fila->caminhos[(fila->inicio + fila->tamanho) % fila->capacidade] = copia;
+    fila->tamanho++;
+    cnd_signal(&fila->naoVazia);
+    mtx_unlock(&fila->trinco);
+    return true;
+}
+
+/**
+ * @brief Retira um caminho da fila, esperando enquanto estiver vazia
+ * @return char* (NULL quando a fila esta fechada e vazia)
+ */
+static char* retirarFila(FilaLote* fila) {
+    mtx_lock(&fila->trinco);
+    while (fila->tamanho == 0 && !fila->fechada) cnd_wait(&fila->naoVazia, &fila->trinco);
+    char* caminho = NULL;
+    if (fila->tamanho > 0) {
+        caminho = fila->caminhos[fila->inicio];
+        fila->inicio = (fila->inicio + 1) % fila->capacidade;
+        fila->tamanho--;
+        cnd_signal(&fila->naoCheia);
+    }
+    mtx_unlock(&fila->trinco);
+    return caminho;
+}
+
+static void fecharFila(FilaLote* fila) {
+    mtx_lock(&fila->trinco);
+    fila->fechada = true;
+    cnd_broadcast(&fila->naoVazia);
+    mtx_unlock(&fila->trinco);
+}
+
+#pragma endregion
+
+/**
+ * @brief Tempo atual em milissegundos
+ */
+static double agoraMs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1.0e6;
+}
+
+/**
+ * @brief Grava a matriz de um mapa como gravarMatrizTxt (antenas, '#' nos efeitos, '.' no resto)
+ */
+static bool gravarMatrizLote(const char* ficheiro, const char* texto, const long long* inicioLinha, int linhas, int colunas, const unsigned char* marcadas, char* linhaTexto) {
+    FILE* fp = fopen(ficheiro, "w");
+    if (fp == NULL) return false;
+    bool sucesso = true;
+    for (int i = 1; i <= linhas; i++) {
+        long long tamanhoLinha = inicioLinha[i] - inicioLinha[i - 1];
+        for (int j = 1; j <= colunas; j++) {
+            char c = j <= tamanhoLinha ? texto[inicioLinha[i - 1] + j - 1] : '.';
+            if (c == '.' || c == ' ' || c == '\r' || c == '\n') {
+                long long indice = (long long)(i - 1) * colunas + (j - 1);
+                c = ((marcadas[indice >> 3] >> (indice & 7)) & 1) ? '#' : '.';
+            }
+            linhaTexto[j - 1] = c;
+        }
+        sucesso = escreverLinhaMatriz(fp, linhaTexto, (size_t)colunas) && sucesso;
+    }
+    return fclose(fp) == 0 && sucesso;
+}
+
+/**
+ * @brief Processa um mapa: leitura, efeitos e gravacao opcional da matriz
+ *
+ * @param caminho (mapa de texto: uma linha por linha do mapa, '.' ou ' ' nas posicoes vazias)
+ * @param pastaSaida (pasta para a matriz ou NULL)
+ * @param arena (arena do trabalhador)
+ * @param resultado (contagens e tempos)
+ * @return true
+ * @return false
+ */
+static bool processarMapa(const char* caminho, const char* pastaSaida, Arena* arena, ResultadoLote* resultado) {
+    double t0 = agoraMs();
+    FILE* fp = fopen(caminho, "rb");
+    if (fp == NULL) return false;
+    long long tamanho = -1;
+    if (fseekGrande(fp, 0, SEEK_END) == 0) tamanho = ftellGrande(fp);
+    if (tamanho < 0 || (unsigned long long)tamanho >= SIZE_MAX || fseekGrande(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return false;
+    }
+    char* texto = (char*)reservarArena(arena, (size_t)tamanho + 1);
+    if (texto == NULL || fread(texto, 1, (size_t)tamanho, fp) != (size_t)tamanho) {
+        fclose(fp);
+        return false;
+    }
+    fclose(fp);
+    texto[tamanho] = '\n';
+
+    // linhas e antenas; as coordenadas comecam em 1 como em gravarMatrizTxt
+    int linhas = 0;
+    for (long long i = 0; i < tamanho; i++) linhas += texto[i] == '\n';
+    if (tamanho > 0 && texto[tamanho - 1] != '\n') linhas++;
+    long long* inicioLinha = (long long*)reservarArena(arena, ((size_t)linhas + 1) * sizeof(long long));
+    AntenaLote* antenas = (AntenaLote*)reservarArena(arena, ((size_t)tamanho + 1) * sizeof(AntenaLote));
+    if (inicioLinha == NULL || antenas == NULL) return false;
+    long long numAntenas = 0;
+    int colunas = 0;
+    int linha = 1, coluna = 1;
+    inicioLinha[0] = 0;
+    for (long long i = 0; i < tamanho; i++) {
+        char c = texto[i];
+        if (c == '\n') {
+            inicioLinha[linha++] = i + 1;
+            coluna = 1;
+            continue;
+        }
+        if (c != '.' && c != ' ' && c != '\r') {
+            AntenaLote a = { linha, coluna, c };
+            antenas[numAntenas++] = a;
+        }
+        if (c != '\r' && coluna > colunas) colunas = coluna;
+        coluna++;
+    }
+    if (linha <= linhas) inicioLinha[linha] = tamanho;
+    double t1 = agoraMs();
+
+    // efeitos: pares da mesma frequencia (agrupados por contagem), dois pontos por par
+    long long inicio[257] = { 0 };
+    for (long long i = 0; i < numAntenas; i++) inicio[(unsigned char)antenas[i].frequencia + 1]++;
+    for (int f = 0; f < 256; f++) inicio[f + 1] += inicio[f];
+    AntenaLote* grupos = (AntenaLote*)reservarArena(arena, ((size_t)numAntenas + 1) * sizeof(AntenaLote));
+    size_t bytesMarcadas = ((size_t)linhas * colunas + 7) / 8;
+    unsigned char* marcadas = (unsigned char*)reservarArena(arena, bytesMarcadas + 1);
+    if (grupos == NULL || marcadas == NULL) return false;
+    memset(marcadas, 0, bytesMarcadas + 1);
+    long long posicao[256];
+    for (int f = 0; f < 256; f++) posicao[f] = inicio[f];
+    for (long long i = 0; i < numAntenas; i++) grupos[posicao[(unsigned char)antenas[i].frequencia]++] = antenas[i];
+
+    long long efeitos = 0, celulas = 0;
+    for (int f = 0; f < 256; f++) {
+        for (long long i = inicio[f]; i < inicio[f + 1]; i++) {
+            for (long long j = i + 1; j < inicio[f + 1]; j++) {
+                int pontosLinha[2], pontosColuna[2];
+                pontosEfeito(grupos[i].linha, grupos[i].coluna, grupos[j].linha, grupos[j].coluna, pontosLinha, pontosColuna);
+                efeitos += 2;
+                for (int k = 0; k < 2; k++) {
+                    int l = pontosLinha[k], c = pontosColuna[k];
+                    if (l < 1 || c < 1 || l > linhas || c > colunas) continue;
+                    long long indice = (long long)(l - 1) * colunas + (c - 1);
+                    unsigned char bit = (unsigned char)(1u << (indice & 7));
+                    if ((marcadas[indice >> 3] & bit) == 0) {
+                        marcadas[indice >> 3] |= bit;
+                        celulas++;
+                    }
+                }
+            }
+        }
+    }
+    double t2 = agoraMs();
+
+    bool sucesso = true;
+    if (pastaSaida != NULL) {
+        const char* base = caminho;
+        for (const char* p = caminho; *p != '\0'; p++) {
+            if (*p == '/' || *p == '\\') base = p + 1;
+        }
+        char nome[1024];
+        snprintf(nome, sizeof(nome), "%s/%s.matriz.txt", pastaSaida, base);
+        char* linhaTexto = (char*)reservarArena(arena, (size_t)colunas + 1);
+        sucesso = linhaTexto != NULL && gravarMatrizLote(nome, texto, inicioLinha, linhas, colunas, marcadas, linhaTexto);
+    }
+    double t3 = agoraMs();
+
+    resultado->antenas = numAntenas;
+    resultado->efeitos = efeitos;
+    resultado->celulas = celulas;
+    resultado->msCarregar = t1 - t0;
+    resultado->msEfeitos = t2 - t1;
+    resultado->msGravar = t3 - t2;
+    return sucesso;
+}
+
+/**
+ * @brief Ciclo de um trabalhador: retira mapas da fila ate ela fechar
+ */
+static int trabalhador(void* argumento) {
+    Lote* lote = (Lote*)argumento;
+    Arena arena = { NULL, 0 };
+    char* caminho;
+    while ((caminho = retirarFila(&lote->fila)) != NULL) {
+        ResultadoLote r = { 0 };
+        bool sucesso = processarMapa(caminho, lote->pastaSaida, &arena, &r);
+        mtx_lock(&lote->trincoResumo);
+        if (sucesso) {
+            fprintf(lote->resumo, "%s antenas=%lld efeitos=%lld celulas=%lld carregar_ms=%.3f efeitos_ms=%.3f gravar_ms=%.3f\n",
+                caminho, r.antenas, r.efeitos, r.celulas, r.msCarregar, r.msEfeitos, r.msGravar);
+            lote->sucessos++;
+        }
+        else {
+            fprintf(lote->resumo, "%s erro\n", caminho);
+            lote->falhas++;
+        }
+        mtx_unlock(&lote->trincoResumo);
+        free(caminho);
+        limparArena(&arena);
+    }
+    destruirArena(&arena);
+    return 0;
+}
+
+/**
+ * @brief Coloca na fila todos os ficheiros de um diretorio
+ * @return int (numero de ficheiros, -1 se nao for um diretorio)
+ */
+static int listarDiretorio(const char* pasta, FilaLote* fila) {
+    char caminho[1024];
+    int total = 0;
+#ifdef _WIN32
+    struct _finddata_t dados;
+    snprintf(caminho, sizeof(caminho), "%s\\*", pasta);
+    intptr_t procura = _findfirst(caminho, &dados);
+    if (procura == -1) return -1;
+    do {
+        if ((dados.attrib & _A_SUBDIR) != 0 || dados.name[0] == '.') continue;
+        snprintf(caminho, sizeof(caminho), "%s\\%s", pasta, dados.name);
+        if (colocarFila(fila, caminho)) total++;
+    } while (_findnext(procura, &dados) == 0);
+    _findclose(procura);
+#else
+    DIR* dir = opendir(pasta);
+    if (dir == NULL) return -1;
+    struct dirent* entrada;
+    while ((entrada = readdir(dir)) != NULL) {
+        if (entrada->d_name[0] == '.') continue;
+        snprintf(caminho, sizeof(caminho), "%s/%s", pasta, entrada->d_name);
+        if (colocarFila(fila, caminho)) total++;
+    }
+    closedir(dir);
+#endif
+    return total;
+}
+
+/**
+ * @brief Coloca na fila os mapas de um manifesto (um caminho por linha; '#' inicia comentario)
+ * @return int (numero de mapas, -1 se o manifesto nao abrir)
+ */
+static int lerManifesto(const char* manifesto, FilaLote* fila) {
+    FILE* fp = fopen(manifesto, "r");
+    if (fp == NULL) return -1;
+    char linha[1024];
+    int total = 0;
+    while (fgets(linha, sizeof(linha), fp) != NULL) {
+        linha[strcspn(linha, "\r\n")] = '\0';
+        if (linha[0] == '\0' || linha[0] == '#') continue;
+        if (colocarFila(fila, linha)) total++;
+    }
+    fclose(fp);
+    return total;
+}
+
+/**
+ * @brief Processa em lote todos os mapas de um diretorio ou de um manifesto
+ * Escreve uma linha de resumo por mapa (antenas, efeitos, celulas afetadas dentro do mapa e tempos)
+ *
+ * @param entrada (diretorio com mapas ou ficheiro manifesto)
+ * @param pastaSaida (pasta onde gravar a matriz de cada mapa, NULL para nao gravar)
+ * @param resumo (destino das linhas de resumo, NULL para stdout)
+ * @param numTrabalhadores (numero de threads)
+ * @param capacidadeFila (mapas em espera no maximo)
+ * @return int (numero de mapas processados com sucesso, -1 em caso de erro)
+ */
+int processarLote(const char* entrada, const char* pastaSaida, FILE* resumo, int numTrabalhadores, int capacidadeFila) {
+    if (entrada == NULL || numTrabalhadores <= 0 || capacidadeFila <= 0) return -1;
+    Lote lote;
+    lote.pastaSaida = pastaSaida;
+    lote.resumo = resumo != NULL ? resumo : stdout;
+    lote.sucessos = 0;
+    lote.falhas = 0;
+    if (!iniciarFila(&lote.fila, capacidadeFila)) return -1;
+    if (mtx_init(&lote.trincoResumo, mtx_plain) != thrd_success) {
+        destruirFila(&lote.fila);
+        return -1;
+    }
+    thrd_t* threads = (thrd_t*)malloc(numTrabalhadores * sizeof(thrd_t));
+    int iniciadas = 0;
+    while (threads != NULL && iniciadas < numTrabalhadores &&
+        thrd_create(&threads[iniciadas], trabalhador, &lote) == thrd_success) iniciadas++;
+
+    int total = -1;
+    if (iniciadas > 0) {
+        total = listarDiretorio(entrada, &lote.fila);
+        if (total < 0) total = lerManifesto(entrada, &lote.fila);
+    }
+    fecharFila(&lote.fila);
+    for (int i = 0; i < iniciadas; i++) thrd_join(threads[i], NULL);
+    free(threads);
+    mtx_destroy(&lote.trincoResumo);
+    destruirFila(&lote.fila);
+    return total < 0 ? -1 : lote.sucessos;
+}
@@ -1,11 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "dados.h"
 #include "funcoes.h"
 
 #define FICHEIRO_MATRIZ "matriz.txt"
 
-int main() {
+int main(int argc, char* argv[]) {
+    // modo verificacao: teste --verificar [semente] [alteracoes]
+    if (argc > 1 && strcmp(argv[1], "--verificar") == 0) {
+        unsigned int semente = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+        int alteracoes = argc > 3 ? atoi(argv[3]) : 2000;
+        int erros = verificarPersistencia("verificacao", semente, alteracoes);
+        printf("verificacao: semente=%u alteracoes=%d erros=%d\n", semente, alteracoes, erros);
+        return erros == 0 ? 0 : 1;
+    }
+
+    // modo lote: teste <diretorio|manifesto> [pasta de saida] [threads]
+    if (argc > 1) {
+        int threads = argc > 3 ? atoi(argv[3]) : 4;
+        int processados = processarLote(argv[1], argc > 2 ? argv[2] : NULL, stdout, threads, threads * 4);
+        return processados < 0 ? 1 : 0;
+    }
+
     Antena* listaAntenas = NULL;
     Nefasto* listaEfeitos = NULL;
 
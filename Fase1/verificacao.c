@@ -0,0 +1,302 @@
+/**
+ * @file verificacao.c
+ * @author Matheus Delgado (a31542 IPCA)
+ * @brief Verificacao aleatoria da persistencia: diario de alteracoes e instantaneo comprimido
+ * @details Aplica uma sequencia pseudo-aleatoria de insercoes, remocoes e alteracoes (validas e
+ * invalidas) ao diario e a um modelo simples em memoria. Periodicamente verifica que:
+ * - o diario aceita e recusa as mesmas alteracoes que o modelo e fica com as mesmas antenas;
+ * - os efeitos mantidos de forma incremental sao os mesmos de atualizaEfeito;
+ * - fechar e reabrir (reaplicar o diario), com ou sem um registo incompleto no fim, e compactar
+ *   dao o mesmo estado;
+ * - gravarFicheiroComprimido seguido de lerFicheiroComprimido devolve as mesmas listas.
+ * Os efeitos sao comparados como conjuntos ordenados, porque a ordem dentro da mesma celula
+ * depende da ordem das insercoes.
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include "dados.h"
+#include "funcoes.h"
+
+#define VERIFICAR_LADO 12           // linhas e colunas onde as antenas sao colocadas
+#define VERIFICAR_FREQUENCIAS 4     // frequencias usadas ('A'..'D'), para haver muitos pares
+#define VERIFICAR_PERIODO 25        // alteracoes entre verificacoes completas
+
+/**
+ * @brief Antena do modelo de referencia (posicao livre quando id == 0)
+ */
+typedef struct AntenaModelo {
+    int id;
+    char frequencia;
+} AntenaModelo;
+
+/**
+ * @brief Estado da verificacao
+ */
+typedef struct Verificacao {
+    unsigned int estado;            // gerador xorshift
+    AntenaModelo grelha[VERIFICAR_LADO][VERIFICAR_LADO];
+    int proximoId;
+    int passo;
+    int erros;
+} Verificacao;
+
+/**
+ * @brief Gerador xorshift32 (a mesma semente da sempre a mesma sequencia)
+ */
+static unsigned int aleatorio(Verificacao* v) {
+    unsigned int x = v->estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return v->estado = x;
+}
+
+/**
+ * @brief Regista uma falha com o passo em que foi detetada
+ */
+static void falhou(Verificacao* v, const char* mensagem) {
+    v->erros++;
+    if (v->erros <= 20) fprintf(stderr, "passo %d: %s\n", v->passo, mensagem);
+}
+
+#pragma region COMPARACAO
+
+/**
+ * @brief Compara quadruplos (linha, coluna, a, b)
+ */
+static int compararQuadruplos(const void* a, const void* b) {
+    const int* q1 = (const int*)a;
+    const int* q2 = (const int*)b;
+    for (int i = 0; i < 4; i++) {
+        if (q1[i] != q2[i]) return q1[i] < q2[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copia uma lista de efeitos para um array ordenado de quadruplos
+ *
+ * @param h (inicio da lista de efeitos)
+ * @param n (apontador para o numero de efeitos)
+ * @return int* (array a libertar pelo chamador, NULL se a lista for vazia ou em caso de erro)
+ */
+static int* efeitosOrdenados(Nefasto* h, long* n) {
+    *n = 0;
+    for (Nefasto* e = h; e != NULL; e = e->next) (*n)++;
+    if (*n == 0) return NULL;
+    int* q = (int*)malloc((size_t)*n * 4 * sizeof(int));
+    if (q == NULL) return NULL;
+    long i = 0;
+    for (Nefasto* e = h; e != NULL; e = e->next, i++) {
+        q[4 * i] = e->linha;
+        q[4 * i + 1] = e->coluna;
+        q[4 * i + 2] = e->idAntena1;
+        q[4 * i + 3] = e->idAntena2;
+    }
+    qsort(q, (size_t)*n, 4 * sizeof(int), compararQuadruplos);
+    return q;
+}
+
+/**
+ * @brief Verifica que duas listas de efeitos tem os mesmos efeitos
+ */
+static bool mesmosEfeitos(Nefasto* a, Nefasto* b) {
+    long na, nb;
+    int* qa = efeitosOrdenados(a, &na);
+    int* qb = efeitosOrdenados(b, &nb);
+    bool iguais = na == nb && (na == 0 || (qa != NULL && qb != NULL && memcmp(qa, qb, (size_t)na * 4 * sizeof(int)) == 0));
+    free(qa);
+    free(qb);
+    return iguais;
+}
+
+/**
+ * @brief Verifica que a lista de antenas esta ordenada por posicao e coincide com o modelo
+ */
+static bool mesmasAntenas(Verificacao* v, Antena* h) {
+    int contadas = 0;
+    for (Antena* a = h; a != NULL; a = a->next) {
+        if (a->linha < 0 || a->linha >= VERIFICAR_LADO || a->coluna < 0 || a->coluna >= VERIFICAR_LADO) return false;
+        AntenaModelo* m = &v->grelha[a->linha][a->coluna];
+        if (m->id != a->id || m->frequencia != a->frequencia) return false;
+        if (a->next != NULL && (a->next->linha < a->linha || (a->next->linha == a->linha && a->next->coluna <= a->coluna))) return false;
+        contadas++;
+    }
+    for (int l = 0; l < VERIFICAR_LADO; l++) {
+        for (int c = 0; c < VERIFICAR_LADO; c++) {
+            if (v->grelha[l][c].id != 0) contadas--;
+        }
+    }
+    return contadas == 0;
+}
+
+/**
+ * @brief Verifica o estado do diario: antenas iguais ao modelo e efeitos iguais a atualizaEfeito
+ */
+static void verificarEstado(Verificacao* v, Diario* d, const char* momento) {
+    char mensagem[128];
+    if (!mesmasAntenas(v, d->antenas)) {
+        snprintf(mensagem, sizeof(mensagem), "antenas diferentes do modelo (%s)", momento);
+        falhou(v, mensagem);
+    }
+    Nefasto* esperados = atualizaEfeito(d->antenas);
+    if (!mesmosEfeitos(d->efeitos, esperados)) {
+        snprintf(mensagem, sizeof(mensagem), "efeitos diferentes de atualizaEfeito (%s)", momento);
+        falhou(v, mensagem);
+    }
+    DestroiListaEfeitos(esperados);
+}
+
+#pragma endregion
+
+#pragma region FICHEIROS
+
+/**
+ * @brief Acrescenta metade de um registo ao fim do diario (escrita interrompida)
+ */
+static bool acrescentarRegistoIncompleto(const char* ficheiroDiario) {
+    FILE* fp = fopen(ficheiroDiario, "ab");
+    if (fp == NULL) return false;
+    unsigned char lixo[7] = { 'I', 0xFF, 0xFF, 0xFF, 0x7F, 0x01, 0x02 };
+    bool ok = fwrite(lixo, sizeof(lixo), 1, fp) == 1;
+    return fclose(fp) == 0 && ok;
+}
+
+/**
+ * @brief Grava e le o instantaneo comprimido do estado atual e compara as listas
+ */
+static void verificarComprimido(Verificacao* v, Diario* d, const char* ficheiro) {
+    Antena* antenas = NULL;
+    Nefasto* efeitos = NULL;
+    if (!gravarFicheiroComprimido(d->antenas, d->efeitos, ficheiro)) falhou(v, "gravarFicheiroComprimido falhou");
+    else if (!lerFicheiroComprimido(ficheiro, &antenas, &efeitos)) falhou(v, "lerFicheiroComprimido falhou");
+    else {
+        if (!mesmasAntenas(v, antenas)) falhou(v, "antenas do instantaneo comprimido diferentes");
+        if (!mesmosEfeitos(d->efeitos, efeitos)) falhou(v, "efeitos do instantaneo comprimido diferentes");
+    }
+    DestroiListaAntenas(antenas);
+    DestroiListaEfeitos(efeitos);
+}
+
+#pragma endregion
+
+/**
+ * @brief Aplica uma alteracao aleatoria ao diario e ao modelo e compara o resultado
+ * Cerca de um quarto das alteracoes sao invalidas (posicao ocupada, id inexistente)
+ */
+static void alteracaoAleatoria(Verificacao* v, Diario* d) {
+    int linha = (int)(aleatorio(v) % VERIFICAR_LADO);
+    int coluna = (int)(aleatorio(v) % VERIFICAR_LADO);
+    char frequencia = (char)('A' + aleatorio(v) % VERIFICAR_FREQUENCIAS);
+    AntenaModelo* destino = &v->grelha[linha][coluna];
+    unsigned int tipo = aleatorio(v) % 3;
+
+    if (tipo == 0) {
+        // insercao: id novo, ou um id ja usado para testar a recusa
+        int id = aleatorio(v) % 4 == 0 && v->proximoId > 1 ? 1 + (int)(aleatorio(v) % (unsigned int)(v->proximoId - 1)) : v->proximoId;
+        bool idUsado = false;
+        for (int l = 0; l < VERIFICAR_LADO && !idUsado; l++) {
+            for (int c = 0; c < VERIFICAR_LADO; c++) {
+                if (v->grelha[l][c].id == id) idUsado = true;
+            }
+        }
+        bool valida = destino->id == 0 && !idUsado;
+        if (diarioInserirAntena(d, linha, coluna, id, frequencia) != valida) falhou(v, "diarioInserirAntena com resultado errado");
+        if (valida) {
+            destino->id = id;
+            destino->frequencia = frequencia;
+            if (id == v->proximoId) v->proximoId++;
+        }
+    }
+    else if (tipo == 1) {
+        bool valida = destino->id != 0;
+        if (diarioRemoverAntena(d, linha, coluna) != valida) falhou(v, "diarioRemoverAntena com resultado errado");
+        if (valida) destino->id = 0;
+    }
+    else {
+        // alteracao de uma antena existente (ou de um id que ja nao existe)
+        int id = v->proximoId > 1 ? 1 + (int)(aleatorio(v) % (unsigned int)(v->proximoId - 1)) : 1;
+        AntenaModelo* origem = NULL;
+        for (int l = 0; l < VERIFICAR_LADO && origem == NULL; l++) {
+            for (int c = 0; c < VERIFICAR_LADO; c++) {
+                if (v->grelha[l][c].id == id) origem = &v->grelha[l][c];
+            }
+        }
+        bool valida = origem != NULL && (destino->id == 0 || destino == origem);
+        if (diarioAlterarAntena(d, id, linha, coluna, frequencia) != valida) falhou(v, "diarioAlterarAntena com resultado errado");
+        if (valida) {
+            origem->id = 0;
+            destino->id = id;
+            destino->frequencia = frequencia;
+        }
+    }
+}
+
+/**
+ * @brief Executa a verificacao aleatoria do diario e do instantaneo comprimido
+ * Os ficheiros de trabalho sao criados com o prefixo dado e apagados no fim
+ *
+ * @param prefixo (prefixo dos ficheiros de trabalho)
+ * @param semente (semente do gerador, diferente de 0)
+ * @param alteracoes (numero de alteracoes aleatorias)
+ * @return int (numero de falhas encontradas, -1 em caso de erro)
+ */
+int verificarPersistencia(const char* prefixo, unsigned int semente, int alteracoes) {
+    if (prefixo == NULL || alteracoes < 0) return -1;
+    char instantaneo[1024], diario[1024], comprimido[1024], temporario[1024];
+    snprintf(instantaneo, sizeof(instantaneo), "%s.inst", prefixo);
+    snprintf(diario, sizeof(diario), "%s.diario", prefixo);
+    snprintf(comprimido, sizeof(comprimido), "%s.edaz", prefixo);
+    snprintf(temporario, sizeof(temporario), "%s.inst.tmp", prefixo);
+    remove(instantaneo);
+    remove(diario);
+    remove(temporario);
+
+    Verificacao* v = (Verificacao*)calloc(1, sizeof(Verificacao));
+    if (v == NULL) return -1;
+    v->estado = semente != 0 ? semente : 1;
+    v->proximoId = 1;
+
+    Diario* d = abrirDiario(instantaneo, diario, 0);
+    if (d == NULL) {
+        free(v);
+        return -1;
+    }
+    for (v->passo = 1; v->passo <= alteracoes && d != NULL; v->passo++) {
+        alteracaoAleatoria(v, d);
+        if (v->passo % VERIFICAR_PERIODO != 0) continue;
+        verificarEstado(v, d, "em memoria");
+
+        // alterna entre reabrir (reaplicar o diario), reabrir com um registo incompleto e compactar
+        int ciclo = (v->passo / VERIFICAR_PERIODO) % 4;
+        if (ciclo == 0 || ciclo == 1) {
+            d = fecharDiario(d);
+            if (ciclo == 1 && !acrescentarRegistoIncompleto(diario)) falhou(v, "nao foi possivel corromper o diario");
+            d = abrirDiario(instantaneo, diario, 0);
+            if (d == NULL) falhou(v, "abrirDiario falhou ao reaplicar o diario");
+            else verificarEstado(v, d, ciclo == 0 ? "depois de reabrir" : "depois de reabrir com registo incompleto");
+        }
+        else if (ciclo == 2) {
+            if (!compactarDiario(d)) falhou(v, "compactarDiario falhou");
+            verificarEstado(v, d, "depois de compactar");
+        }
+        else verificarComprimido(v, d, comprimido);
+    }
+    if (d != NULL) {
+        verificarEstado(v, d, "no fim");
+        verificarComprimido(v, d, comprimido);
+        d = fecharDiario(d);
+    }
+    int erros = v->erros;
+    free(v);
+    remove(instantaneo);
+    remove(diario);
+    remove(comprimido);
+    remove(temporario);
+    return erros;
+}
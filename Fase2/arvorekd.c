@@ -0,0 +1,442 @@
+/**
+ * @file arvorekd.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Indice espacial das antenas com arvores k-d (global e por frequencia)
+ * @details Cada arvore guarda os nos num array. A construcao em bloco escolhe em cada nivel o
+ * eixo com maior amplitude e divide pela mediana (selecao em tempo linear), pelo que a arvore
+ * fica equilibrada. As insercoes descem a arvore e acrescentam uma folha; quando a profundidade
+ * passa de cerca de 2*log2(n) a arvore e reconstruida. As remocoes apenas marcam o no, que
+ * continua a dividir o espaco ate a proxima reconstrucao.
+ * As procuras (k mais proximos e raio) descartam as subarvores cujo plano de divisao esta mais
+ * longe do que a melhor distancia conhecida, em vez de percorrer todos os vertices.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include "grafo.h"
+#include "struct.h"
+
+/**
+ * @brief Candidato na procura dos k mais proximos (max-heap pela distancia)
+ */
+typedef struct CandidatoKD {
+    long long distancia;    // quadrado da distancia ao ponto
+    int id;                 // id do vertice (desempate)
+} CandidatoKD;
+
+/**
+ * @brief Estado da procura dos k mais proximos
+ */
+typedef struct ProcuraProximos {
+    CandidatoKD* heap;      // k melhores candidatos, o pior na raiz
+    int tamanho;            // candidatos no heap
+    int k;                  // capacidade
+    Coordenada ponto;       // ponto de procura
+} ProcuraProximos;
+
+static int coordenadaEixo(Coordenada posicao, int eixo) {
+    return eixo == 0 ? posicao.x : posicao.y;
+}
+
+static long long distanciaQuadrado(Coordenada a, Coordenada b) {
+    long long dx = (long long)a.x - b.x;
+    long long dy = (long long)a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+/**
+ * @brief Coloca na posicao k o no que la ficaria se o intervalo estivesse ordenado pelo eixo
+ * Os nos antes de k ficam com coordenada menor ou igual e os seguintes com coordenada maior ou igual
+ */
+static void selecionarMediana(NoKD* nos, int inicio, int fim, int k, int eixo) {
+    int esquerda = inicio;
+    int direita = fim - 1;
+    while (esquerda < direita) {
+        int pivo = coordenadaEixo(nos[esquerda + (direita - esquerda) / 2].posicao, eixo);
+        int i = esquerda;
+        int j = direita;
+        while (i <= j) {
+            while (coordenadaEixo(nos[i].posicao, eixo) < pivo) i++;
+            while (coordenadaEixo(nos[j].posicao, eixo) > pivo) j--;
+            if (i <= j) {
+                NoKD temp = nos[i];
+                nos[i] = nos[j];
+                nos[j] = temp;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) direita = j;
+        else if (k >= i) esquerda = i;
+        else break;
+    }
+}
+
+/**
+ * @brief Constroi a subarvore equilibrada com os nos em [inicio, fim)
+ * @return Indice da raiz da subarvore ou -1 se o intervalo for vazio
+ */
+static int construirSubarvore(NoKD* nos, int inicio, int fim) {
+    if (inicio >= fim) return -1;
+    int minX = nos[inicio].posicao.x, maxX = minX;
+    int minY = nos[inicio].posicao.y, maxY = minY;
+    for (int i = inicio + 1; i < fim; i++) {
+        if (nos[i].posicao.x < minX) minX = nos[i].posicao.x;
+        if (nos[i].posicao.x > maxX) maxX = nos[i].posicao.x;
+        if (nos[i].posicao.y < minY) minY = nos[i].posicao.y;
+        if (nos[i].posicao.y > maxY) maxY = nos[i].posicao.y;
+    }
+    int eixo = ((long long)maxX - minX >= (long long)maxY - minY) ? 0 : 1;
+    int meio = inicio + (fim - inicio) / 2;
+    selecionarMediana(nos, inicio, fim, meio, eixo);
+    nos[meio].eixo = (unsigned char)eixo;
+    nos[meio].esquerdo = construirSubarvore(nos, inicio, meio);
+    nos[meio].direito = construirSubarvore(nos, meio + 1, fim);
+    return meio;
+}
+
+/**
+ * @brief Garante espaco para pelo menos minimo nos
+ */
+static bool reservarNos(ArvoreKD* arvore, int minimo) {
+    if (minimo <= arvore->capacidade) return true;
+    int novaCapacidade = arvore->capacidade > 0 ? arvore->capacidade * 2 : 16;
+    if (novaCapacidade < minimo) novaCapacidade = minimo;
+    NoKD* novos = (NoKD*)realloc(arvore->nos, novaCapacidade * sizeof(NoKD));
+    if (novos == NULL) return false;
+    arvore->nos = novos;
+    arvore->capacidade = novaCapacidade;
+    return true;
+}
+
+/**
+ * @brief Acrescenta um no ao array, sem o ligar a arvore
+ */
+static int acrescentarNo(ArvoreKD* arvore, NoVertice* vertice) {
+    if (!reservarNos(arvore, arvore->numNos + 1)) return -1;
+    NoKD* no = &arvore->nos[arvore->numNos];
+    no->posicao = vertice->dados.posicao;
+    no->id = vertice->id;
+    no->esquerdo = -1;
+    no->direito = -1;
+    no->eixo = 0;
+    no->removido = false;
+    return arvore->numNos++;
+}
+
+/**
+ * @brief Reconstroi uma arvore equilibrada, retirando os nos removidos
+ */
+static void reconstruirArvore(ArvoreKD* arvore) {
+    int n = 0;
+    for (int i = 0; i < arvore->numNos; i++) {
+        if (!arvore->nos[i].removido) arvore->nos[n++] = arvore->nos[i];
+    }
+    arvore->numNos = n;
+    arvore->numRemovidos = 0;
+    arvore->numConstruidos = n;
+    arvore->raiz = construirSubarvore(arvore->nos, 0, n);
+}
+
+/**
+ * @brief Liga o ultimo no acrescentado a arvore, descendo desde a raiz
+ * @return Profundidade a que o no ficou
+ */
+static int ligarNo(ArvoreKD* arvore, int indice) {
+    if (arvore->raiz < 0) {
+        arvore->raiz = indice;
+        return 1;
+    }
+    Coordenada p = arvore->nos[indice].posicao;
+    int atual = arvore->raiz;
+    int profundidade = 1;
+    for (;;) {
+        NoKD* no = &arvore->nos[atual];
+        profundidade++;
+        int* filho = coordenadaEixo(p, no->eixo) < coordenadaEixo(no->posicao, no->eixo) ? &no->esquerdo : &no->direito;
+        if (*filho < 0) {
+            *filho = indice;
+            arvore->nos[indice].eixo = (unsigned char)(1 - no->eixo);
+            return profundidade;
+        }
+        atual = *filho;
+    }
+}
+
+/**
+ * @brief Insere um vertice numa arvore, reconstruindo-a se ficar desequilibrada
+ */
+static bool inserirArvore(ArvoreKD* arvore, NoVertice* vertice) {
+    int indice = acrescentarNo(arvore, vertice);
+    if (indice < 0) return false;
+    int profundidade = ligarNo(arvore, indice);
+    int limite = 2;
+    for (int n = arvore->numNos; n > 1; n >>= 1) limite += 2;
+    if (profundidade > limite) reconstruirArvore(arvore);
+    return true;
+}
+
+/**
+ * @brief Procura o no de um id numa posicao (os nos com a mesma coordenada podem estar dos dois lados)
+ * @return Indice do no ou -1 se nao existir
+ */
+static int procurarNo(const ArvoreKD* arvore, int atual, Coordenada posicao, int id) {
+    while (atual >= 0) {
+        const NoKD* no = &arvore->nos[atual];
+        if (!no->removido && no->id == id && no->posicao.x == posicao.x && no->posicao.y == posicao.y) return atual;
+        int p = coordenadaEixo(posicao, no->eixo);
+        int c = coordenadaEixo(no->posicao, no->eixo);
+        if (p < c) atual = no->esquerdo;
+        else if (p > c) atual = no->direito;
+        else {
+            int encontrado = procurarNo(arvore, no->esquerdo, posicao, id);
+            if (encontrado >= 0) return encontrado;
+            atual = no->direito;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Marca um vertice como removido; reconstroi quando metade dos nos estao removidos
+ */
+static bool removerArvore(ArvoreKD* arvore, NoVertice* vertice) {
+    int indice = procurarNo(arvore, arvore->raiz, vertice->dados.posicao, vertice->id);
+    if (indice < 0) return false;
+    arvore->nos[indice].removido = true;
+    arvore->numRemovidos++;
+    if (arvore->numRemovidos * 2 > arvore->numNos) reconstruirArvore(arvore);
+    return true;
+}
+
+/**
+ * @brief Escolhe a arvore de uma frequencia ou a global (frequencia -1)
+ */
+static const ArvoreKD* escolherArvore(const IndiceEspacial* indice, int frequencia) {
+    if (indice == NULL || frequencia < -1 || frequencia >= NUM_FREQUENCIAS) return NULL;
+    return frequencia < 0 ? &indice->global : &indice->frequencias[frequencia];
+}
+
+/**
+ * @brief Constroi o indice espacial (arvores k-d) com as antenas do grafo
+ * @param grafo Apontador para o grafo
+ * @return Apontador para o indice ou NULL em caso de erro
+ */
+IndiceEspacial* construirIndiceEspacial(Grafo* grafo) {
+    if (grafo == NULL) return NULL;
+    IndiceEspacial* indice = (IndiceEspacial*)calloc(1, sizeof(IndiceEspacial));
+    if (indice == NULL) return NULL;
+    indice->global.raiz = -1;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) indice->frequencias[f].raiz = -1;
+
+    bool valido = reservarNos(&indice->global, grafo->numVertices);
+    for (int f = 0; valido && f < NUM_FREQUENCIAS; f++) {
+        GrupoFrequencia* grupo = &grafo->frequencias[f];
+        if (grupo->tamanho == 0) continue;
+        valido = reservarNos(&indice->frequencias[f], grupo->tamanho);
+        for (int k = 0; valido && k < grupo->tamanho; k++) {
+            valido = acrescentarNo(&indice->frequencias[f], grupo->membros[k]) >= 0 &&
+                acrescentarNo(&indice->global, grupo->membros[k]) >= 0;
+        }
+    }
+    if (!valido) {
+        libertarIndiceEspacial(indice);
+        return NULL;
+    }
+    reconstruirIndiceEspacial(indice);
+    return indice;
+}
+
+/**
+ * @brief Reconstroi todas as arvores do indice, equilibradas e sem os nos removidos
+ * @param indice Apontador para o indice
+ * @return true se reconstruido com sucesso, false caso contrario
+ */
+bool reconstruirIndiceEspacial(IndiceEspacial* indice) {
+    if (indice == NULL) return false;
+    reconstruirArvore(&indice->global);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (indice->frequencias[f].numNos > 0) reconstruirArvore(&indice->frequencias[f]);
+    }
+    return true;
+}
+
+/**
+ * @brief Insere um vertice no indice (arvore global e arvore da sua frequencia)
+ * @param indice Apontador para o indice
+ * @param vertice Vertice a inserir
+ * @return true se inserido com sucesso, false caso contrario
+ */
+bool inserirIndiceEspacial(IndiceEspacial* indice, NoVertice* vertice) {
+    if (indice == NULL || vertice == NULL) return false;
+    ArvoreKD* arvoreFrequencia = &indice->frequencias[(unsigned char)vertice->dados.frequencia];
+    if (!inserirArvore(&indice->global, vertice)) return false;
+    if (!inserirArvore(arvoreFrequencia, vertice)) {
+        removerArvore(&indice->global, vertice);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Remove um vertice do indice (deve ser chamado antes de o remover do grafo)
+ * @param indice Apontador para o indice
+ * @param vertice Vertice a remover
+ * @return true se removido, false se nao estava no indice
+ */
+bool removerIndiceEspacial(IndiceEspacial* indice, NoVertice* vertice) {
+    if (indice == NULL || vertice == NULL) return false;
+    if (!removerArvore(&indice->global, vertice)) return false;
+    removerArvore(&indice->frequencias[(unsigned char)vertice->dados.frequencia], vertice);
+    return true;
+}
+
+/**
+ * @brief Compara dois candidatos pela distancia e, em caso de empate, pelo id
+ */
+static bool piorCandidato(const CandidatoKD* a, const CandidatoKD* b) {
+    return a->distancia > b->distancia || (a->distancia == b->distancia && a->id > b->id);
+}
+
+/**
+ * @brief Repoe a propriedade de max-heap a partir da posicao i
+ */
+static void descerHeap(CandidatoKD* heap, int tamanho, int i) {
+    for (;;) {
+        int maior = i;
+        int e = 2 * i + 1;
+        int d = e + 1;
+        if (e < tamanho && piorCandidato(&heap[e], &heap[maior])) maior = e;
+        if (d < tamanho && piorCandidato(&heap[d], &heap[maior])) maior = d;
+        if (maior == i) return;
+        CandidatoKD temp = heap[i];
+        heap[i] = heap[maior];
+        heap[maior] = temp;
+        i = maior;
+    }
+}
+
+/**
+ * @brief Considera um candidato: entra se o heap nao estiver cheio ou se for melhor que o pior
+ */
+static void considerarCandidato(ProcuraProximos* procura, CandidatoKD candidato) {
+    if (procura->tamanho < procura->k) {
+        int i = procura->tamanho++;
+        procura->heap[i] = candidato;
+        while (i > 0 && piorCandidato(&procura->heap[i], &procura->heap[(i - 1) / 2])) {
+            CandidatoKD temp = procura->heap[i];
+            procura->heap[i] = procura->heap[(i - 1) / 2];
+            procura->heap[(i - 1) / 2] = temp;
+            i = (i - 1) / 2;
+        }
+    }
+    else if (piorCandidato(&procura->heap[0], &candidato)) {
+        procura->heap[0] = candidato;
+        descerHeap(procura->heap, procura->tamanho, 0);
+    }
+}
+
+static void procurarProximos(const ArvoreKD* arvore, int atual, ProcuraProximos* procura) {
+    if (atual < 0) return;
+    const NoKD* no = &arvore->nos[atual];
+    if (!no->removido) {
+        CandidatoKD candidato = { distanciaQuadrado(no->posicao, procura->ponto), no->id };
+        considerarCandidato(procura, candidato);
+    }
+    long long diferenca = (long long)coordenadaEixo(procura->ponto, no->eixo) - coordenadaEixo(no->posicao, no->eixo);
+    int perto = diferenca < 0 ? no->esquerdo : no->direito;
+    int longe = diferenca < 0 ? no->direito : no->esquerdo;
+    procurarProximos(arvore, perto, procura);
+    // o outro lado so interessa se o plano de divisao estiver mais perto que o pior candidato
+    if (procura->tamanho < procura->k || diferenca * diferenca <= procura->heap[0].distancia) {
+        procurarProximos(arvore, longe, procura);
+    }
+}
+
+/**
+ * @brief Procura as k antenas mais proximas de um ponto (distancia euclidiana)
+ * @param indice Apontador para o indice
+ * @param ponto Ponto de procura
+ * @param frequencia Frequencia das antenas (0..255) ou -1 para todas
+ * @param k Numero de antenas pretendidas
+ * @param ids Array com k posicoes para os ids, do mais proximo para o mais afastado
+ * @param distancias Array com k posicoes para as distancias ou NULL
+ * @return Numero de antenas encontradas ou -1 em caso de erro
+ */
+int vizinhosMaisProximos(const IndiceEspacial* indice, Coordenada ponto, int frequencia, int k, int* ids, double* distancias) {
+    const ArvoreKD* arvore = escolherArvore(indice, frequencia);
+    if (arvore == NULL || k < 0 || ids == NULL) return -1;
+    if (k == 0) return 0;
+    ProcuraProximos procura;
+    procura.heap = (CandidatoKD*)malloc(k * sizeof(CandidatoKD));
+    if (procura.heap == NULL) return -1;
+    procura.tamanho = 0;
+    procura.k = k;
+    procura.ponto = ponto;
+    procurarProximos(arvore, arvore->raiz, &procura);
+
+    // retira do heap do pior para o melhor
+    int encontrados = procura.tamanho;
+    for (int i = encontrados - 1; i >= 0; i--) {
+        ids[i] = procura.heap[0].id;
+        if (distancias != NULL) distancias[i] = sqrt((double)procura.heap[0].distancia);
+        procura.heap[0] = procura.heap[--procura.tamanho];
+        descerHeap(procura.heap, procura.tamanho, 0);
+    }
+    free(procura.heap);
+    return encontrados;
+}
+
+static void procurarRaio(const ArvoreKD* arvore, int atual, Coordenada centro, double raioQuadrado, int* ids, int maxIds, int* total) {
+    while (atual >= 0) {
+        const NoKD* no = &arvore->nos[atual];
+        if (!no->removido && (double)distanciaQuadrado(no->posicao, centro) <= raioQuadrado) {
+            if (ids != NULL && *total < maxIds) ids[*total] = no->id;
+            (*total)++;
+        }
+        long long diferenca = (long long)coordenadaEixo(centro, no->eixo) - coordenadaEixo(no->posicao, no->eixo);
+        bool planoDentro = (double)(diferenca * diferenca) <= raioQuadrado;
+        bool esquerdo = diferenca <= 0 || planoDentro;
+        bool direito = diferenca >= 0 || planoDentro;
+        if (esquerdo && direito) {
+            procurarRaio(arvore, no->esquerdo, centro, raioQuadrado, ids, maxIds, total);
+            atual = no->direito;
+        }
+        else atual = esquerdo ? no->esquerdo : no->direito;
+    }
+}
+
+/**
+ * @brief Procura as antenas a distancia menor ou igual a raio de um ponto
+ * @param indice Apontador para o indice
+ * @param centro Centro do circulo
+ * @param raio Raio do circulo
+ * @param frequencia Frequencia das antenas (0..255) ou -1 para todas
+ * @param ids Array para os ids encontrados ou NULL
+ * @param maxIds Capacidade do array de ids
+ * @return Numero total de antenas no circulo ou -1 em caso de erro
+ */
+int antenasNoRaio(const IndiceEspacial* indice, Coordenada centro, double raio, int frequencia, int* ids, int maxIds) {
+    const ArvoreKD* arvore = escolherArvore(indice, frequencia);
+    if (arvore == NULL || raio < 0) return -1;
+    int total = 0;
+    procurarRaio(arvore, arvore->raiz, centro, raio * raio, ids, maxIds, &total);
+    return total;
+}
+
+/**
+ * @brief Liberta o indice espacial
+ * @param indice Apontador para o indice
+ * @return true se libertado com sucesso, false caso contrario
+ */
+bool libertarIndiceEspacial(IndiceEspacial* indice) {
+    if (indice == NULL) return false;
+    free(indice->global.nos);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) free(indice->frequencias[f].nos);
+    free(indice);
+    return true;
+}
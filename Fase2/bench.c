@@ -0,0 +1,628 @@
+/**
+ * @file bench.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Programa de benchmark do grafo com saida JSON e comparacao com uma base
+ * @details Para cada tamanho pedido e gerado (com semente fixa) um mapa de antenas com a densidade
+ * e a distribuicao de frequencias escolhidas. O mapa e gravado em ficheiro e medem-se o
+ * carregamento, a construcao do grafo compacto (congelado, comprimido depois e comprimido
+ * diretamente do mapa, com a memoria de cada um no campo "memoria"), as buscas em profundidade e em largura, a procura de todos os caminhos (num
+ * subgrafo limitado, porque o numero de caminhos cresce exponencialmente), as intersecoes e as
+ * procuras por coordenadas e por frequencia. Cada caso e repetido e sao guardados o minimo e a
+ * mediana em nanossegundos.
+ * Com --base o resultado e comparado com um JSON gravado antes; a mediana de cada caso nao pode
+ * passar de limite vezes a da base (por omissao 1.25, ajustavel por caso). O programa termina
+ * com 1 se houver regressoes, 2 em caso de erro e 0 caso contrario.
+ *
+ * Exemplo: bench --tamanhos 32,64,128 --densidade 0.03 --frequencias 4 --saida atual.json --base base.json
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "grafo.h"
+#include "struct.h"
+
+#define BENCH_MAX_TAMANHOS 32
+#define BENCH_MAX_LIMITES 32
+#define BENCH_LARGURA_MAXIMA 250    // carregarDadosGrafo le linhas de ate 255 caracteres
+#define BENCH_RUIDO_NS 20000ull     // medianas abaixo disto nao sao comparadas (ruido do relogio)
+#define BENCH_MAX_INTERSECOES (1 << 20)
+
+// acumula os resultados das consultas para o compilador nao as eliminar
+static volatile long sumidouro = 0;
+
+static const char SIMBOLOS_FREQUENCIA[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+/**
+ * @brief Distribuicao das frequencias pelas antenas geradas
+ */
+typedef enum DistribuicaoFrequencias {
+    DISTRIBUICAO_UNIFORME,  // todas as frequencias com a mesma probabilidade
+    DISTRIBUICAO_ZIPF       // a frequencia k tem peso 1/(k+1)
+} DistribuicaoFrequencias;
+
+/**
+ * @brief Limite de abrandamento especifico de um caso
+ */
+typedef struct LimiteCaso {
+    char caso[48];          // nome do caso
+    double limite;          // razao maxima atual/base
+} LimiteCaso;
+
+/**
+ * @brief Parametros do benchmark
+ */
+typedef struct ConfiguracaoBench {
+    int tamanhos[BENCH_MAX_TAMANHOS]; // lado de cada mapa
+    int numTamanhos;        // numero de tamanhos
+    double densidade;       // fracao das celulas com antena
+    int numFrequencias;     // frequencias distintas
+    DistribuicaoFrequencias distribuicao; // distribuicao das frequencias
+    unsigned long long semente; // semente do gerador
+    int repeticoes;         // repeticoes de cada caso
+    int consultas;          // consultas por repeticao nos casos de procura
+    int maxVerticesCaminhos; // vertices do subgrafo usado em encontrarCaminhos
+    const char* saida;      // ficheiro JSON de saida (NULL para stdout)
+    const char* base;       // ficheiro JSON de base (NULL para nao comparar)
+    double limite;          // razao maxima atual/base por omissao
+    LimiteCaso limitesCaso[BENCH_MAX_LIMITES]; // limites especificos
+    int numLimitesCaso;     // numero de limites especificos
+} ConfiguracaoBench;
+
+/**
+ * @brief Resultado de um caso num tamanho
+ */
+typedef struct ResultadoBench {
+    char caso[48];          // nome do caso
+    int tamanho;            // lado do mapa
+    int vertices;           // vertices do grafo medido
+    int arestas;            // arestas do grafo medido
+    long operacoes;         // operacoes por repeticao (consultas, caminhos, ...)
+    size_t memoria;         // bytes da estrutura construida (0 nos casos que nao a medem)
+    unsigned long long minimoNs; // menor tempo
+    unsigned long long medianaNs; // mediana dos tempos
+    unsigned long long baseNs; // mediana na base (0 se nao existir)
+    bool regressao;         // a razao passou o limite
+} ResultadoBench;
+
+/**
+ * @brief Lista crescente de resultados
+ */
+typedef struct ListaResultados {
+    ResultadoBench* itens;  // resultados
+    int tamanho;            // resultados usados
+    int capacidade;         // tamanho alocado
+} ListaResultados;
+
+/**
+ * @brief Gerador xorshift64* (deterministico para a mesma semente)
+ */
+static unsigned long long proximoAleatorio(unsigned long long* estado) {
+    unsigned long long x = *estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *estado = x;
+    return x * 2685821657736338717ull;
+}
+
+/**
+ * @brief Numero aleatorio uniforme em [0, 1)
+ */
+static double aleatorioUnitario(unsigned long long* estado) {
+    return (double)(proximoAleatorio(estado) >> 11) / 9007199254740992.0;
+}
+
+/**
+ * @brief Instante atual em nanossegundos
+ */
+static unsigned long long relogioNs(void) {
+    struct timespec ts;
+    if (timespec_get(&ts, TIME_UTC) == 0) return 0;
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+static int compararTempos(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Dimensoes do mapa de lado n (a largura e limitada pelo leitor de mapas)
+ */
+static void dimensoesMapa(int lado, int* largura, int* altura) {
+    *largura = lado < BENCH_LARGURA_MAXIMA ? lado : BENCH_LARGURA_MAXIMA;
+    *altura = (int)(((long long)lado * lado + *largura - 1) / *largura);
+}
+
+/**
+ * @brief Sorteia o indice da frequencia de uma antena
+ */
+static int sortearFrequencia(const ConfiguracaoBench* config, unsigned long long* estado) {
+    if (config->distribuicao == DISTRIBUICAO_UNIFORME) return (int)(proximoAleatorio(estado) % (unsigned long long)config->numFrequencias);
+    double total = 0;
+    for (int k = 0; k < config->numFrequencias; k++) total += 1.0 / (k + 1);
+    double alvo = aleatorioUnitario(estado) * total;
+    for (int k = 0; k < config->numFrequencias; k++) {
+        alvo -= 1.0 / (k + 1);
+        if (alvo < 0) return k;
+    }
+    return config->numFrequencias - 1;
+}
+
+/**
+ * @brief Gera o ficheiro de mapa para um tamanho
+ * @param config Parametros do benchmark
+ * @param lado Lado do mapa
+ * @param nomeFicheiro Nome do ficheiro a criar
+ * @return true se o mapa foi gravado, false caso contrario
+ */
+static bool gerarMapa(const ConfiguracaoBench* config, int lado, const char* nomeFicheiro) {
+    int largura, altura;
+    dimensoesMapa(lado, &largura, &altura);
+    unsigned long long estado = config->semente ^ (0x9E3779B97F4A7C15ull * (unsigned long long)lado);
+    if (estado == 0) estado = 1;
+    FILE* fp = fopen(nomeFicheiro, "w");
+    if (fp == NULL) return false;
+    char linha[BENCH_LARGURA_MAXIMA + 2];
+    for (int y = 0; y < altura; y++) {
+        for (int x = 0; x < largura; x++) {
+            linha[x] = '.';
+            if (aleatorioUnitario(&estado) < config->densidade) linha[x] = SIMBOLOS_FREQUENCIA[sortearFrequencia(config, &estado)];
+        }
+        linha[largura] = '\n';
+        linha[largura + 1] = '\0';
+        fputs(linha, fp);
+    }
+    return fclose(fp) == 0;
+}
+
+/**
+ * @brief Acrescenta um resultado calculado a partir das amostras
+ */
+static bool registarResultado(ListaResultados* lista, const char* caso, int tamanho, Grafo* grafo, long operacoes, unsigned long long* amostras, int repeticoes) {
+    if (lista->tamanho == lista->capacidade) {
+        int novaCapacidade = lista->capacidade > 0 ? lista->capacidade * 2 : 32;
+        ResultadoBench* novos = (ResultadoBench*)realloc(lista->itens, novaCapacidade * sizeof(ResultadoBench));
+        if (novos == NULL) return false;
+        lista->itens = novos;
+        lista->capacidade = novaCapacidade;
+    }
+    qsort(amostras, repeticoes, sizeof(unsigned long long), compararTempos);
+    ResultadoBench* r = &lista->itens[lista->tamanho++];
+    memset(r, 0, sizeof(ResultadoBench));
+    strncpy(r->caso, caso, sizeof(r->caso) - 1);
+    r->tamanho = tamanho;
+    r->vertices = grafo != NULL ? grafo->numVertices : 0;
+    r->arestas = grafo != NULL ? grafo->numArestas : 0;
+    r->operacoes = operacoes;
+    r->minimoNs = amostras[0];
+    r->medianaNs = amostras[repeticoes / 2];
+    return true;
+}
+
+/**
+ * @brief Frequencias com mais membros (a primeira e a segunda)
+ */
+static void frequenciasMaiores(Grafo* grafo, char* primeira, char* segunda) {
+    int melhor = -1, segundaMelhor = -1;
+    *primeira = SIMBOLOS_FREQUENCIA[0];
+    *segunda = SIMBOLOS_FREQUENCIA[1];
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        int n = grafo->frequencias[f].tamanho;
+        if (n > melhor) {
+            segundaMelhor = melhor;
+            *segunda = *primeira;
+            melhor = n;
+            *primeira = (char)f;
+        }
+        else if (n > segundaMelhor) {
+            segundaMelhor = n;
+            *segunda = (char)f;
+        }
+    }
+}
+
+/**
+ * @brief Cria o subgrafo completo com os primeiros membros de uma frequencia (para encontrarCaminhos)
+ */
+static Grafo* subgrafoCaminhos(Grafo* grafo, char frequencia, int maxVertices) {
+    int numMembros = 0;
+    NoVertice* const* membros = obterVerticesFrequencia(grafo, frequencia, &numMembros);
+    if (numMembros > maxVertices) numMembros = maxVertices;
+    Grafo* sub = inicializarGrafo();
+    if (sub == NULL) return NULL;
+    for (int i = 0; i < numMembros; i++) {
+        if (adicionarVertice(sub, membros[i]->dados) == NULL) {
+            libertarGrafo(sub);
+            return NULL;
+        }
+    }
+    for (NoVertice* a = sub->primeiro; a != NULL; a = a->proximo) {
+        for (NoVertice* b = a->proximo; b != NULL; b = b->proximo) {
+            if (!anexarArestaDupla(sub, a, b)) {
+                libertarGrafo(sub);
+                return NULL;
+            }
+        }
+    }
+    return sub;
+}
+
+/**
+ * @brief Mede todos os casos para um tamanho
+ * @return true se as medicoes terminaram, false em caso de erro
+ */
+static bool medirTamanho(const ConfiguracaoBench* config, int lado, ListaResultados* lista) {
+    char nomeFicheiro[64];
+    snprintf(nomeFicheiro, sizeof(nomeFicheiro), "bench_mapa_%d.txt", lado);
+    if (!gerarMapa(config, lado, nomeFicheiro)) return false;
+    int repeticoes = config->repeticoes;
+    unsigned long long* amostras = (unsigned long long*)malloc(repeticoes * sizeof(unsigned long long));
+    if (amostras == NULL) {
+        remove(nomeFicheiro);
+        return false;
+    }
+
+    // carregamento
+    Grafo* grafo = NULL;
+    for (int r = 0; r < repeticoes; r++) {
+        if (grafo != NULL) libertarGrafo(grafo);
+        unsigned long long inicio = relogioNs();
+        grafo = carregarDadosGrafo(nomeFicheiro);
+        amostras[r] = relogioNs() - inicio;
+        if (grafo == NULL) break;
+    }
+    if (grafo == NULL) {
+        remove(nomeFicheiro);
+        free(amostras);
+        return false;
+    }
+    bool valido = registarResultado(lista, "carregarDadosGrafo", lado, grafo, 1, amostras, repeticoes);
+
+    // representacao compacta: congelada, comprimida depois e comprimida diretamente do mapa
+    // (a memoria de cada uma fica no resultado, para comparar o tamanho da adjacencia)
+    for (int tipo = 0; valido && tipo < 3; tipo++) {
+        GrafoCompacto* compacto = NULL;
+        for (int r = 0; r < repeticoes; r++) {
+            if (compacto != NULL) libertarGrafoCompacto(compacto);
+            unsigned long long inicio = relogioNs();
+            if (tipo < 2) compacto = congelarGrafo(grafo, ORDEM_HILBERT);
+            else compacto = carregarGrafoComprimido(nomeFicheiro, ORDEM_HILBERT, grafo->metrica);
+            if (tipo == 1 && compacto != NULL && !comprimirAdjacencia(compacto)) {
+                libertarGrafoCompacto(compacto);
+                compacto = NULL;
+            }
+            amostras[r] = relogioNs() - inicio;
+            if (compacto == NULL) break;
+        }
+        if (compacto == NULL) {
+            valido = false;
+            break;
+        }
+        const char* casos[] = { "congelarGrafo", "congelarGrafo+comprimirAdjacencia", "carregarGrafoComprimido" };
+        valido = registarResultado(lista, casos[tipo], lado, grafo, 1, amostras, repeticoes);
+        if (valido) lista->itens[lista->tamanho - 1].memoria = memoriaGrafoCompacto(compacto);
+        libertarGrafoCompacto(compacto);
+    }
+    remove(nomeFicheiro);
+    int largura, altura;
+    dimensoesMapa(lado, &largura, &altura);
+    unsigned long long estado = config->semente + (unsigned long long)lado;
+    if (estado == 0) estado = 1;
+
+    // buscas a partir do primeiro vertice (o grafo liga todos os membros de cada frequencia)
+    bool* visitados = (bool*)malloc((grafo->numVertices > 0 ? grafo->numVertices : 1) * sizeof(bool));
+    if (visitados == NULL) valido = false;
+    for (int tipo = 0; valido && tipo < 2 && grafo->primeiro != NULL; tipo++) {
+        for (int r = 0; r < repeticoes; r++) {
+            NoVertice** resultado = NULL;
+            int tamanhoResultado = 0;
+            memset(visitados, 0, grafo->numVertices * sizeof(bool));
+            unsigned long long inicio = relogioNs();
+            if (tipo == 0) buscaEmProfundidade(grafo, grafo->primeiro, visitados, &resultado, &tamanhoResultado);
+            else buscaEmLargura(grafo, grafo->primeiro, visitados, &resultado, &tamanhoResultado);
+            amostras[r] = relogioNs() - inicio;
+            free(resultado);
+        }
+        valido = registarResultado(lista, tipo == 0 ? "buscaEmProfundidade" : "buscaEmLargura", lado, grafo, 1, amostras, repeticoes);
+    }
+    free(visitados);
+
+    // todos os caminhos num subgrafo completo limitado a maxVerticesCaminhos vertices
+    char primeira, segunda;
+    frequenciasMaiores(grafo, &primeira, &segunda);
+    Grafo* sub = valido ? subgrafoCaminhos(grafo, primeira, config->maxVerticesCaminhos) : NULL;
+    if (sub != NULL && sub->numVertices >= 2) {
+        long numCaminhos = 0;
+        for (int r = 0; r < repeticoes; r++) {
+            ListaCaminho* caminhos = NULL;
+            unsigned long long inicio = relogioNs();
+            encontrarCaminhos(sub, sub->primeiro, sub->primeiro->proximo, &caminhos);
+            amostras[r] = relogioNs() - inicio;
+            numCaminhos = 0;
+            for (ListaCaminho* c = caminhos; c != NULL; c = c->proximo) numCaminhos++;
+            libertarCaminhos(caminhos);
+        }
+        valido = registarResultado(lista, "encontrarCaminhos", lado, sub, numCaminhos, amostras, repeticoes);
+    }
+    if (sub != NULL) libertarGrafo(sub);
+
+    // intersecoes entre as duas frequencias maiores
+    int numA = 0, numB = 0;
+    obterVerticesFrequencia(grafo, primeira, &numA);
+    obterVerticesFrequencia(grafo, segunda, &numB);
+    long maxIntersecoes = (long)numA * numB;
+    if (maxIntersecoes > BENCH_MAX_INTERSECOES) maxIntersecoes = BENCH_MAX_INTERSECOES;
+    Intersecao* intersecoes = valido && maxIntersecoes > 0 ? (Intersecao*)malloc(maxIntersecoes * sizeof(Intersecao)) : NULL;
+    if (intersecoes != NULL) {
+        int numIntersecoes = 0;
+        for (int r = 0; r < repeticoes; r++) {
+            unsigned long long inicio = relogioNs();
+            encontrarIntersecoes(grafo, primeira, segunda, intersecoes, &numIntersecoes, (int)maxIntersecoes);
+            amostras[r] = relogioNs() - inicio;
+        }
+        valido = registarResultado(lista, "encontrarIntersecoes", lado, grafo, numIntersecoes, amostras, repeticoes);
+        free(intersecoes);
+    }
+
+    // procuras por coordenadas (posicoes aleatorias, com e sem antena)
+    int* coordenadas = (int*)malloc(2 * (size_t)config->consultas * sizeof(int));
+    if (coordenadas == NULL) valido = false;
+    for (int i = 0; valido && i < config->consultas; i++) {
+        coordenadas[2 * i] = (int)(proximoAleatorio(&estado) % (unsigned long long)largura);
+        coordenadas[2 * i + 1] = (int)(proximoAleatorio(&estado) % (unsigned long long)altura);
+    }
+    if (valido) {
+        for (int r = 0; r < repeticoes; r++) {
+            long encontrados = 0;
+            unsigned long long inicio = relogioNs();
+            for (int i = 0; i < config->consultas; i++) {
+                if (encontrarVerticePorCoordenadas(grafo, coordenadas[2 * i], coordenadas[2 * i + 1]) != NULL) encontrados++;
+            }
+            amostras[r] = relogioNs() - inicio;
+            sumidouro += encontrados;
+        }
+        valido = registarResultado(lista, "encontrarVerticePorCoordenadas", lado, grafo, config->consultas, amostras, repeticoes);
+    }
+    free(coordenadas);
+
+    // procuras por frequencia (indice direto e copia para um array)
+    NoVertice** vertices = valido ? (NoVertice**)malloc((grafo->numVertices > 0 ? grafo->numVertices : 1) * sizeof(NoVertice*)) : NULL;
+    if (vertices != NULL) {
+        for (int tipo = 0; valido && tipo < 2; tipo++) {
+            for (int r = 0; r < repeticoes; r++) {
+                long total = 0;
+                unsigned long long inicio = relogioNs();
+                for (int i = 0; i < config->consultas; i++) {
+                    char frequencia = SIMBOLOS_FREQUENCIA[i % config->numFrequencias];
+                    int tamanho = 0;
+                    if (tipo == 0) obterVerticesFrequencia(grafo, frequencia, &tamanho);
+                    else encontrarVerticesPorFrequencia(grafo, frequencia, vertices, &tamanho, grafo->numVertices);
+                    total += tamanho;
+                }
+                amostras[r] = relogioNs() - inicio;
+                sumidouro += total;
+            }
+            valido = registarResultado(lista, tipo == 0 ? "obterVerticesFrequencia" : "encontrarVerticesPorFrequencia", lado, grafo, config->consultas, amostras, repeticoes);
+        }
+        free(vertices);
+    }
+    else valido = false;
+
+    libertarGrafo(grafo);
+    free(amostras);
+    return valido;
+}
+
+/**
+ * @brief Limite de abrandamento aplicavel a um caso
+ */
+static double limiteDoCaso(const ConfiguracaoBench* config, const char* caso) {
+    for (int i = 0; i < config->numLimitesCaso; i++) {
+        if (strcmp(config->limitesCaso[i].caso, caso) == 0) return config->limitesCaso[i].limite;
+    }
+    return config->limite;
+}
+
+/**
+ * @brief Le um campo "nome": valor de uma linha de resultado
+ */
+static const char* procurarCampo(const char* inicio, const char* fim, const char* campo) {
+    size_t n = strlen(campo);
+    for (const char* p = inicio; p + n <= fim; p++) {
+        if (memcmp(p, campo, n) == 0) return p + n;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Compara os resultados com um JSON de base gravado por este programa
+ * @return Numero de regressoes ou -1 se a base nao puder ser lida
+ */
+static int compararComBase(const ConfiguracaoBench* config, ListaResultados* lista) {
+    size_t tamanho = 0;
+    unsigned char* texto = lerFicheiroCompleto(config->base, &tamanho);
+    if (texto == NULL) return -1;
+    int regressoes = 0;
+    const char* p = (const char*)texto;
+    const char* fimTexto = p + tamanho;
+    // cada resultado ocupa uma linha: {"caso": "...", "tamanho": N, ..., "medianaNs": M, ...}
+    while (p < fimTexto) {
+        const char* fimLinha = memchr(p, '\n', (size_t)(fimTexto - p));
+        if (fimLinha == NULL) fimLinha = fimTexto;
+        const char* caso = procurarCampo(p, fimLinha, "\"caso\": \"");
+        const char* tamanhoCampo = procurarCampo(p, fimLinha, "\"tamanho\": ");
+        const char* mediana = procurarCampo(p, fimLinha, "\"medianaNs\": ");
+        if (caso != NULL && tamanhoCampo != NULL && mediana != NULL) {
+            const char* fimCaso = memchr(caso, '"', (size_t)(fimLinha - caso));
+            int lado = atoi(tamanhoCampo);
+            unsigned long long base = strtoull(mediana, NULL, 10);
+            for (int i = 0; fimCaso != NULL && i < lista->tamanho; i++) {
+                ResultadoBench* r = &lista->itens[i];
+                if (r->tamanho != lado || strlen(r->caso) != (size_t)(fimCaso - caso) || memcmp(r->caso, caso, (size_t)(fimCaso - caso)) != 0) continue;
+                r->baseNs = base;
+                if (base < BENCH_RUIDO_NS && r->medianaNs < BENCH_RUIDO_NS) continue;
+                double razao = base > 0 ? (double)r->medianaNs / (double)base : 0;
+                if (razao > limiteDoCaso(config, r->caso)) {
+                    r->regressao = true;
+                    regressoes++;
+                    fprintf(stderr, "REGRESSAO %s (tamanho %d): %llu ns contra %llu ns na base (%.2fx, limite %.2fx)\n",
+                        r->caso, r->tamanho, r->medianaNs, base, razao, limiteDoCaso(config, r->caso));
+                }
+            }
+        }
+        p = fimLinha + 1;
+    }
+    free(texto);
+    return regressoes;
+}
+
+/**
+ * @brief Grava os resultados em JSON (um resultado por linha, o formato lido por compararComBase)
+ */
+static bool gravarResultadosJSON(const ConfiguracaoBench* config, const ListaResultados* lista, FILE* fp) {
+    fprintf(fp, "{\n  \"semente\": %llu,\n  \"densidade\": %g,\n  \"frequencias\": %d,\n  \"distribuicao\": \"%s\",\n  \"repeticoes\": %d,\n  \"resultados\": [\n",
+        config->semente, config->densidade, config->numFrequencias,
+        config->distribuicao == DISTRIBUICAO_ZIPF ? "zipf" : "uniforme", config->repeticoes);
+    for (int i = 0; i < lista->tamanho; i++) {
+        const ResultadoBench* r = &lista->itens[i];
+        fprintf(fp, "    {\"caso\": \"%s\", \"tamanho\": %d, \"vertices\": %d, \"arestas\": %d, \"operacoes\": %ld, \"minimoNs\": %llu, \"medianaNs\": %llu",
+            r->caso, r->tamanho, r->vertices, r->arestas, r->operacoes, r->minimoNs, r->medianaNs);
+        if (r->memoria > 0) fprintf(fp, ", \"memoria\": %zu", r->memoria);
+        if (config->base != NULL) {
+            fprintf(fp, ", \"baseNs\": %llu, \"razao\": %.3f, \"regressao\": %s", r->baseNs,
+                r->baseNs > 0 ? (double)r->medianaNs / (double)r->baseNs : 0.0, r->regressao ? "true" : "false");
+        }
+        fprintf(fp, "}%s\n", i + 1 < lista->tamanho ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    return ferror(fp) == 0;
+}
+
+/**
+ * @brief Le uma lista de inteiros separados por virgulas
+ */
+static bool lerTamanhos(const char* texto, ConfiguracaoBench* config) {
+    config->numTamanhos = 0;
+    while (*texto != '\0' && config->numTamanhos < BENCH_MAX_TAMANHOS) {
+        char* fim;
+        long valor = strtol(texto, &fim, 10);
+        if (fim == texto || valor < 2 || valor > 100000) return false;
+        config->tamanhos[config->numTamanhos++] = (int)valor;
+        texto = *fim == ',' ? fim + 1 : fim;
+        if (*fim != ',' && *fim != '\0') return false;
+    }
+    return config->numTamanhos > 0;
+}
+
+static void mostrarUso(const char* programa) {
+    fprintf(stderr,
+        "Uso: %s [opcoes]\n"
+        "  --tamanhos L1,L2,...   lado dos mapas (omissao 32,64,128)\n"
+        "  --densidade D          fracao de celulas com antena (omissao 0.03)\n"
+        "  --frequencias F        frequencias distintas, 1..62 (omissao 4)\n"
+        "  --distribuicao uniforme|zipf\n"
+        "  --semente S            semente do gerador (omissao 1)\n"
+        "  --repeticoes R         repeticoes de cada caso (omissao 5)\n"
+        "  --consultas Q          consultas por repeticao nas procuras (omissao 10000)\n"
+        "  --caminhos-max N       vertices do subgrafo de encontrarCaminhos (omissao 6)\n"
+        "  --saida ficheiro.json  resultado (omissao stdout)\n"
+        "  --base ficheiro.json   compara com resultados anteriores\n"
+        "  --limite X             abrandamento maximo face a base (omissao 1.25)\n"
+        "  --limite-caso caso=X   abrandamento maximo de um caso\n", programa);
+}
+
+/**
+ * @brief Le os argumentos da linha de comandos
+ */
+static bool lerArgumentos(int argc, char* argv[], ConfiguracaoBench* config) {
+    for (int i = 1; i < argc; i++) {
+        const char* opcao = argv[i];
+        const char* valor = i + 1 < argc ? argv[i + 1] : NULL;
+        if (valor == NULL) return false;
+        i++;
+        if (strcmp(opcao, "--tamanhos") == 0) {
+            if (!lerTamanhos(valor, config)) return false;
+        }
+        else if (strcmp(opcao, "--densidade") == 0) config->densidade = atof(valor);
+        else if (strcmp(opcao, "--frequencias") == 0) config->numFrequencias = atoi(valor);
+        else if (strcmp(opcao, "--distribuicao") == 0) {
+            if (strcmp(valor, "uniforme") == 0) config->distribuicao = DISTRIBUICAO_UNIFORME;
+            else if (strcmp(valor, "zipf") == 0) config->distribuicao = DISTRIBUICAO_ZIPF;
+            else return false;
+        }
+        else if (strcmp(opcao, "--semente") == 0) config->semente = strtoull(valor, NULL, 10);
+        else if (strcmp(opcao, "--repeticoes") == 0) config->repeticoes = atoi(valor);
+        else if (strcmp(opcao, "--consultas") == 0) config->consultas = atoi(valor);
+        else if (strcmp(opcao, "--caminhos-max") == 0) config->maxVerticesCaminhos = atoi(valor);
+        else if (strcmp(opcao, "--saida") == 0) config->saida = valor;
+        else if (strcmp(opcao, "--base") == 0) config->base = valor;
+        else if (strcmp(opcao, "--limite") == 0) config->limite = atof(valor);
+        else if (strcmp(opcao, "--limite-caso") == 0) {
+            const char* igual = strchr(valor, '=');
+            if (igual == NULL || config->numLimitesCaso >= BENCH_MAX_LIMITES || (size_t)(igual - valor) >= sizeof(config->limitesCaso[0].caso)) return false;
+            LimiteCaso* limite = &config->limitesCaso[config->numLimitesCaso++];
+            memset(limite->caso, 0, sizeof(limite->caso));
+            memcpy(limite->caso, valor, (size_t)(igual - valor));
+            limite->limite = atof(igual + 1);
+        }
+        else return false;
+    }
+    return config->densidade > 0 && config->densidade <= 1 &&
+        config->numFrequencias >= 1 && config->numFrequencias <= (int)sizeof(SIMBOLOS_FREQUENCIA) - 1 &&
+        config->repeticoes >= 1 && config->consultas >= 1 && config->maxVerticesCaminhos >= 2 && config->limite > 0;
+}
+
+int main(int argc, char* argv[]) {
+    ConfiguracaoBench config;
+    memset(&config, 0, sizeof(config));
+    config.tamanhos[0] = 32;
+    config.tamanhos[1] = 64;
+    config.tamanhos[2] = 128;
+    config.numTamanhos = 3;
+    config.densidade = 0.03;
+    config.numFrequencias = 4;
+    config.distribuicao = DISTRIBUICAO_UNIFORME;
+    config.semente = 1;
+    config.repeticoes = 5;
+    config.consultas = 10000;
+    config.maxVerticesCaminhos = 6;
+    config.limite = 1.25;
+    if (!lerArgumentos(argc, argv, &config)) {
+        mostrarUso(argv[0]);
+        return 2;
+    }
+
+    ListaResultados lista = { NULL, 0, 0 };
+    for (int i = 0; i < config.numTamanhos; i++) {
+        if (!medirTamanho(&config, config.tamanhos[i], &lista)) {
+            fprintf(stderr, "Erro ao medir o tamanho %d\n", config.tamanhos[i]);
+            free(lista.itens);
+            return 2;
+        }
+    }
+
+    int regressoes = 0;
+    if (config.base != NULL) {
+        regressoes = compararComBase(&config, &lista);
+        if (regressoes < 0) {
+            fprintf(stderr, "Nao foi possivel ler a base %s\n", config.base);
+            free(lista.itens);
+            return 2;
+        }
+    }
+
+    FILE* fp = config.saida != NULL ? fopen(config.saida, "w") : stdout;
+    bool gravado = fp != NULL && gravarResultadosJSON(&config, &lista, fp);
+    if (fp != NULL && fp != stdout && fclose(fp) != 0) gravado = false;
+    free(lista.itens);
+    if (!gravado) return 2;
+    return regressoes > 0 ? 1 : 0;
+}
@@ -0,0 +1,373 @@
+/**
+ * @file cache.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Cache LRU dos resultados das procuras (largura, profundidade e caminhos)
+ * @details Cada entrada e identificada pelo tipo de consulta, pela origem, pelo destino e pelo
+ * parametro, e guarda o resultado em arrays de ids. A entrada fica marcada com a geracao do grafo
+ * em que foi validada e com a lista dos membros do componente da origem. Quando o grafo muda,
+ * a entrada so e recalculada se algum desses membros tiver sido removido ou alterado depois
+ * dessa geracao (cada vertice guarda a geracao da sua ultima alteracao), pelo que alteracoes
+ * noutros componentes nao invalidam os resultados guardados.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "grafo.h"
+#include "struct.h"
+
+/**
+ * @brief Calcula o balde de uma chave
+ */
+static int baldeChave(const CacheConsultas* cache, TipoConsulta tipo, RefVertice origem, RefVertice destino, int parametro) {
+    unsigned int h = 2166136261u;
+    unsigned int partes[6] = { (unsigned int)tipo, (unsigned int)origem.id, origem.geracao,
+        (unsigned int)destino.id, destino.geracao, (unsigned int)parametro };
+    for (int i = 0; i < 6; i++) {
+        h ^= partes[i];
+        h *= 16777619u;
+    }
+    return (int)(h & (unsigned int)(cache->numBaldes - 1));
+}
+
+/**
+ * @brief Compara a chave de uma entrada
+ */
+static bool mesmaChave(const EntradaCache* e, TipoConsulta tipo, RefVertice origem, RefVertice destino, int parametro) {
+    return e->tipo == tipo && e->parametro == parametro &&
+        e->origem.id == origem.id && e->origem.geracao == origem.geracao &&
+        e->destino.id == destino.id && e->destino.geracao == destino.geracao;
+}
+
+/**
+ * @brief Liberta os arrays de uma entrada
+ */
+static void libertarDadosEntrada(EntradaCache* e) {
+    free(e->dependencias);
+    free(e->ids);
+    free(e->inicios);
+    e->dependencias = NULL;
+    e->ids = NULL;
+    e->inicios = NULL;
+    e->numDependencias = 0;
+    e->tamanho = 0;
+    e->numCaminhos = 0;
+}
+
+/**
+ * @brief Retira uma entrada da lista LRU
+ */
+static void desligarLRU(CacheConsultas* cache, int indice) {
+    EntradaCache* e = &cache->entradas[indice];
+    if (e->anterior >= 0) cache->entradas[e->anterior].seguinte = e->seguinte;
+    else cache->maisRecente = e->seguinte;
+    if (e->seguinte >= 0) cache->entradas[e->seguinte].anterior = e->anterior;
+    else cache->menosRecente = e->anterior;
+    e->anterior = -1;
+    e->seguinte = -1;
+}
+
+/**
+ * @brief Coloca uma entrada no inicio da lista LRU
+ */
+static void colocarInicioLRU(CacheConsultas* cache, int indice) {
+    EntradaCache* e = &cache->entradas[indice];
+    e->anterior = -1;
+    e->seguinte = cache->maisRecente;
+    if (cache->maisRecente >= 0) cache->entradas[cache->maisRecente].anterior = indice;
+    cache->maisRecente = indice;
+    if (cache->menosRecente < 0) cache->menosRecente = indice;
+}
+
+/**
+ * @brief Retira uma entrada da cache e devolve-a a lista de entradas livres
+ */
+static void retirarEntrada(CacheConsultas* cache, int indice) {
+    EntradaCache* e = &cache->entradas[indice];
+    int* ligacao = &cache->baldes[baldeChave(cache, e->tipo, e->origem, e->destino, e->parametro)];
+    while (*ligacao != indice) ligacao = &cache->entradas[*ligacao].proximaDispersao;
+    *ligacao = e->proximaDispersao;
+    desligarLRU(cache, indice);
+    libertarDadosEntrada(e);
+    e->proximaDispersao = cache->livres;
+    cache->livres = indice;
+    cache->numEntradas--;
+}
+
+/**
+ * @brief Verifica se o resultado de uma entrada continua valido na geracao atual do grafo
+ * Se for valido, a entrada passa a ficar marcada com a geracao atual
+ */
+static bool entradaValida(CacheConsultas* cache, EntradaCache* e) {
+    Grafo* grafo = cache->grafo;
+    if (e->geracao == grafo->geracao) return true;
+    for (int i = 0; i < e->numDependencias; i++) {
+        NoVertice* v = resolverReferencia(grafo, e->dependencias[i]);
+        if (v == NULL || v->geracaoAlteracao > e->geracao) return false;
+    }
+    e->geracao = grafo->geracao;
+    return true;
+}
+
+/**
+ * @brief Converte um array de vertices para ids
+ */
+static int* copiarIds(NoVertice** vertices, int tamanho) {
+    int* ids = (int*)malloc((tamanho > 0 ? tamanho : 1) * sizeof(int));
+    if (ids == NULL) return NULL;
+    for (int i = 0; i < tamanho; i++) ids[i] = vertices[i]->id;
+    return ids;
+}
+
+/**
+ * @brief Executa uma busca (largura ou profundidade) e guarda a ordem de visita
+ */
+static bool calcularBusca(Grafo* grafo, TipoConsulta tipo, NoVertice* origem, EntradaCache* e) {
+    bool* visitados = (bool*)calloc(grafo->numVertices, sizeof(bool));
+    if (visitados == NULL) return false;
+    NoVertice** resultado = NULL;
+    int tamanho = 0;
+    e->encontrado = tipo == CONSULTA_LARGURA
+        ? buscaEmLargura(grafo, origem, visitados, &resultado, &tamanho)
+        : buscaEmProfundidade(grafo, origem, visitados, &resultado, &tamanho);
+    free(visitados);
+    if (!e->encontrado) tamanho = 0;
+    e->ids = copiarIds(resultado, tamanho);
+    e->tamanho = tamanho;
+    free(resultado);
+    return e->ids != NULL;
+}
+
+/**
+ * @brief Procura os caminhos entre origem e destino e guarda-os seguidos em ids
+ */
+static bool calcularCaminhos(Grafo* grafo, NoVertice* origem, NoVertice* destino, int maxCaminhos, EntradaCache* e) {
+    ListaCaminho* caminhos = NULL;
+    e->encontrado = encontrarCaminhos(grafo, origem, destino, &caminhos);
+    int numCaminhos = 0;
+    int tamanho = 0;
+    for (ListaCaminho* c = caminhos; c != NULL && (maxCaminhos == 0 || numCaminhos < maxCaminhos); c = c->proximo) {
+        for (ElementoCaminho* el = c->caminho; el != NULL; el = el->proximo) tamanho++;
+        numCaminhos++;
+    }
+    e->ids = (int*)malloc((tamanho > 0 ? tamanho : 1) * sizeof(int));
+    e->inicios = (int*)malloc((numCaminhos + 1) * sizeof(int));
+    if (e->ids == NULL || e->inicios == NULL) {
+        libertarCaminhos(caminhos);
+        return false;
+    }
+    int k = 0;
+    int n = 0;
+    for (ListaCaminho* c = caminhos; n < numCaminhos; c = c->proximo) {
+        e->inicios[n++] = k;
+        for (ElementoCaminho* el = c->caminho; el != NULL; el = el->proximo) e->ids[k++] = el->vertice->id;
+    }
+    e->inicios[numCaminhos] = k;
+    e->tamanho = tamanho;
+    e->numCaminhos = numCaminhos;
+    libertarCaminhos(caminhos);
+    return true;
+}
+
+/**
+ * @brief Procura o caminho com menos saltos e guarda-o como um unico caminho em ids
+ */
+static bool calcularMenosSaltos(Grafo* grafo, NoVertice* origem, NoVertice* destino, EntradaCache* e) {
+    NoVertice** caminho = NULL;
+    int tamanho = 0;
+    int saltos = 0;
+    e->encontrado = caminhoMenosSaltos(grafo, origem, destino, &saltos, &caminho, &tamanho);
+    if (!e->encontrado) tamanho = 0;
+    e->ids = copiarIds(caminho, tamanho);
+    e->inicios = (int*)malloc(2 * sizeof(int));
+    free(caminho);
+    if (e->ids == NULL || e->inicios == NULL) return false;
+    e->numCaminhos = e->encontrado ? 1 : 0;
+    e->inicios[0] = 0;
+    e->inicios[1] = tamanho;
+    e->tamanho = tamanho;
+    return true;
+}
+
+/**
+ * @brief Calcula o resultado de uma consulta e as suas dependencias (membros do componente da origem)
+ * @param cache Apontador para a cache
+ * @param e Entrada a preencher (so os dados; a chave e as ligacoes nao sao alteradas)
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino (NULL nas buscas)
+ * @return true se o resultado foi calculado, false em caso de erro
+ */
+static bool calcularEntrada(CacheConsultas* cache, EntradaCache* e, NoVertice* origem, NoVertice* destino) {
+    Grafo* grafo = cache->grafo;
+    e->dependencias = NULL;
+    e->ids = NULL;
+    e->inicios = NULL;
+    e->numDependencias = 0;
+    e->tamanho = 0;
+    e->numCaminhos = 0;
+    NoVertice** membros = NULL;
+    int numMembros = 0;
+    if (!listarComponente(grafo, origem, &membros, &numMembros)) return false;
+    e->dependencias = (RefVertice*)malloc(numMembros * sizeof(RefVertice));
+    if (e->dependencias == NULL) {
+        free(membros);
+        return false;
+    }
+    for (int i = 0; i < numMembros; i++) e->dependencias[i] = obterReferencia(grafo, membros[i]->id);
+    e->numDependencias = numMembros;
+    free(membros);
+
+    bool valido = false;
+    switch (e->tipo) {
+    case CONSULTA_LARGURA:
+    case CONSULTA_PROFUNDIDADE:
+        valido = calcularBusca(grafo, e->tipo, origem, e);
+        break;
+    case CONSULTA_CAMINHOS:
+        valido = calcularCaminhos(grafo, origem, destino, e->parametro, e);
+        break;
+    case CONSULTA_MENOS_SALTOS:
+        valido = calcularMenosSaltos(grafo, origem, destino, e);
+        break;
+    }
+    if (!valido) {
+        libertarDadosEntrada(e);
+        return false;
+    }
+    e->geracao = grafo->geracao;
+    return true;
+}
+
+/**
+ * @brief Cria uma cache de consultas sobre um grafo
+ * @param grafo Apontador para o grafo
+ * @param capacidade Numero maximo de resultados guardados
+ * @return Apontador para a cache criada ou NULL em caso de erro
+ */
+CacheConsultas* criarCacheConsultas(Grafo* grafo, int capacidade) {
+    if (grafo == NULL || capacidade <= 0) return NULL;
+    CacheConsultas* cache = (CacheConsultas*)calloc(1, sizeof(CacheConsultas));
+    if (cache == NULL) return NULL;
+    cache->numBaldes = 1;
+    while (cache->numBaldes < capacidade * 2) cache->numBaldes *= 2;
+    cache->entradas = (EntradaCache*)calloc(capacidade, sizeof(EntradaCache));
+    cache->baldes = (int*)malloc(cache->numBaldes * sizeof(int));
+    if (cache->entradas == NULL || cache->baldes == NULL) {
+        free(cache->entradas);
+        free(cache->baldes);
+        free(cache);
+        return NULL;
+    }
+    cache->grafo = grafo;
+    cache->capacidade = capacidade;
+    for (int b = 0; b < cache->numBaldes; b++) cache->baldes[b] = -1;
+    for (int i = 0; i < capacidade; i++) {
+        cache->entradas[i].anterior = -1;
+        cache->entradas[i].seguinte = -1;
+        cache->entradas[i].proximaDispersao = i + 1 < capacidade ? i + 1 : -1;
+    }
+    cache->livres = 0;
+    cache->maisRecente = -1;
+    cache->menosRecente = -1;
+    return cache;
+}
+
+/**
+ * @brief Obtem o resultado de uma consulta, a partir da cache ou calculando-o
+ * @param cache Apontador para a cache
+ * @param tipo Tipo de consulta
+ * @param origem Vertice de origem (ainda no grafo: o apontador e lido)
+ * @param destino Vertice de destino (ainda no grafo; ignorado nas buscas)
+ * @param parametro Maximo de caminhos guardados em CONSULTA_CAMINHOS (0 = todos; ignorado nos outros tipos)
+ * @param resultado Apontador para o resultado (valido ate a proxima chamada sobre a cache)
+ * @return true se o resultado foi obtido, false em caso de erro
+ */
+bool consultarCache(CacheConsultas* cache, TipoConsulta tipo, NoVertice* origem, NoVertice* destino, int parametro, ResultadoConsulta* resultado) {
+    if (cache == NULL || resultado == NULL || parametro < 0) return false;
+    bool usaDestino = tipo == CONSULTA_CAMINHOS || tipo == CONSULTA_MENOS_SALTOS;
+    if (origem == NULL || (usaDestino && destino == NULL)) return false;
+    RefVertice refOrigem = obterReferencia(cache->grafo, origem->id);
+    RefVertice refDestino = { -1, 0 };
+    if (usaDestino) refDestino = obterReferencia(cache->grafo, destino->id);
+    // o id tem de ser mesmo deste vertice (um apontador de outro grafo pode ter o mesmo id)
+    if (refOrigem.id < 0 || resolverReferencia(cache->grafo, refOrigem) != origem) return false;
+    if (usaDestino && (refDestino.id < 0 || resolverReferencia(cache->grafo, refDestino) != destino)) return false;
+    if (tipo != CONSULTA_CAMINHOS) parametro = 0;
+    if (!usaDestino) destino = NULL;
+
+    int balde = baldeChave(cache, tipo, refOrigem, refDestino, parametro);
+    int indice = cache->baldes[balde];
+    while (indice >= 0 && !mesmaChave(&cache->entradas[indice], tipo, refOrigem, refDestino, parametro)) {
+        indice = cache->entradas[indice].proximaDispersao;
+    }
+
+    if (indice >= 0) {
+        EntradaCache* e = &cache->entradas[indice];
+        if (entradaValida(cache, e)) {
+            cache->acertos++;
+        }
+        else {
+            cache->invalidacoes++;
+            libertarDadosEntrada(e);
+            if (!calcularEntrada(cache, e, origem, destino)) {
+                retirarEntrada(cache, indice);
+                return false;
+            }
+        }
+        desligarLRU(cache, indice);
+        colocarInicioLRU(cache, indice);
+    }
+    else {
+        cache->falhas++;
+        EntradaCache nova = { 0 };
+        nova.tipo = tipo;
+        nova.origem = refOrigem;
+        nova.destino = refDestino;
+        nova.parametro = parametro;
+        if (!calcularEntrada(cache, &nova, origem, destino)) return false;
+        // sem entradas livres sai o resultado usado ha mais tempo
+        if (cache->livres < 0) retirarEntrada(cache, cache->menosRecente);
+        indice = cache->livres;
+        cache->livres = cache->entradas[indice].proximaDispersao;
+        nova.proximaDispersao = cache->baldes[balde];
+        cache->baldes[balde] = indice;
+        cache->entradas[indice] = nova;
+        colocarInicioLRU(cache, indice);
+        cache->numEntradas++;
+    }
+
+    EntradaCache* e = &cache->entradas[indice];
+    resultado->encontrado = e->encontrado;
+    resultado->ids = e->ids;
+    resultado->tamanho = e->tamanho;
+    resultado->inicios = e->inicios;
+    resultado->numCaminhos = e->numCaminhos;
+    return true;
+}
+
+/**
+ * @brief Descarta todos os resultados guardados (os contadores mantem-se)
+ * @param cache Apontador para a cache
+ * @return true se a cache foi limpa, false caso contrario
+ */
+bool limparCacheConsultas(CacheConsultas* cache) {
+    if (cache == NULL) return false;
+    while (cache->maisRecente >= 0) retirarEntrada(cache, cache->maisRecente);
+    return true;
+}
+
+/**
+ * @brief Liberta a cache de consultas
+ * @param cache Apontador para a cache
+ * @return true se libertada com sucesso, false caso contrario
+ */
+bool libertarCacheConsultas(CacheConsultas* cache) {
+    if (cache == NULL) return false;
+    limparCacheConsultas(cache);
+    free(cache->entradas);
+    free(cache->baldes);
+    free(cache);
+    return true;
+}
@@ -0,0 +1,410 @@
+/**
+ * @file caminhos.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Caminhos de custo minimo (Dijkstra e A*) com uma fila de prioridade binaria indexada
+ * @details O custo de um caminho e a soma dos pesos das arestas (ver definirMetricaPesos).
+ * A fila guarda ids de vertices e a posicao de cada id no monte, o que permite
+ * diminuir a chave de um vertice em O(log V) sem entradas repetidas.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "grafo.h"
+#include "struct.h"
+
+#define FORA_DO_MONTE -1    // vertice ainda nao alcancado
+#define FECHADO -2          // vertice ja retirado do monte com custo final
+
+/**
+ * @brief Fila de prioridade binaria indexada pelo id do vertice
+ */
+typedef struct MonteIndexado {
+    int* ids;               // monte de ids ordenado pela chave
+    int* posicao;           // posicao de cada id no monte (ou FORA_DO_MONTE / FECHADO)
+    double* chave;          // prioridade de cada id
+    int tamanho;            // numero de elementos no monte
+} MonteIndexado;
+
+static void trocarNoMonte(MonteIndexado* monte, int i, int j) {
+    int temp = monte->ids[i];
+    monte->ids[i] = monte->ids[j];
+    monte->ids[j] = temp;
+    monte->posicao[monte->ids[i]] = i;
+    monte->posicao[monte->ids[j]] = j;
+}
+
+static void subirNoMonte(MonteIndexado* monte, int i) {
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (monte->chave[monte->ids[pai]] <= monte->chave[monte->ids[i]]) break;
+        trocarNoMonte(monte, i, pai);
+        i = pai;
+    }
+}
+
+static void descerNoMonte(MonteIndexado* monte, int i) {
+    for (;;) {
+        int menor = i;
+        int esquerda = 2 * i + 1;
+        int direita = esquerda + 1;
+        if (esquerda < monte->tamanho && monte->chave[monte->ids[esquerda]] < monte->chave[monte->ids[menor]]) menor = esquerda;
+        if (direita < monte->tamanho && monte->chave[monte->ids[direita]] < monte->chave[monte->ids[menor]]) menor = direita;
+        if (menor == i) return;
+        trocarNoMonte(monte, i, menor);
+        i = menor;
+    }
+}
+
+/**
+ * @brief Insere um id no monte ou diminui a sua chave se ja la estiver
+ */
+static void colocarNoMonte(MonteIndexado* monte, int id, double chave) {
+    monte->chave[id] = chave;
+    if (monte->posicao[id] == FORA_DO_MONTE) {
+        monte->ids[monte->tamanho] = id;
+        monte->posicao[id] = monte->tamanho++;
+    }
+    subirNoMonte(monte, monte->posicao[id]);
+}
+
+/**
+ * @brief Retira o id com menor chave e marca-o como fechado
+ */
+static int retirarDoMonte(MonteIndexado* monte) {
+    int id = monte->ids[0];
+    trocarNoMonte(monte, 0, --monte->tamanho);
+    monte->posicao[id] = FECHADO;
+    descerNoMonte(monte, 0);
+    return id;
+}
+
+/**
+ * @brief Pesquisa de custo minimo comum ao Dijkstra e ao A*
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param usarHeuristica true para somar a distancia em linha reta ate ao destino (A*)
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total (pode ser NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+static bool pesquisarCustoMinimo(Grafo* grafo, NoVertice* origem, NoVertice* destino, bool usarHeuristica,
+    NoVertice*** caminho, int* tamanhoCaminho, double* custo) {
+    if (grafo == NULL || origem == NULL || destino == NULL || caminho == NULL || tamanhoCaminho == NULL) return false;
+    *caminho = NULL;
+    *tamanhoCaminho = 0;
+    // o indice de componentes responde de imediato quando nao ha caminho
+    if (!mesmoComponente(grafo, origem, destino)) return false;
+
+    // com pesos unitarios a distancia em linha reta nao e um limite inferior do custo
+    bool heuristica = usarHeuristica && grafo->metrica != METRICA_UNITARIA;
+    int n = grafo->limiteIds;
+    double* distancia = (double*)malloc(n * sizeof(double));
+    int* anterior = (int*)malloc(n * sizeof(int));
+    MonteIndexado monte;
+    monte.ids = (int*)malloc(n * sizeof(int));
+    monte.posicao = (int*)malloc(n * sizeof(int));
+    monte.chave = (double*)malloc(n * sizeof(double));
+    monte.tamanho = 0;
+    if (distancia == NULL || anterior == NULL || monte.ids == NULL || monte.posicao == NULL || monte.chave == NULL) {
+        free(distancia);
+        free(anterior);
+        free(monte.ids);
+        free(monte.posicao);
+        free(monte.chave);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        monte.posicao[i] = FORA_DO_MONTE;
+        anterior[i] = -1;
+    }
+
+    distancia[origem->id] = 0.0;
+    colocarNoMonte(&monte, origem->id, heuristica ? distanciaVertices(origem, destino, METRICA_EUCLIDIANA) : 0.0);
+    bool encontrado = false;
+    while (monte.tamanho > 0) {
+        int id = retirarDoMonte(&monte);
+        if (id == destino->id) {
+            encontrado = true;
+            break;
+        }
+        NoVertice* atual = grafo->vertices[id];
+        for (Aresta* a = atual->primeiraAresta; a != NULL; a = a->proxima) {
+            int vizinho = a->destino->id;
+            if (monte.posicao[vizinho] == FECHADO) continue;
+            double novaDistancia = distancia[id] + a->peso;
+            if (monte.posicao[vizinho] == FORA_DO_MONTE || novaDistancia < distancia[vizinho]) {
+                distancia[vizinho] = novaDistancia;
+                anterior[vizinho] = id;
+                double estimativa = heuristica ? distanciaVertices(a->destino, destino, METRICA_EUCLIDIANA) : 0.0;
+                colocarNoMonte(&monte, vizinho, novaDistancia + estimativa);
+            }
+        }
+    }
+
+    if (encontrado) {
+        int tamanho = 1;
+        for (int id = destino->id; id != origem->id; id = anterior[id]) tamanho++;
+        *caminho = (NoVertice**)malloc(tamanho * sizeof(NoVertice*));
+        if (*caminho == NULL) {
+            encontrado = false;
+        }
+        else {
+            int k = tamanho;
+            for (int id = destino->id; ; id = anterior[id]) {
+                (*caminho)[--k] = grafo->vertices[id];
+                if (id == origem->id) break;
+            }
+            *tamanhoCaminho = tamanho;
+            if (custo != NULL) *custo = distancia[destino->id];
+        }
+    }
+    free(distancia);
+    free(anterior);
+    free(monte.ids);
+    free(monte.posicao);
+    free(monte.chave);
+    return encontrado;
+}
+
+/**
+ * @brief Caminho de custo minimo entre dois vertices (Dijkstra)
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total (pode ser NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+bool caminhoMaisBarato(Grafo* grafo, NoVertice* origem, NoVertice* destino, NoVertice*** caminho, int* tamanhoCaminho, double* custo) {
+    return pesquisarCustoMinimo(grafo, origem, destino, false, caminho, tamanhoCaminho, custo);
+}
+
+/**
+ * @brief Caminho de custo minimo entre dois vertices (A* com a distancia em linha reta como heuristica)
+ * A heuristica so e usada com as metricas euclidiana e Manhattan, onde nunca sobrestima o custo;
+ * com pesos unitarios a pesquisa e igual ao Dijkstra
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total (pode ser NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+bool caminhoMaisBaratoAEstrela(Grafo* grafo, NoVertice* origem, NoVertice* destino, NoVertice*** caminho, int* tamanhoCaminho, double* custo) {
+    return pesquisarCustoMinimo(grafo, origem, destino, true, caminho, tamanhoCaminho, custo);
+}
+
+/**
+ * @brief Expande um nivel completo de um dos lados da pesquisa bidirecional
+ * @param grafo Apontador para o grafo
+ * @param fila Fila do lado a expandir (ids); o nivel atual ocupa [*inicio, *fim)
+ * @param inicio Apontador para o inicio do nivel atual
+ * @param fim Apontador para o fim do nivel atual (e da fila)
+ * @param nivel Nivel (+1) de cada id deste lado, 0 se nao visitado
+ * @param pai Predecessor de cada id deste lado
+ * @param nivelOutro Nivel (+1) de cada id no outro lado
+ * @param encontro Apontador para o id onde os dois lados se encontram com menor total
+ * @param melhor Apontador para o menor numero de saltos encontrado
+ */
+static void expandirNivel(Grafo* grafo, int* fila, int* inicio, int* fim, int* nivel, int* pai,
+    const int* nivelOutro, int* encontro, int* melhor) {
+    int fimNivel = *fim;
+    for (int k = *inicio; k < fimNivel; k++) {
+        int id = fila[k];
+        for (Aresta* a = grafo->vertices[id]->primeiraAresta; a != NULL; a = a->proxima) {
+            int vizinho = a->destino->id;
+            if (nivel[vizinho] != 0) continue;
+            nivel[vizinho] = nivel[id] + 1;
+            pai[vizinho] = id;
+            fila[(*fim)++] = vizinho;
+            if (nivelOutro[vizinho] != 0) {
+                int total = (nivel[vizinho] - 1) + (nivelOutro[vizinho] - 1);
+                if (*melhor < 0 || total < *melhor) {
+                    *melhor = total;
+                    *encontro = vizinho;
+                }
+            }
+        }
+    }
+    *inicio = fimNivel;
+}
+
+/**
+ * @brief Caminho com o menor numero de saltos entre dois vertices, pesquisando a partir dos dois extremos
+ * Em cada passo e expandido um nivel completo do lado com a fronteira mais pequena e a pesquisa
+ * para no primeiro nivel em que os dois lados se tocam. Assume arestas nos dois sentidos,
+ * como as criadas por carregarDadosGrafo.
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param saltos Apontador para o numero de arestas do caminho
+ * @param caminho Array alocado com o caminho da origem ao destino (pode ser NULL se so interessar o numero de saltos)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho (pode ser NULL com caminho NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+bool caminhoMenosSaltos(Grafo* grafo, NoVertice* origem, NoVertice* destino, int* saltos, NoVertice*** caminho, int* tamanhoCaminho) {
+    if (grafo == NULL || origem == NULL || destino == NULL || saltos == NULL) return false;
+    if (caminho != NULL && tamanhoCaminho == NULL) return false;
+    if (caminho != NULL) *caminho = NULL;
+    if (tamanhoCaminho != NULL) *tamanhoCaminho = 0;
+    if (!mesmoComponente(grafo, origem, destino)) return false;
+
+    int n = grafo->limiteIds;
+    int* nivelO = (int*)calloc(n, sizeof(int));
+    int* nivelD = (int*)calloc(n, sizeof(int));
+    int* paiO = (int*)malloc(n * sizeof(int));
+    int* paiD = (int*)malloc(n * sizeof(int));
+    int* filaO = (int*)malloc(n * sizeof(int));
+    int* filaD = (int*)malloc(n * sizeof(int));
+    if (nivelO == NULL || nivelD == NULL || paiO == NULL || paiD == NULL || filaO == NULL || filaD == NULL) {
+        free(nivelO);
+        free(nivelD);
+        free(paiO);
+        free(paiD);
+        free(filaO);
+        free(filaD);
+        return false;
+    }
+
+    int inicioO = 0, fimO = 0, inicioD = 0, fimD = 0;
+    int encontro = -1;
+    int melhor = -1;
+    nivelO[origem->id] = 1;
+    paiO[origem->id] = -1;
+    filaO[fimO++] = origem->id;
+    nivelD[destino->id] = 1;
+    paiD[destino->id] = -1;
+    filaD[fimD++] = destino->id;
+    if (origem == destino) {
+        encontro = origem->id;
+        melhor = 0;
+    }
+    while (melhor < 0 && inicioO < fimO && inicioD < fimD) {
+        if (fimO - inicioO <= fimD - inicioD) expandirNivel(grafo, filaO, &inicioO, &fimO, nivelO, paiO, nivelD, &encontro, &melhor);
+        else expandirNivel(grafo, filaD, &inicioD, &fimD, nivelD, paiD, nivelO, &encontro, &melhor);
+    }
+
+    bool encontrado = melhor >= 0;
+    if (encontrado) {
+        *saltos = melhor;
+        if (caminho != NULL) {
+            *caminho = (NoVertice**)malloc((melhor + 1) * sizeof(NoVertice*));
+            if (*caminho == NULL) {
+                encontrado = false;
+            }
+            else {
+                // metade da origem ate ao encontro (invertida) e metade do encontro ate ao destino
+                int k = nivelO[encontro] - 1;
+                for (int id = encontro; id >= 0; id = paiO[id]) (*caminho)[k--] = grafo->vertices[id];
+                k = nivelO[encontro];
+                for (int id = paiD[encontro]; id >= 0; id = paiD[id]) (*caminho)[k++] = grafo->vertices[id];
+                *tamanhoCaminho = melhor + 1;
+            }
+        }
+    }
+    free(nivelO);
+    free(nivelD);
+    free(paiO);
+    free(paiD);
+    free(filaO);
+    free(filaD);
+    return encontrado;
+}
+
+/**
+ * @brief Distancias em saltos de varias origens para todos os vertices, numa unica passagem por lote
+ * As origens sao processadas em lotes de 64: cada vertice guarda uma mascara de 64 bits com as
+ * origens que ja o alcancaram e a fronteira de cada nivel propaga-se pelas arestas com operacoes
+ * de bits, de modo que cada aresta e percorrida uma vez por nivel para todo o lote.
+ * @param grafo Apontador para o grafo
+ * @param origens Array com os vertices de origem
+ * @param numOrigens Numero de origens
+ * @param distancias Matriz numOrigens x grafo->limiteIds (linha i = origem i, coluna = id do vertice)
+ * preenchida com o numero de saltos ou -1 se o vertice nao for alcancado
+ * @return true se as distancias foram calculadas, false caso contrario
+ */
+bool distanciasMultiplasOrigens(Grafo* grafo, NoVertice** origens, int numOrigens, int* distancias) {
+    if (grafo == NULL || origens == NULL || distancias == NULL || numOrigens < 0) return false;
+    int n = grafo->limiteIds;
+    for (long long i = 0; i < (long long)numOrigens * n; i++) distancias[i] = -1;
+    if (n == 0 || numOrigens == 0) return true;
+
+    unsigned long long* visto = (unsigned long long*)malloc(n * sizeof(unsigned long long));
+    unsigned long long* fronteira = (unsigned long long*)malloc(n * sizeof(unsigned long long));
+    unsigned long long* seguinte = (unsigned long long*)malloc(n * sizeof(unsigned long long));
+    int* ativos = (int*)malloc(n * sizeof(int));
+    int* novosAtivos = (int*)malloc(n * sizeof(int));
+    if (visto == NULL || fronteira == NULL || seguinte == NULL || ativos == NULL || novosAtivos == NULL) {
+        free(visto);
+        free(fronteira);
+        free(seguinte);
+        free(ativos);
+        free(novosAtivos);
+        return false;
+    }
+
+    for (int lote = 0; lote < numOrigens; lote += 64) {
+        int tamanhoLote = numOrigens - lote < 64 ? numOrigens - lote : 64;
+        for (int i = 0; i < n; i++) {
+            visto[i] = 0;
+            fronteira[i] = 0;
+            seguinte[i] = 0;
+        }
+        int numAtivos = 0;
+        for (int b = 0; b < tamanhoLote; b++) {
+            NoVertice* origem = origens[lote + b];
+            if (origem == NULL || origem->id < 0 || origem->id >= n || grafo->vertices[origem->id] != origem) continue;
+            int id = origem->id;
+            if (fronteira[id] == 0) ativos[numAtivos++] = id;
+            fronteira[id] |= 1ULL << b;
+            visto[id] |= 1ULL << b;
+            distancias[(long long)(lote + b) * n + id] = 0;
+        }
+
+        for (int nivel = 1; numAtivos > 0; nivel++) {
+            int numNovos = 0;
+            for (int k = 0; k < numAtivos; k++) {
+                int id = ativos[k];
+                unsigned long long bits = fronteira[id];
+                for (Aresta* a = grafo->vertices[id]->primeiraAresta; a != NULL; a = a->proxima) {
+                    int vizinho = a->destino->id;
+                    unsigned long long novos = bits & ~visto[vizinho];
+                    if (novos == 0) continue;
+                    if (seguinte[vizinho] == 0) novosAtivos[numNovos++] = vizinho;
+                    seguinte[vizinho] |= novos;
+                    visto[vizinho] |= novos;
+                }
+                fronteira[id] = 0;
+            }
+            // regista a distancia de cada origem que chegou pela primeira vez a cada vertice
+            for (int k = 0; k < numNovos; k++) {
+                int id = novosAtivos[k];
+                unsigned long long bits = seguinte[id];
+                fronteira[id] = bits;
+                seguinte[id] = 0;
+                while (bits != 0) {
+                    int b = 0;
+                    while (((bits >> b) & 1ULL) == 0) b++;
+                    bits &= bits - 1;
+                    distancias[(long long)(lote + b) * n + id] = nivel;
+                }
+                ativos[k] = id;
+            }
+            numAtivos = numNovos;
+        }
+    }
+
+    free(visto);
+    free(fronteira);
+    free(seguinte);
+    free(ativos);
+    free(novosAtivos);
+    return true;
+}
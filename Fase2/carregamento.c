@@ -0,0 +1,398 @@
+/**
+ * @file carregamento.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Carregamento paralelo do mapa de antenas
+ * @details O ficheiro e lido em trechos de tamanho fixo que terminam em fim de linha. Uma thread
+ * leitora enche um de dois buffers enquanto o outro e interpretado, por isso a leitura do disco
+ * sobrepoe-se a interpretacao. Cada trecho e dividido em blocos que tambem terminam em fim de linha. Cada thread conta as linhas
+ * do seu bloco (para saber o y inicial) e depois interpreta-o para um array proprio de antenas.
+ * A fusao atribui os ids pela ordem do ficheiro e preenche os grupos de frequencia; por fim as
+ * arestas de cada vertice sao criadas em paralelo, cada thread escrevendo apenas nas listas dos
+ * vertices que lhe cabem. O numero de threads e passado a cada regiao (clausula num_threads).
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "grafo.h"
+#include "struct.h"
+#include "estatisticas.h"
+
+#define CARREGAMENTO_TRECHO ((size_t)16 << 20) // bytes lidos do ficheiro de cada vez
+
+/**
+ * @brief Antenas encontradas por uma thread no seu bloco do ficheiro
+ */
+typedef struct BlocoAntenas {
+    size_t inicio;          // primeiro byte do bloco
+    size_t fim;             // byte seguinte ao ultimo do bloco
+    int primeiraLinha;      // y da primeira linha do bloco
+    int numLinhas;          // numero de linhas do bloco
+    Antena* antenas;        // antenas do bloco, pela ordem do ficheiro
+    int tamanho;            // numero de antenas
+    int capacidade;         // tamanho alocado do array
+    bool erro;              // falha de alocacao
+} BlocoAntenas;
+
+/**
+ * @brief Um dos dois buffers de leitura
+ */
+typedef struct TrechoLido {
+    unsigned char* texto;
+    size_t capacidade;      // tamanho alocado de texto
+    size_t tamanho;         // bytes ate ao ultimo fim de linha (ou ate ao fim do ficheiro)
+    bool ultimo;            // o trecho chega ao fim do ficheiro
+    bool pronto;            // preenchido pelo leitor e ainda nao interpretado
+} TrechoLido;
+
+/**
+ * @brief Estado partilhado entre a thread leitora e a que interpreta os trechos
+ */
+typedef struct LeitorTrechos {
+    FILE* fp;
+    TrechoLido trechos[2];  // usados alternadamente
+    unsigned char* resto;   // linha incompleta do fim do ultimo trecho lido
+    size_t capacidadeResto;
+    size_t tamanhoResto;
+    bool erro;              // falha de leitura ou de alocacao no leitor
+    bool cancelado;         // quem interpreta desistiu, o leitor deve terminar
+    mtx_t trinco;
+    cnd_t mudou;            // um trecho ficou pronto ou foi devolvido
+} LeitorTrechos;
+
+/**
+ * @brief Interpreta um bloco do ficheiro, com as mesmas regras de carregarDadosGrafo
+ * @param texto Conteudo do ficheiro
+ * @param bloco Bloco a interpretar
+ */
+static void interpretarBloco(const unsigned char* texto, BlocoAntenas* bloco) {
+    int y = bloco->primeiraLinha;
+    int x = 0;
+    for (size_t i = bloco->inicio; i < bloco->fim; i++) {
+        char c = (char)texto[i];
+        if (c == '\n') {
+            y++;
+            x = 0;
+            continue;
+        }
+        if (c != '.' && c != ' ' && c != '\r') {
+            if (bloco->tamanho == bloco->capacidade) {
+                int novaCapacidade = bloco->capacidade > 0 ? bloco->capacidade * 2 : 64;
+                Antena* novas = (Antena*)realloc(bloco->antenas, novaCapacidade * sizeof(Antena));
+                if (novas == NULL) {
+                    bloco->erro = true;
+                    return;
+                }
+                bloco->antenas = novas;
+                bloco->capacidade = novaCapacidade;
+            }
+            Antena antena = { c, {x, y} };
+            bloco->antenas[bloco->tamanho++] = antena;
+        }
+        x++;
+    }
+}
+
+/**
+ * @brief Cria em paralelo as arestas entre antenas da mesma frequencia
+ * Cada vertice recebe as arestas para todos os outros membros do seu grupo; a aresta u->v
+ * fica na posicao deslocamento[u] + indice de v no grupo (sem u), para que a gemea seja
+ * encontrada diretamente na segunda passagem.
+ * @param grafo Apontador para o grafo (recem carregado, com ids 0..numVertices-1)
+ * @param numThreads Numero de threads a usar
+ * @return true se as arestas foram criadas, false em caso de erro de alocacao
+ */
+static bool construirArestasParalelo(Grafo* grafo, int numThreads) {
+#ifndef _OPENMP
+    (void)numThreads;
+#endif
+    int n = grafo->numVertices;
+    long long* deslocamento = (long long*)malloc((n + 1) * sizeof(long long));
+    if (deslocamento == NULL) return false;
+    long long total = 0;
+    for (int v = 0; v < n; v++) {
+        deslocamento[v] = total;
+        total += grafo->frequencias[(unsigned char)grafo->vertices[v]->dados.frequencia].tamanho - 1;
+    }
+    deslocamento[n] = total;
+    if (total > 0x7FFFFFFF) {
+        free(deslocamento);
+        return false;
+    }
+    Aresta** arestas = (Aresta**)malloc((total > 0 ? (size_t)total : 1) * sizeof(Aresta*));
+    if (arestas == NULL) {
+        free(deslocamento);
+        return false;
+    }
+    bool erro = false;
+
+    #pragma omp parallel for schedule(dynamic, 64) num_threads(numThreads)
+    for (int v = 0; v < n; v++) {
+        NoVertice* origem = grafo->vertices[v];
+        GrupoFrequencia* grupo = &grafo->frequencias[(unsigned char)origem->dados.frequencia];
+        // percorre o grupo ao contrario para a lista ficar pela ordem do grupo
+        for (int j = grupo->tamanho - 1; j >= 0; j--) {
+            if (j == origem->posicaoGrupo) continue;
+            Aresta* a = (Aresta*)malloc(sizeof(Aresta));
+            int k = j < origem->posicaoGrupo ? j : j - 1;
+            arestas[deslocamento[v] + k] = a;
+            if (a == NULL) {
+                #pragma omp atomic write
+                erro = true;
+                continue;
+            }
+            ESTAT_ALOCACAO(ESTAT_ARESTA, sizeof(Aresta));
+            a->destino = grupo->membros[j];
+            a->peso = distanciaVertices(origem, a->destino, grafo->metrica);
+            a->gemea = NULL;
+            a->anterior = NULL;
+            a->proxima = origem->primeiraAresta;
+            if (origem->primeiraAresta != NULL) origem->primeiraAresta->anterior = a;
+            origem->primeiraAresta = a;
+        }
+        origem->grauEntrada = grupo->tamanho - 1;
+    }
+
+    if (!erro) {
+        #pragma omp parallel for schedule(dynamic, 64) num_threads(numThreads)
+        for (int v = 0; v < n; v++) {
+            NoVertice* origem = grafo->vertices[v];
+            int i = origem->posicaoGrupo;
+            for (long long s = deslocamento[v]; s < deslocamento[v + 1]; s++) {
+                NoVertice* destino = arestas[s]->destino;
+                int k = i < destino->posicaoGrupo ? i : i - 1;
+                arestas[s]->gemea = arestas[deslocamento[destino->id] + k];
+            }
+        }
+    }
+    free(arestas);
+    free(deslocamento);
+    grafo->numArestas += (int)total;
+    grafo->geracao++;
+    // o union-find e reconstruido na primeira consulta em vez de ser atualizado aresta a aresta
+    grafo->componentesDesatualizados = true;
+    return !erro;
+}
+
+/**
+ * @brief Interpreta em paralelo um trecho do ficheiro que termina num fim de linha (ou no fim do
+ * ficheiro) e acrescenta as antenas ao grafo pela ordem do ficheiro
+ * @param grafo Apontador para o grafo
+ * @param texto Trecho do ficheiro
+ * @param tamanho Numero de bytes do trecho
+ * @param primeiraLinha y da primeira linha do trecho
+ * @param numThreads Numero de threads a usar
+ * @param numLinhas Apontador para o numero de fins de linha do trecho
+ * @return true se o trecho foi interpretado, false em caso de erro de alocacao
+ */
+static bool interpretarTrecho(Grafo* grafo, const unsigned char* texto, size_t tamanho, int primeiraLinha, int numThreads, int* numLinhas) {
+    // blocos pequenos nao compensam o arranque das threads
+    int numBlocos = numThreads;
+    if ((size_t)numBlocos > tamanho / 4096 + 1) numBlocos = (int)(tamanho / 4096 + 1);
+    BlocoAntenas* blocos = (BlocoAntenas*)calloc(numBlocos, sizeof(BlocoAntenas));
+    if (blocos == NULL) return false;
+
+    // cada bloco termina logo a seguir a um fim de linha
+    size_t inicio = 0;
+    for (int b = 0; b < numBlocos; b++) {
+        size_t fim = (b == numBlocos - 1) ? tamanho : tamanho / numBlocos * (b + 1);
+        if (fim < inicio) fim = inicio;
+        while (fim > inicio && fim < tamanho && texto[fim - 1] != '\n') fim++;
+        blocos[b].inicio = inicio;
+        blocos[b].fim = fim;
+        inicio = fim;
+    }
+
+    #pragma omp parallel for schedule(static, 1) num_threads(numBlocos)
+    for (int b = 0; b < numBlocos; b++) {
+        int linhas = 0;
+        for (size_t i = blocos[b].inicio; i < blocos[b].fim; i++) linhas += texto[i] == '\n';
+        blocos[b].numLinhas = linhas;
+    }
+    blocos[0].primeiraLinha = primeiraLinha;
+    for (int b = 1; b < numBlocos; b++) blocos[b].primeiraLinha = blocos[b - 1].primeiraLinha + blocos[b - 1].numLinhas;
+    *numLinhas = blocos[numBlocos - 1].primeiraLinha + blocos[numBlocos - 1].numLinhas - primeiraLinha;
+
+    #pragma omp parallel for schedule(static, 1) num_threads(numBlocos)
+    for (int b = 0; b < numBlocos; b++) interpretarBloco(texto, &blocos[b]);
+
+    // fusao: os ids seguem a ordem do ficheiro e as posicoes sao unicas por construcao
+    bool valido = true;
+    for (int b = 0; b < numBlocos; b++) {
+        if (blocos[b].erro) valido = false;
+        for (int i = 0; valido && i < blocos[b].tamanho; i++) {
+            valido = anexarVertice(grafo, blocos[b].antenas[i]) != NULL;
+        }
+        free(blocos[b].antenas);
+    }
+    free(blocos);
+    return valido;
+}
+
+/**
+ * @brief Enche um trecho: a linha incompleta do trecho anterior seguida do que se le do ficheiro,
+ * cortado no ultimo fim de linha (o que sobra passa para o resto)
+ * @param leitor Estado da leitura
+ * @param trecho Trecho a encher (livre, so o leitor lhe mexe)
+ * @return true se o trecho foi preenchido, false em caso de erro de leitura ou de alocacao
+ */
+static bool preencherTrecho(LeitorTrechos* leitor, TrechoLido* trecho) {
+    while (trecho->capacidade < leitor->tamanhoResto + 1) {
+        unsigned char* maior = trecho->capacidade <= SIZE_MAX / 2 ? (unsigned char*)realloc(trecho->texto, trecho->capacidade * 2) : NULL;
+        if (maior == NULL) return false;
+        trecho->texto = maior;
+        trecho->capacidade *= 2;
+    }
+    if (leitor->tamanhoResto > 0) memcpy(trecho->texto, leitor->resto, leitor->tamanhoResto);
+    size_t disponiveis = leitor->tamanhoResto;
+    leitor->tamanhoResto = 0;
+    for (;;) {
+        if (disponiveis == trecho->capacidade) {
+            // linha maior do que o trecho: aumenta o buffer e continua a ler
+            unsigned char* maior = trecho->capacidade <= SIZE_MAX / 2 ? (unsigned char*)realloc(trecho->texto, trecho->capacidade * 2) : NULL;
+            if (maior == NULL) return false;
+            trecho->texto = maior;
+            trecho->capacidade *= 2;
+        }
+        size_t pedidos = trecho->capacidade - disponiveis;
+        size_t lidos = fread(trecho->texto + disponiveis, 1, pedidos, leitor->fp);
+        disponiveis += lidos;
+        if (lidos < pedidos) {
+            if (ferror(leitor->fp)) return false;
+            trecho->tamanho = disponiveis;
+            trecho->ultimo = true;
+            return true;
+        }
+        size_t corte = disponiveis;
+        while (corte > 0 && trecho->texto[corte - 1] != '\n') corte--;
+        if (corte == 0) continue;
+        size_t sobra = disponiveis - corte;
+        if (sobra > leitor->capacidadeResto) {
+            unsigned char* resto = (unsigned char*)realloc(leitor->resto, sobra);
+            if (resto == NULL) return false;
+            leitor->resto = resto;
+            leitor->capacidadeResto = sobra;
+        }
+        if (sobra > 0) memcpy(leitor->resto, trecho->texto + corte, sobra);
+        leitor->tamanhoResto = sobra;
+        trecho->tamanho = corte;
+        trecho->ultimo = false;
+        return true;
+    }
+}
+
+/**
+ * @brief Ciclo da thread leitora: enche os dois trechos alternadamente, esperando que cada um
+ * seja devolvido antes de o voltar a encher
+ */
+static int lerTrechos(void* argumento) {
+    LeitorTrechos* leitor = (LeitorTrechos*)argumento;
+    for (int b = 0;; b ^= 1) {
+        TrechoLido* trecho = &leitor->trechos[b];
+        mtx_lock(&leitor->trinco);
+        while (trecho->pronto && !leitor->cancelado) cnd_wait(&leitor->mudou, &leitor->trinco);
+        bool cancelado = leitor->cancelado;
+        mtx_unlock(&leitor->trinco);
+        if (cancelado) return 0;
+        bool preenchido = preencherTrecho(leitor, trecho);
+        mtx_lock(&leitor->trinco);
+        if (!preenchido) leitor->erro = true;
+        trecho->pronto = true;
+        cnd_broadcast(&leitor->mudou);
+        mtx_unlock(&leitor->trinco);
+        if (!preenchido || trecho->ultimo) return 0;
+    }
+}
+
+/**
+ * @brief Carrega o mapa de antenas usando varias threads (OpenMP) para a leitura e para as arestas
+ * Produz o mesmo grafo que carregarDadosGrafo, com os ids atribuidos pela ordem do ficheiro.
+ * O ficheiro e lido por uma thread propria em trechos de CARREGAMENTO_TRECHO bytes (mais a linha
+ * incompleta do trecho anterior), alternando entre dois buffers: enquanto um trecho e interpretado
+ * o seguinte ja esta a ser lido. A memoria usada nao depende do tamanho do mapa mas so do numero
+ * de antenas
+ * @param nomeFicheiro Nome do ficheiro a ler
+ * @param numThreads Numero de threads a usar (0 para o valor por omissao do OpenMP)
+ * @return Apontador para o grafo criado ou NULL em caso de erro
+ */
+Grafo* carregarDadosGrafoParalelo(const char* nomeFicheiro, int numThreads) {
+    if (nomeFicheiro == NULL) return NULL;
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    if (fp == NULL) {
+        perror("Erro ao abrir ficheiro");
+        return NULL;
+    }
+#ifdef _OPENMP
+    // clausula num_threads em cada regiao, sem mudar o valor global do processo
+    if (numThreads <= 0) numThreads = omp_get_max_threads();
+#else
+    numThreads = 1;
+#endif
+    LeitorTrechos leitor = { 0 };
+    leitor.fp = fp;
+    for (int b = 0; b < 2; b++) {
+        leitor.trechos[b].texto = (unsigned char*)malloc(CARREGAMENTO_TRECHO);
+        leitor.trechos[b].capacidade = CARREGAMENTO_TRECHO;
+    }
+    Grafo* grafo = inicializarGrafo();
+    bool valido = leitor.trechos[0].texto != NULL && leitor.trechos[1].texto != NULL && grafo != NULL;
+    bool sincronizacao = valido && mtx_init(&leitor.trinco, mtx_plain) == thrd_success;
+    if (sincronizacao && cnd_init(&leitor.mudou) != thrd_success) {
+        mtx_destroy(&leitor.trinco);
+        sincronizacao = false;
+    }
+    thrd_t leitora;
+    bool iniciada = sincronizacao && thrd_create(&leitora, lerTrechos, &leitor) == thrd_success;
+    valido = valido && iniciada;
+
+    int linha = 0;
+    for (int b = 0; valido; b ^= 1) {
+        TrechoLido* trecho = &leitor.trechos[b];
+        mtx_lock(&leitor.trinco);
+        while (!trecho->pronto) cnd_wait(&leitor.mudou, &leitor.trinco);
+        bool erro = leitor.erro;
+        mtx_unlock(&leitor.trinco);
+        if (erro) {
+            valido = false;
+            break;
+        }
+        int numLinhas = 0;
+        if (trecho->tamanho > 0) valido = interpretarTrecho(grafo, trecho->texto, trecho->tamanho, linha, numThreads, &numLinhas);
+        linha += numLinhas;
+        bool ultimo = trecho->ultimo;
+        mtx_lock(&leitor.trinco);
+        trecho->pronto = false;
+        cnd_broadcast(&leitor.mudou);
+        mtx_unlock(&leitor.trinco);
+        if (ultimo) break;
+    }
+    if (iniciada) {
+        mtx_lock(&leitor.trinco);
+        leitor.cancelado = true;
+        cnd_broadcast(&leitor.mudou);
+        mtx_unlock(&leitor.trinco);
+        thrd_join(leitora, NULL);
+    }
+    if (sincronizacao) {
+        mtx_destroy(&leitor.trinco);
+        cnd_destroy(&leitor.mudou);
+    }
+    fclose(fp);
+    free(leitor.trechos[0].texto);
+    free(leitor.trechos[1].texto);
+    free(leitor.resto);
+    if (valido) valido = construirArestasParalelo(grafo, numThreads);
+    if (!valido) {
+        libertarGrafo(grafo);
+        return NULL;
+    }
+    return grafo;
+}
@@ -0,0 +1,959 @@
+/**
+ * @file compacto.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Representacao compacta (CSR) do grafo com reordenacao dos vertices
+ * @details Os vertices sao copiados para arrays contiguos por uma ordem escolhida para a
+ * localidade de memoria: a curva de Hilbert mantem juntas as antenas proximas no mapa e a
+ * ordem por frequencia junta os membros de cada frequencia. A adjacencia e renumerada para
+ * os novos indices e guardada como deslocamentos + destinos, ordenados em cada vertice.
+ * A adjacencia pode ainda ser comprimida: como cada linha esta ordenada, guarda-se o primeiro
+ * vizinho e as diferencas seguintes em varint (7 bits por byte), o que reduz a maior parte das
+ * arestas a um ou dois bytes. O acesso aos vizinhos faz-se sempre pelo IteradorVizinhos, que
+ * esconde o modo em uso. carregarGrafoComprimido produz o modo comprimido diretamente a partir do
+ * mapa de texto, sem passar pelo grafo de apontadores nem pelos arrays vizinhos e pesos, porque as
+ * linhas de um mapa recem lido sao os grupos de frequencia. As consultas (pesquisas, caminhos, membros de uma frequencia) so leem o
+ * grafo compacto, por isso podem correr sem bloqueios sobre um instantaneo fixado.
+ * atualizarGrafoCompacto cria a copia seguinte a partir da anterior, reconstruindo so as linhas
+ * dos vertices alterados.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "grafo.h"
+#include "struct.h"
+
+#define COMPACTO_FORA_DE_ORDEM 8 // fracao maxima (1/8) de vertices fora da ordem antes de reordenar tudo
+#define COMPACTO_TRECHO ((size_t)1 << 20) // bytes do mapa lidos de cada vez por carregarGrafoComprimido
+
+/**
+ * @brief Chave de ordenacao de um vertice
+ */
+typedef struct ChaveVertice {
+    unsigned long long chave; // chave principal (frequencia e/ou posicao na curva de Hilbert)
+    int id;                 // id no grafo de origem (desempate estavel)
+} ChaveVertice;
+
+/**
+ * @brief Compara duas chaves de vertice
+ */
+static int compararChaves(const void* a, const void* b) {
+    const ChaveVertice* c1 = (const ChaveVertice*)a;
+    const ChaveVertice* c2 = (const ChaveVertice*)b;
+    if (c1->chave != c2->chave) return c1->chave < c2->chave ? -1 : 1;
+    if (c1->id != c2->id) return c1->id < c2->id ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Compara dois inteiros (ordenacao dos vizinhos)
+ */
+static int compararInteiros(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Posicao de um ponto na curva de Hilbert que cobre uma grelha lado x lado
+ * @param lado Lado da grelha (potencia de 2)
+ * @param x Coordenada x (0..lado-1)
+ * @param y Coordenada y (0..lado-1)
+ * @return Distancia ao longo da curva
+ */
+static unsigned long long posicaoHilbert(unsigned long long lado, unsigned long long x, unsigned long long y) {
+    unsigned long long d = 0;
+    for (unsigned long long s = lado / 2; s > 0; s /= 2) {
+        unsigned long long rx = (x & s) > 0;
+        unsigned long long ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // roda o quadrante para que a curva seja continua
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            unsigned long long t = x;
+            x = y;
+            y = t;
+        }
+    }
+    return d;
+}
+
+/**
+ * @brief Liberta a memoria de um grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @return true se libertado com sucesso, false caso contrario
+ */
+bool libertarGrafoCompacto(GrafoCompacto* compacto) {
+    if (compacto == NULL) return false;
+    free(compacto->antenas);
+    free(compacto->idOriginal);
+    free(compacto->idCompacto);
+    free(compacto->deslocamentos);
+    free(compacto->vizinhos);
+    free(compacto->pesos);
+    free(compacto->adjacenciaComprimida);
+    free(compacto->inicioComprimido);
+    free(compacto->membrosFrequencia);
+    free(compacto);
+    return true;
+}
+
+/**
+ * @brief Calcula a ordem de um conjunto de antenas
+ * @param antenas Antenas a ordenar
+ * @param ids Id de cada antena, copiado para as chaves (desempate estavel)
+ * @param n Numero de antenas
+ * @param ordem Ordem pretendida
+ * @param chaves Array com n posicoes, preenchido pela nova ordem
+ */
+static void ordenarAntenas(const Antena* antenas, const int* ids, int n, OrdemVertices ordem, ChaveVertice* chaves) {
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int i = 0; i < n; i++) {
+        Coordenada p = antenas[i].posicao;
+        if (i == 0 || p.x < minX) minX = p.x;
+        if (i == 0 || p.y < minY) minY = p.y;
+        if (i == 0 || p.x > maxX) maxX = p.x;
+        if (i == 0 || p.y > maxY) maxY = p.y;
+    }
+    unsigned long long largura = (unsigned long long)((long long)maxX - minX) + 1;
+    unsigned long long altura = (unsigned long long)((long long)maxY - minY) + 1;
+    unsigned long long lado = 1;
+    while (lado < largura || lado < altura) lado *= 2;
+
+    for (int i = 0; i < n; i++) {
+        unsigned long long chave = 0;
+        if (ordem != ORDEM_IDS) {
+            chave = posicaoHilbert(lado, (unsigned long long)((long long)antenas[i].posicao.x - minX),
+                (unsigned long long)((long long)antenas[i].posicao.y - minY));
+        }
+        if (ordem == ORDEM_FREQUENCIA) {
+            // a frequencia fica nos bits mais altos; a posicao de Hilbert ocupa no maximo 64 - 8 bits
+            // quando o lado nao ultrapassa 2^28, o que cobre qualquer mapa realista
+            chave = ((unsigned long long)(unsigned char)antenas[i].frequencia << 56) | (chave & ((1ULL << 56) - 1));
+        }
+        chaves[i].chave = chave;
+        chaves[i].id = ids[i];
+    }
+    if (ordem != ORDEM_IDS && n > 1) qsort(chaves, n, sizeof(ChaveVertice), compararChaves);
+}
+
+/**
+ * @brief Aloca um grafo compacto com os arrays para os vertices e arestas atuais do grafo
+ * @param grafo Apontador para o grafo
+ * @param ordem Ordem dos vertices
+ * @return Apontador para o grafo compacto (por preencher) ou NULL em caso de erro
+ */
+static GrafoCompacto* alocarGrafoCompacto(Grafo* grafo, OrdemVertices ordem) {
+    GrafoCompacto* compacto = (GrafoCompacto*)calloc(1, sizeof(GrafoCompacto));
+    if (compacto == NULL) return NULL;
+    int n = grafo->numVertices;
+    int m = grafo->numArestas;
+    compacto->numVertices = n;
+    compacto->numArestas = m;
+    compacto->ordem = ordem;
+    compacto->metrica = grafo->metrica;
+    compacto->limiteIdsOriginal = grafo->limiteIds;
+    compacto->antenas = (Antena*)malloc((n > 0 ? n : 1) * sizeof(Antena));
+    compacto->idOriginal = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    compacto->idCompacto = (int*)malloc((grafo->limiteIds > 0 ? grafo->limiteIds : 1) * sizeof(int));
+    compacto->deslocamentos = (int*)malloc((n + 1) * sizeof(int));
+    compacto->vizinhos = (int*)malloc((m > 0 ? m : 1) * sizeof(int));
+    compacto->pesos = (double*)malloc((m > 0 ? m : 1) * sizeof(double));
+    compacto->membrosFrequencia = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (compacto->antenas == NULL || compacto->idOriginal == NULL || compacto->idCompacto == NULL ||
+        compacto->deslocamentos == NULL || compacto->vizinhos == NULL || compacto->pesos == NULL ||
+        compacto->membrosFrequencia == NULL) {
+        libertarGrafoCompacto(compacto);
+        return NULL;
+    }
+    return compacto;
+}
+
+/**
+ * @brief Constroi a linha de um vertice a partir da sua lista de adjacencia no grafo
+ * A linha e renumerada para os indices compactos e ordenada, para que os acessos avancem na
+ * memoria; os pesos dependem so das posicoes, por isso sao recalculados ja alinhados com a linha
+ * @param grafo Apontador para o grafo
+ * @param compacto Grafo compacto com idOriginal e idCompacto ja preenchidos
+ * @param i Indice compacto do vertice
+ * @param aresta Primeira posicao livre de vizinhos
+ * @return Posicao seguinte ao fim da linha ou -1 se as arestas nao couberem em numArestas
+ */
+static int construirLinha(Grafo* grafo, GrafoCompacto* compacto, int i, int aresta) {
+    NoVertice* origem = grafo->vertices[compacto->idOriginal[i]];
+    int inicio = aresta;
+    for (Aresta* a = origem->primeiraAresta; a != NULL; a = a->proxima) {
+        if (aresta == compacto->numArestas) return -1;
+        compacto->vizinhos[aresta++] = compacto->idCompacto[a->destino->id];
+    }
+    if (aresta - inicio > 1) qsort(&compacto->vizinhos[inicio], aresta - inicio, sizeof(int), compararInteiros);
+    for (int k = inicio; k < aresta; k++) {
+        compacto->pesos[k] = distanciaVertices(origem, grafo->vertices[compacto->idOriginal[compacto->vizinhos[k]]], grafo->metrica);
+    }
+    return aresta;
+}
+
+/**
+ * @brief Preenche o indice de frequencias por contagem (estavel, por isso crescente em cada grupo)
+ * @param compacto Grafo compacto com as antenas ja preenchidas
+ */
+static void indexarFrequencias(GrafoCompacto* compacto) {
+    int n = compacto->numVertices;
+    int proximaPosicao[NUM_FREQUENCIAS];
+    for (int f = 0; f <= NUM_FREQUENCIAS; f++) compacto->inicioFrequencia[f] = 0;
+    for (int i = 0; i < n; i++) compacto->inicioFrequencia[(unsigned char)compacto->antenas[i].frequencia + 1]++;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) compacto->inicioFrequencia[f + 1] += compacto->inicioFrequencia[f];
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) proximaPosicao[f] = compacto->inicioFrequencia[f];
+    for (int i = 0; i < n; i++) {
+        compacto->membrosFrequencia[proximaPosicao[(unsigned char)compacto->antenas[i].frequencia]++] = i;
+    }
+}
+
+/**
+ * @brief Congela o grafo numa representacao compacta com os vertices reordenados para localidade
+ * A adjacencia e renumerada para os novos indices; alteracoes posteriores ao grafo nao se refletem na copia
+ * @param grafo Apontador para o grafo
+ * @param ordem Ordem pretendida para os vertices
+ * @return Apontador para o grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* congelarGrafo(Grafo* grafo, OrdemVertices ordem) {
+    if (grafo == NULL) return NULL;
+    GrafoCompacto* compacto = alocarGrafoCompacto(grafo, ordem);
+    if (compacto == NULL) return NULL;
+    int n = grafo->numVertices;
+    ChaveVertice* chaves = (ChaveVertice*)malloc((n > 0 ? n : 1) * sizeof(ChaveVertice));
+    if (chaves == NULL) {
+        libertarGrafoCompacto(compacto);
+        return NULL;
+    }
+
+    // as antenas sao juntas pela ordem dos ids e depois reescritas pela nova ordem
+    int juntas = 0;
+    for (int id = 0; id < grafo->limiteIds; id++) {
+        compacto->idCompacto[id] = -1;
+        if (grafo->vertices[id] == NULL) continue;
+        compacto->antenas[juntas] = grafo->vertices[id]->dados;
+        compacto->idOriginal[juntas++] = id;
+    }
+    ordenarAntenas(compacto->antenas, compacto->idOriginal, n, ordem, chaves);
+    for (int i = 0; i < n; i++) {
+        compacto->idOriginal[i] = chaves[i].id;
+        compacto->idCompacto[chaves[i].id] = i;
+        compacto->antenas[i] = grafo->vertices[chaves[i].id]->dados;
+    }
+    free(chaves);
+
+    int aresta = 0;
+    for (int i = 0; i < n && aresta >= 0; i++) {
+        compacto->deslocamentos[i] = aresta;
+        aresta = construirLinha(grafo, compacto, i, aresta);
+    }
+    if (aresta < 0) {
+        libertarGrafoCompacto(compacto);
+        return NULL;
+    }
+    compacto->deslocamentos[n] = aresta;
+    indexarFrequencias(compacto);
+    return compacto;
+}
+
+/**
+ * @brief Cria um novo grafo compacto a partir do anterior, reconstruindo so os vertices alterados
+ * Os vertices que ja existiam mantem a ordem relativa do anterior e os novos ficam no fim, por
+ * isso a linha de um vertice nao alterado e copiada do anterior so com os indices traduzidos
+ * (continua ordenada) e os pesos copiados; as linhas dos alterados sao construidas a partir do
+ * grafo, como em congelarGrafo. Um vertice tem de ser marcado como alterado se a sua lista de
+ * adjacencia, a sua antena ou a posicao de algum vizinho mudou (incluindo ids reutilizados).
+ * Se o anterior estiver comprimido, ou se mais de 1/COMPACTO_FORA_DE_ORDEM dos vertices ficar
+ * fora da ordem pedida, faz um congelamento completo.
+ * @param grafo Apontador para o grafo
+ * @param anterior Grafo compacto anterior do mesmo grafo
+ * @param alterados Marca de cada id do grafo (os ids a partir de numAlterados contam como alterados)
+ * @param numAlterados Tamanho do array alterados
+ * @return Apontador para o novo grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* atualizarGrafoCompacto(Grafo* grafo, const GrafoCompacto* anterior, const bool* alterados, int numAlterados) {
+    if (grafo == NULL || anterior == NULL || (alterados == NULL && numAlterados > 0)) return NULL;
+    if (anterior->vizinhos == NULL) return congelarGrafo(grafo, anterior->ordem);
+    int n = grafo->numVertices;
+    int* mapa = (int*)malloc((anterior->numVertices > 0 ? anterior->numVertices : 1) * sizeof(int));
+    GrafoCompacto* compacto = mapa != NULL ? alocarGrafoCompacto(grafo, anterior->ordem) : NULL;
+    if (compacto == NULL) {
+        free(mapa);
+        return NULL;
+    }
+
+    // ordem: os que continuam, pela ordem do anterior, e depois os novos por id
+    int i = 0;
+    for (int k = 0; k < anterior->numVertices; k++) {
+        int id = anterior->idOriginal[k];
+        bool continua = id < grafo->limiteIds && grafo->vertices[id] != NULL;
+        mapa[k] = continua ? i : -1;
+        if (continua) compacto->idOriginal[i++] = id;
+    }
+    int continuam = i;
+    for (int id = 0; id < grafo->limiteIds; id++) {
+        if (grafo->vertices[id] == NULL) continue;
+        if (id < anterior->limiteIdsOriginal && anterior->idCompacto[id] >= 0) continue;
+        if (i == n) break;
+        compacto->idOriginal[i++] = id;
+    }
+    compacto->numForaDeOrdem = anterior->numForaDeOrdem + (n - continuam);
+    if (i != n || compacto->numForaDeOrdem > n / COMPACTO_FORA_DE_ORDEM) {
+        free(mapa);
+        libertarGrafoCompacto(compacto);
+        return congelarGrafo(grafo, anterior->ordem);
+    }
+    for (int id = 0; id < grafo->limiteIds; id++) compacto->idCompacto[id] = -1;
+    for (i = 0; i < n; i++) {
+        compacto->idCompacto[compacto->idOriginal[i]] = i;
+        compacto->antenas[i] = grafo->vertices[compacto->idOriginal[i]]->dados;
+    }
+
+    int aresta = 0;
+    for (i = 0; i < n && aresta >= 0; i++) {
+        compacto->deslocamentos[i] = aresta;
+        int id = compacto->idOriginal[i];
+        int k = i < continuam ? anterior->idCompacto[id] : -1;
+        if (k < 0 || id >= numAlterados || alterados[id]) {
+            aresta = construirLinha(grafo, compacto, i, aresta);
+            continue;
+        }
+        int grau = anterior->deslocamentos[k + 1] - anterior->deslocamentos[k];
+        if (grau > compacto->numArestas - aresta) {
+            aresta = -1;
+            break;
+        }
+        const int* linha = &anterior->vizinhos[anterior->deslocamentos[k]];
+        for (int j = 0; j < grau && aresta >= 0; j++) {
+            int destino = mapa[linha[j]];
+            if (destino < 0) aresta = -1; // vizinho removido num vertice nao marcado
+            else compacto->vizinhos[aresta + j] = destino;
+        }
+        if (aresta < 0) break;
+        memcpy(&compacto->pesos[aresta], &anterior->pesos[anterior->deslocamentos[k]], grau * sizeof(double));
+        aresta += grau;
+    }
+    free(mapa);
+    if (aresta != compacto->numArestas) {
+        // marcas incompletas: as linhas copiadas nao batem certo com o grafo
+        libertarGrafoCompacto(compacto);
+        return congelarGrafo(grafo, anterior->ordem);
+    }
+    compacto->deslocamentos[n] = aresta;
+    indexarFrequencias(compacto);
+    return compacto;
+}
+
+/**
+ * @brief Numero de bytes necessarios para codificar um valor em varint
+ */
+static unsigned int tamanhoVarint(unsigned int valor) {
+    unsigned int bytes = 1;
+    while (valor >= 0x80) {
+        valor >>= 7;
+        bytes++;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Codifica um valor em varint
+ * @param destino Buffer onde escrever
+ * @param valor Valor a codificar
+ * @return Numero de bytes escritos
+ */
+static unsigned int escreverVarint(unsigned char* destino, unsigned int valor) {
+    unsigned int bytes = 0;
+    while (valor >= 0x80) {
+        destino[bytes++] = (unsigned char)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[bytes++] = (unsigned char)valor;
+    return bytes;
+}
+
+/**
+ * @brief Comprime a adjacencia do grafo compacto (diferencas entre vizinhos ordenados em varint)
+ * Os arrays vizinhos e pesos sao libertados; os pesos passam a ser calculados a partir das posicoes
+ * @param compacto Apontador para o grafo compacto
+ * @return true se comprimido (ou ja estava), false em caso de erro
+ */
+bool comprimirAdjacencia(GrafoCompacto* compacto) {
+    if (compacto == NULL) return false;
+    if (compacto->adjacenciaComprimida != NULL) return true;
+    int n = compacto->numVertices;
+    // primeira passagem so para medir, para alocar o buffer exato
+    size_t total = 0;
+    for (int v = 0; v < n; v++) {
+        int anterior = 0;
+        for (int k = compacto->deslocamentos[v]; k < compacto->deslocamentos[v + 1]; k++) {
+            total += tamanhoVarint((unsigned int)(compacto->vizinhos[k] - anterior));
+            anterior = compacto->vizinhos[k];
+        }
+    }
+    if (total > 0xFFFFFFFFu) return false;
+    unsigned char* bytes = (unsigned char*)malloc(total > 0 ? total : 1);
+    unsigned int* inicio = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+    if (bytes == NULL || inicio == NULL) {
+        free(bytes);
+        free(inicio);
+        return false;
+    }
+    unsigned int posicao = 0;
+    for (int v = 0; v < n; v++) {
+        inicio[v] = posicao;
+        int anterior = 0;
+        for (int k = compacto->deslocamentos[v]; k < compacto->deslocamentos[v + 1]; k++) {
+            posicao += escreverVarint(&bytes[posicao], (unsigned int)(compacto->vizinhos[k] - anterior));
+            anterior = compacto->vizinhos[k];
+        }
+    }
+    inicio[n] = posicao;
+
+    compacto->adjacenciaComprimida = bytes;
+    compacto->inicioComprimido = inicio;
+    free(compacto->vizinhos);
+    free(compacto->pesos);
+    compacto->vizinhos = NULL;
+    compacto->pesos = NULL;
+    return true;
+}
+
+/**
+ * @brief Le as antenas de um mapa de texto, com as mesmas regras de carregarDadosGrafoParalelo
+ * O ficheiro e lido em trechos de COMPACTO_TRECHO bytes; so as antenas ficam em memoria
+ * @param fp Ficheiro aberto
+ * @param antenas Apontador para o array criado, pela ordem do ficheiro (a ordem dos ids)
+ * @param numAntenas Apontador para o numero de antenas lidas
+ * @return true se lido com sucesso, false em caso de erro
+ */
+static bool lerAntenasMapa(FILE* fp, Antena** antenas, int* numAntenas) {
+    unsigned char* texto = (unsigned char*)malloc(COMPACTO_TRECHO);
+    Antena* lidas = (Antena*)malloc(64 * sizeof(Antena));
+    int tamanho = 0;
+    int capacidade = 64;
+    int x = 0;
+    int y = 0;
+    bool valido = texto != NULL && lidas != NULL;
+    size_t lidos;
+    while (valido && (lidos = fread(texto, 1, COMPACTO_TRECHO, fp)) > 0) {
+        for (size_t i = 0; i < lidos; i++) {
+            char c = (char)texto[i];
+            if (c == '\n') {
+                y++;
+                x = 0;
+                continue;
+            }
+            if (c != '.' && c != ' ' && c != '\r') {
+                if (tamanho == capacidade) {
+                    Antena* novas = capacidade <= INT_MAX / 2 ? (Antena*)realloc(lidas, (size_t)capacidade * 2 * sizeof(Antena)) : NULL;
+                    if (novas == NULL) {
+                        valido = false;
+                        break;
+                    }
+                    lidas = novas;
+                    capacidade *= 2;
+                }
+                Antena antena = { c, {x, y} };
+                lidas[tamanho++] = antena;
+            }
+            x++;
+        }
+    }
+    if (ferror(fp)) valido = false;
+    free(texto);
+    if (!valido) {
+        free(lidas);
+        return false;
+    }
+    *antenas = lidas;
+    *numAntenas = tamanho;
+    return true;
+}
+
+/**
+ * @brief Codifica em varint a linha de um vertice cujos vizinhos sao os outros membros da sua frequencia
+ * Os membros ja estao por ordem crescente, por isso a linha sai ordenada sem passar por um array de destinos
+ * @param compacto Grafo compacto com o indice de frequencias preenchido
+ * @param v Indice compacto do vertice
+ * @param destino Buffer onde escrever ou NULL para so medir
+ * @return Numero de bytes da linha
+ */
+static size_t codificarLinhaGrupo(const GrafoCompacto* compacto, int v, unsigned char* destino) {
+    int f = (unsigned char)compacto->antenas[v].frequencia;
+    size_t bytes = 0;
+    int anterior = 0;
+    for (int k = compacto->inicioFrequencia[f]; k < compacto->inicioFrequencia[f + 1]; k++) {
+        int w = compacto->membrosFrequencia[k];
+        if (w == v) continue;
+        if (destino != NULL) bytes += escreverVarint(&destino[bytes], (unsigned int)(w - anterior));
+        else bytes += tamanhoVarint((unsigned int)(w - anterior));
+        anterior = w;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Constroi o grafo compacto ja comprimido diretamente a partir de um mapa de texto
+ * Produz a mesma adjacencia que carregarDadosGrafoParalelo seguido de congelarGrafo e
+ * comprimirAdjacencia (ids pela ordem do ficheiro, cada antena ligada a todas as outras da sua
+ * frequencia), mas sem criar o grafo de apontadores nem os arrays vizinhos/pesos: as linhas sao
+ * codificadas a partir dos grupos de frequencia. O grafo resultante nao tem deslocamentos.
+ * @param nomeFicheiro Nome do ficheiro a ler
+ * @param ordem Ordem pretendida para os vertices
+ * @param metrica Metrica dos pesos
+ * @return Apontador para o grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* carregarGrafoComprimido(const char* nomeFicheiro, OrdemVertices ordem, MetricaPeso metrica) {
+    if (nomeFicheiro == NULL) return NULL;
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    if (fp == NULL) {
+        perror("Erro ao abrir ficheiro");
+        return NULL;
+    }
+    Antena* lidas = NULL;
+    int n = 0;
+    bool valido = lerAntenasMapa(fp, &lidas, &n);
+    fclose(fp);
+    if (!valido) return NULL;
+
+    GrafoCompacto* compacto = (GrafoCompacto*)calloc(1, sizeof(GrafoCompacto));
+    ChaveVertice* chaves = (ChaveVertice*)malloc((n > 0 ? n : 1) * sizeof(ChaveVertice));
+    if (compacto != NULL) {
+        compacto->numVertices = n;
+        compacto->ordem = ordem;
+        compacto->metrica = metrica;
+        compacto->limiteIdsOriginal = n;
+        compacto->antenas = (Antena*)malloc((n > 0 ? n : 1) * sizeof(Antena));
+        compacto->idOriginal = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+        compacto->idCompacto = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+        compacto->membrosFrequencia = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+        compacto->inicioComprimido = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+    }
+    if (compacto == NULL || chaves == NULL || compacto->antenas == NULL || compacto->idOriginal == NULL ||
+        compacto->idCompacto == NULL || compacto->membrosFrequencia == NULL || compacto->inicioComprimido == NULL) {
+        free(lidas);
+        free(chaves);
+        libertarGrafoCompacto(compacto);
+        return NULL;
+    }
+
+    for (int i = 0; i < n; i++) compacto->idOriginal[i] = i;
+    ordenarAntenas(lidas, compacto->idOriginal, n, ordem, chaves);
+    for (int i = 0; i < n; i++) {
+        compacto->idOriginal[i] = chaves[i].id;
+        compacto->idCompacto[chaves[i].id] = i;
+        compacto->antenas[i] = lidas[chaves[i].id];
+    }
+    free(lidas);
+    free(chaves);
+    indexarFrequencias(compacto);
+
+    // primeira passagem so para medir, como em comprimirAdjacencia
+    long long arestas = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        long long membros = compacto->inicioFrequencia[f + 1] - compacto->inicioFrequencia[f];
+        arestas += membros * (membros - 1);
+    }
+    size_t total = 0;
+    for (int v = 0; v < n; v++) total += codificarLinhaGrupo(compacto, v, NULL);
+    if (arestas > INT_MAX || total > 0xFFFFFFFFu) {
+        libertarGrafoCompacto(compacto);
+        return NULL;
+    }
+    compacto->numArestas = (int)arestas;
+    compacto->adjacenciaComprimida = (unsigned char*)malloc(total > 0 ? total : 1);
+    if (compacto->adjacenciaComprimida == NULL) {
+        libertarGrafoCompacto(compacto);
+        return NULL;
+    }
+    unsigned int posicao = 0;
+    for (int v = 0; v < n; v++) {
+        compacto->inicioComprimido[v] = posicao;
+        posicao += (unsigned int)codificarLinhaGrupo(compacto, v, &compacto->adjacenciaComprimida[posicao]);
+    }
+    compacto->inicioComprimido[n] = posicao;
+    return compacto;
+}
+
+/**
+ * @brief Memoria ocupada pelo grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @return Numero de bytes alocados ou 0 se o grafo for NULL
+ */
+size_t memoriaGrafoCompacto(GrafoCompacto* compacto) {
+    if (compacto == NULL) return 0;
+    size_t n = (size_t)compacto->numVertices;
+    size_t bytes = sizeof(GrafoCompacto);
+    bytes += n * (sizeof(Antena) + sizeof(int) + sizeof(int)); // antenas, idOriginal, membrosFrequencia
+    bytes += (size_t)compacto->limiteIdsOriginal * sizeof(int);
+    if (compacto->deslocamentos != NULL) bytes += (n + 1) * sizeof(int);
+    if (compacto->adjacenciaComprimida != NULL) {
+        bytes += (n + 1) * sizeof(unsigned int) + compacto->inicioComprimido[n];
+    }
+    else {
+        bytes += (size_t)compacto->numArestas * (sizeof(int) + sizeof(double));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Inicia um iterador sobre os vizinhos de um vertice do grafo compacto
+ * @param iterador Apontador para o iterador
+ * @param compacto Apontador para o grafo compacto
+ * @param vertice Indice compacto do vertice
+ * @return true se o iterador foi iniciado, false caso contrario
+ */
+bool iniciarIteradorVizinhos(IteradorVizinhos* iterador, const GrafoCompacto* compacto, int vertice) {
+    if (iterador == NULL || compacto == NULL || vertice < 0 || vertice >= compacto->numVertices) return false;
+    iterador->compacto = compacto;
+    iterador->anterior = 0;
+    if (compacto->adjacenciaComprimida != NULL) {
+        iterador->posicao = compacto->inicioComprimido[vertice];
+        iterador->fim = compacto->inicioComprimido[vertice + 1];
+    }
+    else {
+        iterador->posicao = (unsigned int)compacto->deslocamentos[vertice];
+        iterador->fim = (unsigned int)compacto->deslocamentos[vertice + 1];
+    }
+    return true;
+}
+
+/**
+ * @brief Devolve o vizinho seguinte, por ordem crescente de indice
+ * @param iterador Apontador para o iterador
+ * @return Indice compacto do vizinho ou -1 quando nao houver mais
+ */
+int proximoVizinho(IteradorVizinhos* iterador) {
+    if (iterador == NULL || iterador->posicao >= iterador->fim) return -1;
+    const GrafoCompacto* compacto = iterador->compacto;
+    if (compacto->adjacenciaComprimida == NULL) return compacto->vizinhos[iterador->posicao++];
+    unsigned int delta = 0;
+    int deslocamento = 0;
+    unsigned char byte;
+    do {
+        byte = compacto->adjacenciaComprimida[iterador->posicao++];
+        delta |= (unsigned int)(byte & 0x7F) << deslocamento;
+        deslocamento += 7;
+    } while ((byte & 0x80) != 0);
+    iterador->anterior += (int)delta;
+    return iterador->anterior;
+}
+
+/**
+ * @brief Verifica se existe aresta entre dois vertices do grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @return true se a aresta existir, false caso contrario
+ */
+bool existeArestaCompacta(const GrafoCompacto* compacto, int origem, int destino) {
+    if (compacto == NULL || destino < 0 || destino >= compacto->numVertices) return false;
+    if (compacto->adjacenciaComprimida == NULL) {
+        if (origem < 0 || origem >= compacto->numVertices) return false;
+        // linha ordenada: pesquisa binaria
+        int inicio = compacto->deslocamentos[origem];
+        int fim = compacto->deslocamentos[origem + 1] - 1;
+        while (inicio <= fim) {
+            int meio = inicio + (fim - inicio) / 2;
+            if (compacto->vizinhos[meio] == destino) return true;
+            if (compacto->vizinhos[meio] < destino) inicio = meio + 1;
+            else fim = meio - 1;
+        }
+        return false;
+    }
+    IteradorVizinhos iterador;
+    if (!iniciarIteradorVizinhos(&iterador, compacto, origem)) return false;
+    int vizinho;
+    while ((vizinho = proximoVizinho(&iterador)) >= 0) {
+        if (vizinho == destino) return true;
+        if (vizinho > destino) break; // ordenado: ja passou
+    }
+    return false;
+}
+
+/**
+ * @brief Distancia entre dois vertices do grafo compacto, segundo a metrica do grafo de origem
+ */
+static double distanciaCompacta(const GrafoCompacto* compacto, int origem, int destino) {
+    double dx = (double)compacto->antenas[origem].posicao.x - compacto->antenas[destino].posicao.x;
+    double dy = (double)compacto->antenas[origem].posicao.y - compacto->antenas[destino].posicao.y;
+    switch (compacto->metrica) {
+    case METRICA_EUCLIDIANA: return sqrt(dx * dx + dy * dy);
+    case METRICA_MANHATTAN: return fabs(dx) + fabs(dy);
+    default: return 1.0;
+    }
+}
+
+/**
+ * @brief Peso da aresta entre dois vertices do grafo compacto, segundo a metrica do grafo de origem
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @return Peso da aresta ou -1 se nao existir
+ */
+double pesoArestaCompacta(const GrafoCompacto* compacto, int origem, int destino) {
+    if (!existeArestaCompacta(compacto, origem, destino)) return -1;
+    return distanciaCompacta(compacto, origem, destino);
+}
+
+/**
+ * @brief Busca em largura sobre o grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param distancias Array com numVertices posicoes, preenchido com o numero de saltos ou -1 se inalcancavel
+ * @return Numero de vertices alcancados (incluindo a origem) ou -1 em caso de erro
+ */
+int buscaEmLarguraCompacta(const GrafoCompacto* compacto, int origem, int* distancias) {
+    if (compacto == NULL || distancias == NULL || origem < 0 || origem >= compacto->numVertices) return -1;
+    int* fila = (int*)malloc(compacto->numVertices * sizeof(int));
+    if (fila == NULL) return -1;
+    for (int i = 0; i < compacto->numVertices; i++) distancias[i] = -1;
+    int frente = 0;
+    int tras = 0;
+    distancias[origem] = 0;
+    fila[tras++] = origem;
+    while (frente < tras) {
+        int v = fila[frente++];
+        IteradorVizinhos iterador;
+        iniciarIteradorVizinhos(&iterador, compacto, v);
+        int w;
+        while ((w = proximoVizinho(&iterador)) >= 0) {
+            if (distancias[w] >= 0) continue;
+            distancias[w] = distancias[v] + 1;
+            fila[tras++] = w;
+        }
+    }
+    free(fila);
+    return tras;
+}
+
+/**
+ * @brief Busca em profundidade sobre o grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param ordem Array com numVertices posicoes, preenchido com os vertices pela ordem de visita
+ * @return Numero de vertices visitados ou -1 em caso de erro
+ */
+int buscaEmProfundidadeCompacta(const GrafoCompacto* compacto, int origem, int* ordem) {
+    if (compacto == NULL || ordem == NULL || origem < 0 || origem >= compacto->numVertices) return -1;
+    // pilha explicita de iteradores: cada vertice e visitado quando e descoberto, como na versao recursiva
+    IteradorVizinhos* pilha = (IteradorVizinhos*)malloc(compacto->numVertices * sizeof(IteradorVizinhos));
+    bool* visitados = (bool*)calloc(compacto->numVertices, sizeof(bool));
+    if (pilha == NULL || visitados == NULL) {
+        free(pilha);
+        free(visitados);
+        return -1;
+    }
+    int numVisitados = 0;
+    int topo = 0;
+    visitados[origem] = true;
+    ordem[numVisitados++] = origem;
+    iniciarIteradorVizinhos(&pilha[topo++], compacto, origem);
+    while (topo > 0) {
+        int w = proximoVizinho(&pilha[topo - 1]);
+        if (w < 0) {
+            topo--;
+            continue;
+        }
+        if (visitados[w]) continue;
+        visitados[w] = true;
+        ordem[numVisitados++] = w;
+        iniciarIteradorVizinhos(&pilha[topo++], compacto, w);
+    }
+    free(pilha);
+    free(visitados);
+    return numVisitados;
+}
+
+/**
+ * @brief Vertices de uma frequencia no grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param frequencia Frequencia pretendida
+ * @param tamanho Apontador para o numero de vertices da frequencia
+ * @return Indices compactos dos vertices, por ordem crescente (nao libertar), ou NULL se nao houver
+ */
+const int* verticesFrequenciaCompacta(const GrafoCompacto* compacto, char frequencia, int* tamanho) {
+    if (tamanho != NULL) *tamanho = 0;
+    if (compacto == NULL || tamanho == NULL) return NULL;
+    int f = (unsigned char)frequencia;
+    *tamanho = compacto->inicioFrequencia[f + 1] - compacto->inicioFrequencia[f];
+    return *tamanho > 0 ? &compacto->membrosFrequencia[compacto->inicioFrequencia[f]] : NULL;
+}
+
+/**
+ * @brief Reconstroi o caminho da origem ao destino a partir do array de pais
+ * @param pai Pai de cada vertice na pesquisa (-1 na origem)
+ * @param destino Indice compacto do destino
+ * @param caminho Array alocado com o caminho (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @return true se o caminho foi criado, false em caso de erro de alocacao
+ */
+static bool reconstruirCaminhoCompacto(const int* pai, int destino, int** caminho, int* tamanhoCaminho) {
+    int tamanho = 0;
+    for (int v = destino; v >= 0; v = pai[v]) tamanho++;
+    *caminho = (int*)malloc(tamanho * sizeof(int));
+    if (*caminho == NULL) return false;
+    int k = tamanho;
+    for (int v = destino; v >= 0; v = pai[v]) (*caminho)[--k] = v;
+    *tamanhoCaminho = tamanho;
+    return true;
+}
+
+/**
+ * @brief Caminho com o menor numero de saltos entre dois vertices do grafo compacto (pesquisa em largura)
+ * So le o grafo compacto, por isso pode ser usado sem bloqueios num instantaneo fixado
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @return true se existe caminho, false caso contrario ou em caso de erro
+ */
+bool caminhoMenosSaltosCompacto(const GrafoCompacto* compacto, int origem, int destino, int** caminho, int* tamanhoCaminho) {
+    if (compacto == NULL || caminho == NULL || tamanhoCaminho == NULL) return false;
+    *caminho = NULL;
+    *tamanhoCaminho = 0;
+    int n = compacto->numVertices;
+    if (origem < 0 || origem >= n || destino < 0 || destino >= n) return false;
+    int* pai = (int*)malloc(n * sizeof(int));
+    int* fila = (int*)malloc(n * sizeof(int));
+    if (pai == NULL || fila == NULL) {
+        free(pai);
+        free(fila);
+        return false;
+    }
+    for (int i = 0; i < n; i++) pai[i] = -2; // -2 = por visitar
+    int frente = 0;
+    int tras = 0;
+    pai[origem] = -1;
+    fila[tras++] = origem;
+    while (frente < tras && pai[destino] == -2) {
+        int v = fila[frente++];
+        IteradorVizinhos iterador;
+        iniciarIteradorVizinhos(&iterador, compacto, v);
+        int w;
+        while ((w = proximoVizinho(&iterador)) >= 0) {
+            if (pai[w] != -2) continue;
+            pai[w] = v;
+            fila[tras++] = w;
+        }
+    }
+    bool encontrado = pai[destino] != -2 && reconstruirCaminhoCompacto(pai, destino, caminho, tamanhoCaminho);
+    free(pai);
+    free(fila);
+    return encontrado;
+}
+
+/**
+ * @brief Entrada do monte usado no caminho de custo minimo (com entradas repetidas, as antigas sao ignoradas)
+ */
+typedef struct EntradaMonteCompacto {
+    double custo;
+    int vertice;
+} EntradaMonteCompacto;
+
+/**
+ * @brief Acrescenta uma entrada ao monte minimo
+ */
+static void colocarMonteCompacto(EntradaMonteCompacto* monte, int* tamanho, double custo, int vertice) {
+    int i = (*tamanho)++;
+    while (i > 0 && monte[(i - 1) / 2].custo > custo) {
+        monte[i] = monte[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    monte[i].custo = custo;
+    monte[i].vertice = vertice;
+}
+
+/**
+ * @brief Retira a entrada de menor custo do monte
+ */
+static EntradaMonteCompacto retirarMonteCompacto(EntradaMonteCompacto* monte, int* tamanho) {
+    EntradaMonteCompacto topo = monte[0];
+    EntradaMonteCompacto ultimo = monte[--(*tamanho)];
+    int i = 0;
+    for (;;) {
+        int filho = 2 * i + 1;
+        if (filho >= *tamanho) break;
+        if (filho + 1 < *tamanho && monte[filho + 1].custo < monte[filho].custo) filho++;
+        if (monte[filho].custo >= ultimo.custo) break;
+        monte[i] = monte[filho];
+        i = filho;
+    }
+    monte[i] = ultimo;
+    return topo;
+}
+
+/**
+ * @brief Caminho de custo minimo entre dois vertices do grafo compacto (Dijkstra)
+ * Os pesos sao os do grafo de origem, calculados a partir das posicoes; so le o grafo compacto,
+ * por isso pode ser usado sem bloqueios num instantaneo fixado
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total do caminho
+ * @return true se existe caminho, false caso contrario ou em caso de erro
+ */
+bool caminhoMaisBaratoCompacto(const GrafoCompacto* compacto, int origem, int destino, int** caminho, int* tamanhoCaminho, double* custo) {
+    if (compacto == NULL || caminho == NULL || tamanhoCaminho == NULL || custo == NULL) return false;
+    *caminho = NULL;
+    *tamanhoCaminho = 0;
+    int n = compacto->numVertices;
+    if (origem < 0 || origem >= n || destino < 0 || destino >= n) return false;
+    // cada aresta relaxada acrescenta no maximo uma entrada
+    EntradaMonteCompacto* monte = (EntradaMonteCompacto*)malloc(((size_t)compacto->numArestas + 1) * sizeof(EntradaMonteCompacto));
+    double* distancias = (double*)malloc(n * sizeof(double));
+    int* pai = (int*)malloc(n * sizeof(int));
+    bool* fechados = (bool*)calloc(n, sizeof(bool));
+    if (monte == NULL || distancias == NULL || pai == NULL || fechados == NULL) {
+        free(monte);
+        free(distancias);
+        free(pai);
+        free(fechados);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        distancias[i] = -1;
+        pai[i] = -1;
+    }
+    int tamanhoMonte = 0;
+    distancias[origem] = 0;
+    colocarMonteCompacto(monte, &tamanhoMonte, 0, origem);
+    while (tamanhoMonte > 0) {
+        EntradaMonteCompacto atual = retirarMonteCompacto(monte, &tamanhoMonte);
+        int v = atual.vertice;
+        if (fechados[v]) continue;
+        fechados[v] = true;
+        if (v == destino) break;
+        IteradorVizinhos iterador;
+        iniciarIteradorVizinhos(&iterador, compacto, v);
+        int w;
+        while ((w = proximoVizinho(&iterador)) >= 0) {
+            if (fechados[w]) continue;
+            double novo = atual.custo + distanciaCompacta(compacto, v, w);
+            if (distancias[w] >= 0 && distancias[w] <= novo) continue;
+            distancias[w] = novo;
+            pai[w] = v;
+            colocarMonteCompacto(monte, &tamanhoMonte, novo, w);
+        }
+    }
+    bool encontrado = fechados[destino] && reconstruirCaminhoCompacto(pai, destino, caminho, tamanhoCaminho);
+    if (encontrado) *custo = distancias[destino];
+    free(monte);
+    free(distancias);
+    free(pai);
+    free(fechados);
+    return encontrado;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file concorrente.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Acesso concorrente ao grafo com instantaneos imutaveis (estilo RCU)
+ * @details Os escritores alteram um grafo mestre protegido por um mutex e, no fim de cada
+ * lote, criam um GrafoCompacto novo que e publicado com uma troca atomica do apontador. O novo
+ * instantaneo parte do anterior (atualizarGrafoCompacto): os vertices tocados pelo lote e os seus
+ * vizinhos sao marcados e so as suas linhas sao reconstruidas a partir do mestre. Os leitores nunca bloqueiam: registam-se num de dois contadores (paridade),
+ * leem o apontador publicado e usam esse instantaneo, que nao muda, com as funcoes *Compacta e
+ * *Compacto (pesquisas, caminhos e membros de cada frequencia).
+ * Depois de publicar, o escritor troca a paridade e espera que os leitores da paridade antiga
+ * terminem; so entao liberta o instantaneo anterior.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include "grafo.h"
+#include "struct.h"
+
+/**
+ * @brief Grafo partilhado entre threads
+ */
+struct GrafoPartilhado {
+    Grafo* mestre;          // grafo alterado pelos escritores (so com o mutex)
+    OrdemVertices ordem;    // ordem dos vertices nos instantaneos
+    mtx_t escrita;          // serializa os escritores
+    _Atomic(GrafoCompacto*) atual; // instantaneo publicado
+    atomic_int paridade;    // contador em que os novos leitores se registam
+    atomic_int leitores[2]; // leitores ativos em cada paridade
+    bool* alterados;        // ids do mestre alterados desde o ultimo instantaneo
+    int capacidadeAlterados; // tamanho do array alterados
+    bool haMarcas;          // algum id foi marcado desde o ultimo instantaneo
+    bool marcasIncompletas; // falhou a alocacao das marcas: o proximo instantaneo e completo
+};
+
+/**
+ * @brief Cria um grafo partilhado a partir de um grafo, que passa a pertencer-lhe
+ * @param grafo Apontador para o grafo (nao deve voltar a ser usado diretamente)
+ * @param ordem Ordem dos vertices nos instantaneos publicados
+ * @return Apontador para o grafo partilhado ou NULL em caso de erro
+ */
+GrafoPartilhado* criarGrafoPartilhado(Grafo* grafo, OrdemVertices ordem) {
+    if (grafo == NULL) return NULL;
+    GrafoPartilhado* partilhado = (GrafoPartilhado*)malloc(sizeof(GrafoPartilhado));
+    if (partilhado == NULL) return NULL;
+    GrafoCompacto* inicial = congelarGrafo(grafo, ordem);
+    if (inicial == NULL || mtx_init(&partilhado->escrita, mtx_plain) != thrd_success) {
+        libertarGrafoCompacto(inicial);
+        free(partilhado);
+        return NULL;
+    }
+    partilhado->mestre = grafo;
+    partilhado->ordem = ordem;
+    atomic_init(&partilhado->atual, inicial);
+    atomic_init(&partilhado->paridade, 0);
+    atomic_init(&partilhado->leitores[0], 0);
+    atomic_init(&partilhado->leitores[1], 0);
+    partilhado->alterados = NULL;
+    partilhado->capacidadeAlterados = 0;
+    partilhado->haMarcas = false;
+    partilhado->marcasIncompletas = false;
+    return partilhado;
+}
+
+/**
+ * @brief Liberta o grafo partilhado; nenhuma thread pode ter instantaneos fixados
+ * @param partilhado Apontador para o grafo partilhado
+ * @return true se libertado com sucesso, false caso contrario
+ */
+bool libertarGrafoPartilhado(GrafoPartilhado* partilhado) {
+    if (partilhado == NULL) return false;
+    libertarGrafoCompacto(atomic_load(&partilhado->atual));
+    libertarGrafo(partilhado->mestre);
+    free(partilhado->alterados);
+    mtx_destroy(&partilhado->escrita);
+    free(partilhado);
+    return true;
+}
+
+/**
+ * @brief Fixa o instantaneo atual para leitura, sem bloquear
+ * O instantaneo mantem-se valido e imutavel ate libertarInstantaneo
+ * @param partilhado Apontador para o grafo partilhado
+ * @param bilhete Apontador onde guardar o bilhete a entregar em libertarInstantaneo
+ * @return Instantaneo fixado ou NULL em caso de erro
+ */
+const GrafoCompacto* fixarInstantaneo(GrafoPartilhado* partilhado, int* bilhete) {
+    if (partilhado == NULL || bilhete == NULL) return NULL;
+    for (;;) {
+        int p = atomic_load(&partilhado->paridade);
+        atomic_fetch_add(&partilhado->leitores[p], 1);
+        // se a paridade mudou entretanto, o escritor pode ja nao estar a contar com este leitor
+        if (atomic_load(&partilhado->paridade) == p) {
+            *bilhete = p;
+            return atomic_load(&partilhado->atual);
+        }
+        atomic_fetch_sub(&partilhado->leitores[p], 1);
+    }
+}
+
+/**
+ * @brief Liberta um instantaneo fixado com fixarInstantaneo
+ * @param partilhado Apontador para o grafo partilhado
+ * @param bilhete Bilhete devolvido por fixarInstantaneo
+ * @return true se libertado, false caso contrario
+ */
+bool libertarInstantaneo(GrafoPartilhado* partilhado, int bilhete) {
+    if (partilhado == NULL || (bilhete != 0 && bilhete != 1)) return false;
+    atomic_fetch_sub(&partilhado->leitores[bilhete], 1);
+    return true;
+}
+
+/**
+ * @brief Marca um vertice e os seus vizinhos como alterados desde o ultimo instantaneo
+ * As linhas destes vertices sao reconstruidas no instantaneo seguinte; as restantes sao copiadas
+ * @param partilhado Apontador para o grafo partilhado
+ * @param vertice Apontador para o vertice (pode ser NULL)
+ */
+static void marcarVizinhanca(GrafoPartilhado* partilhado, NoVertice* vertice) {
+    if (vertice == NULL || partilhado->marcasIncompletas) return;
+    partilhado->haMarcas = true;
+    Grafo* grafo = partilhado->mestre;
+    if (partilhado->capacidadeAlterados < grafo->limiteIds) {
+        int novaCapacidade = partilhado->capacidadeAlterados > 0 ? partilhado->capacidadeAlterados : 64;
+        while (novaCapacidade < grafo->limiteIds) novaCapacidade *= 2;
+        bool* novas = (bool*)realloc(partilhado->alterados, novaCapacidade * sizeof(bool));
+        if (novas == NULL) {
+            partilhado->marcasIncompletas = true;
+            return;
+        }
+        for (int id = partilhado->capacidadeAlterados; id < novaCapacidade; id++) novas[id] = false;
+        partilhado->alterados = novas;
+        partilhado->capacidadeAlterados = novaCapacidade;
+    }
+    partilhado->alterados[vertice->id] = true;
+    for (Aresta* a = vertice->primeiraAresta; a != NULL; a = a->proxima) partilhado->alterados[a->destino->id] = true;
+}
+
+/**
+ * @brief Aplica uma alteracao ao grafo mestre, marcando a vizinhanca antes e depois da alteracao
+ * @param partilhado Apontador para o grafo partilhado
+ * @param alteracao Alteracao a aplicar
+ * @return true se aplicada, false se for invalida
+ */
+static bool aplicarAlteracao(GrafoPartilhado* partilhado, const Alteracao* alteracao) {
+    Grafo* grafo = partilhado->mestre;
+    Coordenada posicao = alteracao->antena.posicao;
+    if (alteracao->tipo == ALTERACAO_INSERIR) {
+        if (posicao.x < 0 || posicao.y < 0 || encontrarVerticePorCoordenadas(grafo, posicao.x, posicao.y) != NULL) return false;
+        NoVertice* novo = anexarVertice(grafo, alteracao->antena);
+        if (novo == NULL) return false;
+        // mesma regra de carregarDadosGrafo: liga a todas as antenas da mesma frequencia
+        int tamanho = 0;
+        NoVertice* const* membros = obterVerticesFrequencia(grafo, novo->dados.frequencia, &tamanho);
+        bool ligado = true;
+        for (int i = 0; i < tamanho && ligado; i++) {
+            if (membros[i] != novo) ligado = anexarArestaDupla(grafo, novo, membros[i]);
+        }
+        if (!ligado) {
+            // sem todas as ligacoes a antena violaria a regra, por isso a insercao e desfeita
+            removerVertice(grafo, obterReferencia(grafo, novo->id));
+            return false;
+        }
+        marcarVizinhanca(partilhado, novo);
+        return true;
+    }
+    NoVertice* vertice = encontrarVerticePorCoordenadas(grafo, posicao.x, posicao.y);
+    if (vertice == NULL) return false;
+    RefVertice ref = obterReferencia(grafo, vertice->id);
+    marcarVizinhanca(partilhado, vertice);
+    bool aplicada;
+    switch (alteracao->tipo) {
+    case ALTERACAO_REMOVER: aplicada = removerVertice(grafo, ref); break;
+    case ALTERACAO_MOVER: aplicada = moverVertice(grafo, ref, alteracao->novaPosicao.x, alteracao->novaPosicao.y); break;
+    case ALTERACAO_FREQUENCIA: aplicada = alterarFrequencia(grafo, ref, alteracao->antena.frequencia); break;
+    default: aplicada = false; break;
+    }
+    marcarVizinhanca(partilhado, resolverReferencia(grafo, ref));
+    return aplicada;
+}
+
+/**
+ * @brief Aplica um lote de alteracoes e publica um novo instantaneo
+ * O novo instantaneo e criado com atualizarGrafoCompacto a partir do atual: so as linhas dos
+ * vertices alterados no lote (e dos seus vizinhos) sao reconstruidas a partir do mestre. Se o lote
+ * nao tocar em nenhum vertice, o instantaneo atual continua publicado.
+ * Os escritores sao serializados; o instantaneo anterior e libertado quando deixar de ter leitores
+ * @param partilhado Apontador para o grafo partilhado
+ * @param alteracoes Array de alteracoes
+ * @param numAlteracoes Numero de alteracoes
+ * @return Numero de alteracoes aplicadas ou -1 se o novo instantaneo nao puder ser criado
+ */
+int aplicarAlteracoes(GrafoPartilhado* partilhado, const Alteracao* alteracoes, int numAlteracoes) {
+    if (partilhado == NULL || (alteracoes == NULL && numAlteracoes > 0)) return -1;
+    if (mtx_lock(&partilhado->escrita) != thrd_success) return -1;
+    int aplicadas = 0;
+    for (int i = 0; i < numAlteracoes; i++) {
+        if (aplicarAlteracao(partilhado, &alteracoes[i])) aplicadas++;
+    }
+    if (!partilhado->haMarcas) {
+        mtx_unlock(&partilhado->escrita);
+        return 0;
+    }
+    // o instantaneo atual so e libertado por este escritor, que tem o mutex
+    GrafoCompacto* atual = atomic_load(&partilhado->atual);
+    GrafoCompacto* novo = partilhado->marcasIncompletas ? congelarGrafo(partilhado->mestre, partilhado->ordem) :
+        atualizarGrafoCompacto(partilhado->mestre, atual, partilhado->alterados, partilhado->capacidadeAlterados);
+    if (novo == NULL) {
+        // as marcas ficam para o proximo lote
+        mtx_unlock(&partilhado->escrita);
+        return -1;
+    }
+    if (partilhado->alterados != NULL) memset(partilhado->alterados, 0, partilhado->capacidadeAlterados * sizeof(bool));
+    partilhado->haMarcas = false;
+    partilhado->marcasIncompletas = false;
+    GrafoCompacto* antigo = atomic_exchange(&partilhado->atual, novo);
+
+    // periodo de graca: os leitores que chegam a partir daqui registam-se na nova paridade
+    // e so podem ver o instantaneo novo; espera-se que os da paridade antiga terminem
+    int p = atomic_load(&partilhado->paridade);
+    atomic_store(&partilhado->paridade, 1 - p);
+    while (atomic_load(&partilhado->leitores[p]) != 0) thrd_yield();
+    libertarGrafoCompacto(antigo);
+
+    mtx_unlock(&partilhado->escrita);
+    return aplicadas;
+}
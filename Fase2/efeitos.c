@@ -0,0 +1,95 @@
+/**
+ * @file efeitos.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Calculo dos efeitos nefastos da Fase1 diretamente sobre o grafo
+ * @details Na Fase1 os efeitos sao calculados comparando todos os pares de antenas da lista.
+ * No grafo as antenas da mesma frequencia ja estao ligadas por arestas, por isso basta percorrer
+ * os grupos de frequencia e visitar cada aresta nao dirigida uma vez: o par (a, b) da os efeitos
+ * 2a - b e 2b - a (a regra de pontosEfeito da Fase1, que este projeto nao inclui). O resultado e um array de EfeitoNefasto com os campos do Nefasto da Fase1,
+ * para que o mesmo grafo carregado sirva as duas analises.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "grafo.h"
+#include "struct.h"
+
+/**
+ * @brief Compara dois efeitos por linha, coluna e ids (ordem da lista de efeitos da Fase1)
+ */
+static int compararEfeitos(const void* a, const void* b) {
+    const EfeitoNefasto* e1 = (const EfeitoNefasto*)a;
+    const EfeitoNefasto* e2 = (const EfeitoNefasto*)b;
+    if (e1->linha != e2->linha) return e1->linha < e2->linha ? -1 : 1;
+    if (e1->coluna != e2->coluna) return e1->coluna < e2->coluna ? -1 : 1;
+    if (e1->idAntena1 != e2->idAntena1) return e1->idAntena1 < e2->idAntena1 ? -1 : 1;
+    if (e1->idAntena2 != e2->idAntena2) return e1->idAntena2 < e2->idAntena2 ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Percorre as arestas nao dirigidas de um grupo de frequencia e regista (ou conta) os efeitos
+ * Cada par de arestas gemeas u->v e v->u e visitado so a partir do vertice de menor id
+ * @param grupo Grupo de frequencia
+ * @param efeitos Array para os efeitos ou NULL para apenas contar
+ * @param total Apontador para o numero de efeitos registados
+ */
+static void efeitosGrupo(const GrupoFrequencia* grupo, EfeitoNefasto* efeitos, int* total) {
+    for (int i = 0; i < grupo->tamanho; i++) {
+        NoVertice* u = grupo->membros[i];
+        for (Aresta* aresta = u->primeiraAresta; aresta != NULL; aresta = aresta->proxima) {
+            NoVertice* v = aresta->destino;
+            if (v->dados.frequencia != u->dados.frequencia) continue;
+            if (v->id < u->id && aresta->gemea != NULL) continue; // ja contado a partir de v
+            if (efeitos != NULL) {
+                // linha = y + 1 e coluna = x + 1, como na Fase1
+                int linhaU = u->dados.posicao.y + 1;
+                int colunaU = u->dados.posicao.x + 1;
+                int linhaV = v->dados.posicao.y + 1;
+                int colunaV = v->dados.posicao.x + 1;
+                EfeitoNefasto* e = &efeitos[*total];
+                e[0].linha = 2 * linhaU - linhaV;
+                e[0].coluna = 2 * colunaU - colunaV;
+                e[0].idAntena1 = u->id;
+                e[0].idAntena2 = v->id;
+                e[1].linha = 2 * linhaV - linhaU;
+                e[1].coluna = 2 * colunaV - colunaU;
+                e[1].idAntena1 = v->id;
+                e[1].idAntena2 = u->id;
+            }
+            *total += 2;
+        }
+    }
+}
+
+/**
+ * @brief Calcula os efeitos nefastos a partir das arestas do grafo, sem carregar o mapa na Fase1
+ * Cada aresta nao dirigida entre antenas da mesma frequencia e visitada uma vez e da origem a dois
+ * efeitos; o array fica ordenado por linha e coluna, como a lista de efeitos da Fase1
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia das antenas (0..255) ou -1 para todas
+ * @param efeitos Array alocado com os efeitos (a libertar pelo chamador; NULL se nao houver efeitos)
+ * @param numEfeitos Apontador para o numero de efeitos
+ * @return true se os efeitos foram calculados, false em caso de erro
+ */
+bool calcularEfeitosNefastos(Grafo* grafo, int frequencia, EfeitoNefasto** efeitos, int* numEfeitos) {
+    if (grafo == NULL || efeitos == NULL || numEfeitos == NULL) return false;
+    if (frequencia < -1 || frequencia >= NUM_FREQUENCIAS) return false;
+    *efeitos = NULL;
+    *numEfeitos = 0;
+    int primeira = frequencia < 0 ? 0 : frequencia;
+    int ultima = frequencia < 0 ? NUM_FREQUENCIAS - 1 : frequencia;
+
+    // primeira passagem conta os efeitos para alocar o array de uma vez
+    int total = 0;
+    for (int f = primeira; f <= ultima; f++) efeitosGrupo(&grafo->frequencias[f], NULL, &total);
+    if (total == 0) return true;
+    *efeitos = (EfeitoNefasto*)malloc(total * sizeof(EfeitoNefasto));
+    if (*efeitos == NULL) return false;
+    for (int f = primeira; f <= ultima; f++) efeitosGrupo(&grafo->frequencias[f], *efeitos, numEfeitos);
+    qsort(*efeitos, *numEfeitos, sizeof(EfeitoNefasto), compararEfeitos);
+    return true;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file estatisticas.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Recolha e exportacao das estatisticas de instrumentacao do grafo
+ * @details Os contadores sao atomicos (ordem relaxada) porque o carregamento paralelo e o grafo
+ * partilhado alocam arestas e vertices a partir de varias threads. O tempo usa timespec_get.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "estatisticas.h"
+
+#ifdef EDA_ESTATISTICAS
+#include <stdatomic.h>
+
+/**
+ * @brief Contadores de uma funcao, atualizados atomicamente
+ */
+typedef struct ContadorFuncaoAtomico {
+    atomic_ullong chamadas;
+    atomic_ullong nanossegundos;
+    atomic_ullong verticesVisitados;
+    atomic_ullong arestasVisitadas;
+} ContadorFuncaoAtomico;
+
+/**
+ * @brief Contadores de uma estrutura, atualizados atomicamente
+ */
+typedef struct ContadorEstruturaAtomico {
+    atomic_ullong alocacoes;
+    atomic_ullong libertacoes;
+    atomic_ullong bytesAlocados;
+    atomic_ullong bytesLibertados;
+} ContadorEstruturaAtomico;
+
+static ContadorFuncaoAtomico contadoresFuncoes[NUM_ESTAT_FUNCOES];
+static ContadorEstruturaAtomico contadoresEstruturas[NUM_ESTAT_ESTRUTURAS];
+
+#define SOMAR(contador, valor) atomic_fetch_add_explicit(&(contador), (valor), memory_order_relaxed)
+#define LER(contador) atomic_load_explicit(&(contador), memory_order_relaxed)
+#define ZERAR(contador) atomic_store_explicit(&(contador), 0, memory_order_relaxed)
+#endif
+
+static const char* nomesFuncoes[NUM_ESTAT_FUNCOES] = {
+    "carregarDadosGrafo", "buscaEmLargura", "encontrarCaminhos", "encontrarCaminhosRecursivo"
+};
+
+static const char* nomesEstruturas[NUM_ESTAT_ESTRUTURAS] = {
+    "Grafo", "NoVertice", "Aresta", "Fila", "ElementoFila", "ElementoCaminho", "ListaCaminho"
+};
+
+/**
+ * @brief Instante atual em nanossegundos
+ * @return Nanossegundos desde uma origem fixa
+ */
+unsigned long long estatisticasRelogio(void) {
+    struct timespec ts;
+    if (timespec_get(&ts, TIME_UTC) == 0) return 0;
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+/**
+ * @brief Acumula o tempo decorrido desde inicio na funcao
+ * @param funcao Funcao instrumentada
+ * @param inicio Valor de estatisticasRelogio a entrada da funcao
+ */
+void estatisticasTempo(FuncaoEstatistica funcao, unsigned long long inicio) {
+#ifdef EDA_ESTATISTICAS
+    unsigned long long agora = estatisticasRelogio();
+    SOMAR(contadoresFuncoes[funcao].nanossegundos, agora > inicio ? agora - inicio : 0);
+#else
+    (void)funcao;
+    (void)inicio;
+#endif
+}
+
+/**
+ * @brief Conta uma chamada da funcao
+ * @param funcao Funcao instrumentada
+ */
+void estatisticasChamada(FuncaoEstatistica funcao) {
+#ifdef EDA_ESTATISTICAS
+    SOMAR(contadoresFuncoes[funcao].chamadas, 1);
+#else
+    (void)funcao;
+#endif
+}
+
+/**
+ * @brief Acumula os vertices e arestas visitados pela funcao
+ * @param funcao Funcao instrumentada
+ * @param vertices Vertices visitados
+ * @param arestas Arestas visitadas
+ */
+void estatisticasVisitas(FuncaoEstatistica funcao, unsigned long long vertices, unsigned long long arestas) {
+#ifdef EDA_ESTATISTICAS
+    if (vertices > 0) SOMAR(contadoresFuncoes[funcao].verticesVisitados, vertices);
+    if (arestas > 0) SOMAR(contadoresFuncoes[funcao].arestasVisitadas, arestas);
+#else
+    (void)funcao;
+    (void)vertices;
+    (void)arestas;
+#endif
+}
+
+/**
+ * @brief Conta uma alocacao
+ * @param estrutura Estrutura alocada
+ * @param bytes Bytes alocados
+ */
+void estatisticasAlocacao(EstruturaEstatistica estrutura, unsigned long long bytes) {
+#ifdef EDA_ESTATISTICAS
+    SOMAR(contadoresEstruturas[estrutura].alocacoes, 1);
+    SOMAR(contadoresEstruturas[estrutura].bytesAlocados, bytes);
+#else
+    (void)estrutura;
+    (void)bytes;
+#endif
+}
+
+/**
+ * @brief Conta uma libertacao
+ * @param estrutura Estrutura libertada
+ * @param bytes Bytes libertados
+ */
+void estatisticasLibertacao(EstruturaEstatistica estrutura, unsigned long long bytes) {
+#ifdef EDA_ESTATISTICAS
+    SOMAR(contadoresEstruturas[estrutura].libertacoes, 1);
+    SOMAR(contadoresEstruturas[estrutura].bytesLibertados, bytes);
+#else
+    (void)estrutura;
+    (void)bytes;
+#endif
+}
+
+/**
+ * @brief Copia os contadores atuais (cada contador e lido atomicamente, o conjunto nao)
+ * @param destino Apontador para a copia
+ * @return true se a instrumentacao estiver ligada, false caso contrario (destino fica a zeros)
+ */
+bool obterEstatisticas(Estatisticas* destino) {
+    if (destino == NULL) return false;
+    memset(destino, 0, sizeof(Estatisticas));
+#ifdef EDA_ESTATISTICAS
+    destino->ativas = true;
+    for (int i = 0; i < NUM_ESTAT_FUNCOES; i++) {
+        destino->funcoes[i].chamadas = LER(contadoresFuncoes[i].chamadas);
+        destino->funcoes[i].nanossegundos = LER(contadoresFuncoes[i].nanossegundos);
+        destino->funcoes[i].verticesVisitados = LER(contadoresFuncoes[i].verticesVisitados);
+        destino->funcoes[i].arestasVisitadas = LER(contadoresFuncoes[i].arestasVisitadas);
+    }
+    for (int i = 0; i < NUM_ESTAT_ESTRUTURAS; i++) {
+        destino->estruturas[i].alocacoes = LER(contadoresEstruturas[i].alocacoes);
+        destino->estruturas[i].libertacoes = LER(contadoresEstruturas[i].libertacoes);
+        destino->estruturas[i].bytesAlocados = LER(contadoresEstruturas[i].bytesAlocados);
+        destino->estruturas[i].bytesLibertados = LER(contadoresEstruturas[i].bytesLibertados);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Poe todos os contadores a zero
+ * @return true se a instrumentacao estiver ligada, false caso contrario
+ */
+bool reiniciarEstatisticas(void) {
+#ifdef EDA_ESTATISTICAS
+    for (int i = 0; i < NUM_ESTAT_FUNCOES; i++) {
+        ZERAR(contadoresFuncoes[i].chamadas);
+        ZERAR(contadoresFuncoes[i].nanossegundos);
+        ZERAR(contadoresFuncoes[i].verticesVisitados);
+        ZERAR(contadoresFuncoes[i].arestasVisitadas);
+    }
+    for (int i = 0; i < NUM_ESTAT_ESTRUTURAS; i++) {
+        ZERAR(contadoresEstruturas[i].alocacoes);
+        ZERAR(contadoresEstruturas[i].libertacoes);
+        ZERAR(contadoresEstruturas[i].bytesAlocados);
+        ZERAR(contadoresEstruturas[i].bytesLibertados);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Escreve as estatisticas em JSON
+ * @param estatisticas Estatisticas obtidas com obterEstatisticas
+ * @param fp Ficheiro aberto para escrita (ex.: stdout)
+ * @return true se escrito com sucesso, false caso contrario
+ */
+bool gravarEstatisticasJSON(const Estatisticas* estatisticas, FILE* fp) {
+    if (estatisticas == NULL || fp == NULL) return false;
+    fprintf(fp, "{\n  \"ativas\": %s,\n  \"funcoes\": {\n", estatisticas->ativas ? "true" : "false");
+    for (int i = 0; i < NUM_ESTAT_FUNCOES; i++) {
+        const ContadorFuncao* c = &estatisticas->funcoes[i];
+        fprintf(fp, "    \"%s\": {\"chamadas\": %llu, \"nanossegundos\": %llu, \"verticesVisitados\": %llu, \"arestasVisitadas\": %llu}%s\n",
+            nomesFuncoes[i], c->chamadas, c->nanossegundos, c->verticesVisitados, c->arestasVisitadas, i + 1 < NUM_ESTAT_FUNCOES ? "," : "");
+    }
+    fprintf(fp, "  },\n  \"estruturas\": {\n");
+    for (int i = 0; i < NUM_ESTAT_ESTRUTURAS; i++) {
+        const ContadorEstrutura* c = &estatisticas->estruturas[i];
+        fprintf(fp, "    \"%s\": {\"alocacoes\": %llu, \"libertacoes\": %llu, \"bytesAlocados\": %llu, \"bytesLibertados\": %llu}%s\n",
+            nomesEstruturas[i], c->alocacoes, c->libertacoes, c->bytesAlocados, c->bytesLibertados, i + 1 < NUM_ESTAT_ESTRUTURAS ? "," : "");
+    }
+    fprintf(fp, "  }\n}\n");
+    return ferror(fp) == 0;
+}
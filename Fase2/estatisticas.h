@@ -0,0 +1,157 @@
+#pragma once
+/**
+ * @file estatisticas.h
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Instrumentacao das funcoes criticas do grafo (contadores, tempos e alocacoes)
+ * @details A recolha so e compilada com EDA_ESTATISTICAS definido (ex.: -DEDA_ESTATISTICAS).
+ * Sem essa definicao as macros ESTAT_* nao geram codigo e as funcoes de consulta devolvem
+ * estatisticas vazias, pelo que a instrumentacao nao tem custo.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ * @brief Funcoes instrumentadas
+ */
+typedef enum FuncaoEstatistica {
+    ESTAT_CARREGAR_DADOS_GRAFO,
+    ESTAT_BUSCA_LARGURA,
+    ESTAT_ENCONTRAR_CAMINHOS,
+    ESTAT_CAMINHOS_RECURSIVO, // sem tempo proprio (recursiva): o tempo esta em ESTAT_ENCONTRAR_CAMINHOS
+    NUM_ESTAT_FUNCOES
+} FuncaoEstatistica;
+
+/**
+ * @brief Estruturas cujas alocacoes sao contadas
+ */
+typedef enum EstruturaEstatistica {
+    ESTAT_GRAFO,
+    ESTAT_VERTICE,
+    ESTAT_ARESTA,
+    ESTAT_FILA,
+    ESTAT_ELEMENTO_FILA,
+    ESTAT_ELEMENTO_CAMINHO,
+    ESTAT_LISTA_CAMINHO,
+    NUM_ESTAT_ESTRUTURAS
+} EstruturaEstatistica;
+
+/**
+ * @brief Contadores de uma funcao
+ */
+typedef struct ContadorFuncao {
+    unsigned long long chamadas;        // numero de chamadas
+    unsigned long long nanossegundos;   // tempo acumulado em todas as chamadas contadas (tambem as que falham)
+    unsigned long long verticesVisitados; // vertices visitados
+    unsigned long long arestasVisitadas; // arestas percorridas ou criadas
+} ContadorFuncao;
+
+/**
+ * @brief Contadores de alocacao de uma estrutura
+ */
+typedef struct ContadorEstrutura {
+    unsigned long long alocacoes;       // numero de alocacoes
+    unsigned long long libertacoes;     // numero de libertacoes
+    unsigned long long bytesAlocados;   // bytes alocados
+    unsigned long long bytesLibertados; // bytes libertados
+} ContadorEstrutura;
+
+/**
+ * @brief Copia dos contadores num dado instante
+ */
+typedef struct Estatisticas {
+    bool ativas;            // false se compilado sem EDA_ESTATISTICAS
+    ContadorFuncao funcoes[NUM_ESTAT_FUNCOES];
+    ContadorEstrutura estruturas[NUM_ESTAT_ESTRUTURAS];
+} Estatisticas;
+
+/**
+ * @brief Instante atual em nanossegundos
+ * @return Nanossegundos desde uma origem fixa
+ */
+unsigned long long estatisticasRelogio(void);
+
+/**
+ * @brief Acumula o tempo decorrido desde inicio na funcao
+ * @param funcao Funcao instrumentada
+ * @param inicio Valor de estatisticasRelogio a entrada da funcao
+ */
+void estatisticasTempo(FuncaoEstatistica funcao, unsigned long long inicio);
+
+/**
+ * @brief Conta uma chamada da funcao
+ * @param funcao Funcao instrumentada
+ */
+void estatisticasChamada(FuncaoEstatistica funcao);
+
+/**
+ * @brief Acumula os vertices e arestas visitados pela funcao
+ * @param funcao Funcao instrumentada
+ * @param vertices Vertices visitados
+ * @param arestas Arestas visitadas
+ */
+void estatisticasVisitas(FuncaoEstatistica funcao, unsigned long long vertices, unsigned long long arestas);
+
+/**
+ * @brief Conta uma alocacao
+ * @param estrutura Estrutura alocada
+ * @param bytes Bytes alocados
+ */
+void estatisticasAlocacao(EstruturaEstatistica estrutura, unsigned long long bytes);
+
+/**
+ * @brief Conta uma libertacao
+ * @param estrutura Estrutura libertada
+ * @param bytes Bytes libertados
+ */
+void estatisticasLibertacao(EstruturaEstatistica estrutura, unsigned long long bytes);
+
+/**
+ * @brief Copia os contadores atuais (cada contador e lido atomicamente, o conjunto nao)
+ * @param destino Apontador para a copia
+ * @return true se a instrumentacao estiver ligada, false caso contrario (destino fica a zeros)
+ */
+bool obterEstatisticas(Estatisticas* destino);
+
+/**
+ * @brief Poe todos os contadores a zero
+ * @return true se a instrumentacao estiver ligada, false caso contrario
+ */
+bool reiniciarEstatisticas(void);
+
+/**
+ * @brief Escreve as estatisticas em JSON
+ * @param estatisticas Estatisticas obtidas com obterEstatisticas
+ * @param fp Ficheiro aberto para escrita (ex.: stdout)
+ * @return true se escrito com sucesso, false caso contrario
+ */
+bool gravarEstatisticasJSON(const Estatisticas* estatisticas, FILE* fp);
+
+#ifdef EDA_ESTATISTICAS
+// conta a chamada e guarda o instante de entrada numa variavel local
+#define ESTAT_INICIO(funcao) unsigned long long estatInicio = estatisticasRelogio(); estatisticasChamada(funcao)
+#define ESTAT_CHAMADA(funcao) estatisticasChamada(funcao)
+#define ESTAT_FIM(funcao) estatisticasTempo(funcao, estatInicio)
+#define ESTAT_VISITAS(funcao, vertices, arestas) estatisticasVisitas(funcao, vertices, arestas)
+#define ESTAT_ALOCACAO(estrutura, bytes) estatisticasAlocacao(estrutura, bytes)
+#define ESTAT_LIBERTACAO(estrutura, bytes) estatisticasLibertacao(estrutura, bytes)
+// contagem local (a variavel so existe com a instrumentacao ligada)
+#define ESTAT_CONTADOR(nome) unsigned long long nome = 0
+#define ESTAT_INCREMENTA(nome) (nome)++
+#else
+#define ESTAT_INICIO(funcao) ((void)0)
+#define ESTAT_CHAMADA(funcao) ((void)0)
+#define ESTAT_FIM(funcao) ((void)0)
+#define ESTAT_VISITAS(funcao, vertices, arestas) ((void)0)
+#define ESTAT_ALOCACAO(estrutura, bytes) ((void)0)
+#define ESTAT_LIBERTACAO(estrutura, bytes) ((void)0)
+#define ESTAT_CONTADOR(nome) ((void)0)
+#define ESTAT_INCREMENTA(nome) ((void)0)
+#endif
+
+#endif // ESTATISTICAS_H
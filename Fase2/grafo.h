@@ -11,6 +11,8 @@
 #define GRAFO_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 #include "struct.h"
 
  /**
@@ -34,6 +36,33 @@ bool libertarGrafo(Grafo* grafo);
  */
 NoVertice* adicionarVertice(Grafo* grafo, Antena antena);
 
+/**
+ * @brief Acrescenta um vertice ao grafo sem verificar se as coordenadas ja existem
+ * @param grafo Apontador para o grafo
+ * @param antena Dados da antena a ser adicionada
+ * @return Apontador para o novo vertice ou NULL em caso de erro
+ */
+NoVertice* anexarVertice(Grafo* grafo, Antena antena);
+
+/**
+ * @brief Reserva de uma vez a memoria dos proximos vertices e arestas (dois blocos contiguos)
+ * anexarVertice e anexarAresta usam os blocos enquanto houver espaco e depois voltam ao malloc.
+ * Blocos ja existentes mas sem nada em uso (depois de limparGrafo) sao reaproveitados
+ * @param grafo Apontador para o grafo
+ * @param numVertices Numero de vertices a reservar
+ * @param numArestas Numero de arestas dirigidas a reservar
+ * @return true se reservado, false se os blocos do grafo estiverem em uso ou faltar memoria
+ */
+bool reservarBlocosGrafo(Grafo* grafo, int numVertices, int numArestas);
+
+/**
+ * @brief Esvazia o grafo mantendo a memoria reservada (arrays, tabelas e blocos) para o reutilizar
+ * Os ids recomecam em 0 e as referencias anteriores deixam de ser validas
+ * @param grafo Apontador para o grafo
+ * @return true se esvaziado, false se o grafo for NULL
+ */
+bool limparGrafo(Grafo* grafo);
+
 /**
  * @brief Verifica se existe uma aresta entre dois vertices
  * @param origem Apontador para o vertice de origem
@@ -42,6 +71,24 @@ NoVertice* adicionarVertice(Grafo* grafo, Antena antena);
  */
 bool existeAresta(NoVertice* origem, NoVertice* destino);
 
+/**
+ * @brief Distancia entre as posicoes de dois vertices segundo uma metrica
+ * @param a Apontador para o primeiro vertice
+ * @param b Apontador para o segundo vertice
+ * @param metrica Metrica a usar
+ * @return Distancia (1 para a metrica unitaria)
+ */
+double distanciaVertices(NoVertice* a, NoVertice* b, MetricaPeso metrica);
+
+/**
+ * @brief Define a metrica dos pesos e recalcula o peso de todas as arestas
+ * As arestas acrescentadas depois passam a usar a mesma metrica
+ * @param grafo Apontador para o grafo
+ * @param metrica Metrica a usar
+ * @return true se os pesos foram atualizados, false caso contrario
+ */
+bool definirMetricaPesos(Grafo* grafo, MetricaPeso metrica);
+
 /**
  * @brief Adiciona uma aresta entre dois vertices
  * @param grafo Apontador para o grafo
@@ -51,6 +98,78 @@ bool existeAresta(NoVertice* origem, NoVertice* destino);
  */
 bool adicionarAresta(Grafo* grafo, NoVertice* origem, NoVertice* destino);
 
+/**
+ * @brief Acrescenta uma aresta no inicio da lista da origem sem verificar se ja existe
+ * @param grafo Apontador para o grafo
+ * @param origem Apontador para o vertice de origem
+ * @param destino Apontador para o vertice de destino
+ * @return true se a aresta foi adicionada, false caso contrario
+ */
+bool anexarAresta(Grafo* grafo, NoVertice* origem, NoVertice* destino);
+
+/**
+ * @brief Acrescenta as duas arestas a->b e b->a, ligadas como gemeas, sem verificar se ja existem
+ * @param grafo Apontador para o grafo
+ * @param a Apontador para o primeiro vertice
+ * @param b Apontador para o segundo vertice
+ * @return true se as arestas foram adicionadas, false caso contrario
+ */
+bool anexarArestaDupla(Grafo* grafo, NoVertice* a, NoVertice* b);
+
+/**
+ * @brief Liga como gemeas todas as arestas u->v e v->u que ainda nao o estao, em O(V + E)
+ * @param grafo Apontador para o grafo
+ * @return true se concluido, false em caso de erro de alocacao
+ */
+bool emparelharArestasGemeas(Grafo* grafo);
+
+/**
+ * @brief Remove um vertice e todas as suas arestas do grafo
+ * A referencia deixa de resolver (a geracao do id avanca) e o id pode ser reutilizado
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia do vertice a remover
+ * @return true se removido, false se a referencia ja nao resolver
+ */
+bool removerVertice(Grafo* grafo, RefVertice ref);
+
+/**
+ * @brief Muda a posicao de um vertice; as arestas mantem-se e os seus pesos sao recalculados
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia do vertice
+ * @param x Nova coordenada x
+ * @param y Nova coordenada y
+ * @return true se movido, false se a referencia nao resolver ou as coordenadas forem invalidas ou estiverem ocupadas
+ */
+bool moverVertice(Grafo* grafo, RefVertice ref, int x, int y);
+
+/**
+ * @brief Muda a frequencia de um vertice e liga-o as antenas da nova frequencia
+ * Em caso de falha de memoria o grafo fica como estava
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia do vertice
+ * @param frequencia Nova frequencia
+ * @return true se alterado, false se a referencia nao resolver ou faltar memoria
+ */
+bool alterarFrequencia(Grafo* grafo, RefVertice ref, char frequencia);
+
+/**
+ * @brief Obtem uma referencia estavel (id + geracao) para o vertice com um dado id
+ * As funcoes que alteram o grafo recebem referencias, para que um vertice ja removido (e libertado)
+ * ou cujo id foi reutilizado seja recusado em vez de ser lido
+ * @param grafo Apontador para o grafo
+ * @param id Id do vertice
+ * @return Referencia (id -1 se nao houver vertice com esse id)
+ */
+RefVertice obterReferencia(Grafo* grafo, int id);
+
+/**
+ * @brief Resolve uma referencia para o vertice, detetando referencias antigas
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia obtida com obterReferencia
+ * @return Apontador para o vertice ou NULL se ele ja tiver sido removido
+ */
+NoVertice* resolverReferencia(Grafo* grafo, RefVertice ref);
+
 /**
  * @brief Carrega os dados das antenas de um ficheiro para um grafo
  * @param nomeFicheiro Nome do ficheiro a ser lido
@@ -58,6 +177,23 @@ bool adicionarAresta(Grafo* grafo, NoVertice* origem, NoVertice* destino);
  */
 Grafo* carregarDadosGrafo(const char* nomeFicheiro);
 
+/**
+ * @brief Grava o grafo num instantaneo binario (metrica dos pesos, vertices, indice de frequencias e adjacencia compacta)
+ * @param grafo Apontador para o grafo
+ * @param nomeFicheiro Nome do ficheiro a gravar
+ * @return true se gravado com sucesso, false caso contrario
+ */
+bool gravarGrafoBinario(Grafo* grafo, const char* nomeFicheiro);
+
+/**
+ * @brief Carrega um grafo a partir de um instantaneo binario
+ * Os vertices e as arestas sao reservados em dois blocos contiguos, sem um malloc por estrutura
+ * @param nomeFicheiro Nome do ficheiro a ler
+ * @return Apontador para o grafo criado ou NULL se o ficheiro nao existir, estiver corrompido ou
+ * nao descrever um grafo valido (ids ou coordenadas repetidos, arestas entre frequencias diferentes)
+ */
+Grafo* carregarGrafoBinario(const char* nomeFicheiro);
+
 /**
  * @brief Busca em profundidade a partir de um vertice
  * @param grafo Apontador para o grafo
@@ -80,6 +216,53 @@ bool buscaEmProfundidade(Grafo* grafo, NoVertice* verticeInicial, bool* visitado
  */
 bool buscaEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, NoVertice*** resultado, int* tamanhoResultado);
 
+/**
+ * @brief Caminho de custo minimo entre dois vertices (Dijkstra)
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total (pode ser NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+bool caminhoMaisBarato(Grafo* grafo, NoVertice* origem, NoVertice* destino, NoVertice*** caminho, int* tamanhoCaminho, double* custo);
+
+/**
+ * @brief Caminho de custo minimo entre dois vertices (A* com a distancia em linha reta como heuristica)
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total (pode ser NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+bool caminhoMaisBaratoAEstrela(Grafo* grafo, NoVertice* origem, NoVertice* destino, NoVertice*** caminho, int* tamanhoCaminho, double* custo);
+
+/**
+ * @brief Caminho com o menor numero de saltos entre dois vertices (pesquisa em largura bidirecional)
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice de origem
+ * @param destino Vertice de destino
+ * @param saltos Apontador para o numero de arestas do caminho
+ * @param caminho Array alocado com o caminho da origem ao destino (pode ser NULL se so interessar o numero de saltos)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho (pode ser NULL com caminho NULL)
+ * @return true se existe caminho, false caso contrario
+ */
+bool caminhoMenosSaltos(Grafo* grafo, NoVertice* origem, NoVertice* destino, int* saltos, NoVertice*** caminho, int* tamanhoCaminho);
+
+/**
+ * @brief Distancias em saltos de varias origens para todos os vertices, processando ate 64 origens por passagem
+ * @param grafo Apontador para o grafo
+ * @param origens Array com os vertices de origem
+ * @param numOrigens Numero de origens
+ * @param distancias Matriz numOrigens x grafo->limiteIds (linha i = origem i, coluna = id do vertice)
+ * preenchida com o numero de saltos ou -1 se o vertice nao for alcancado
+ * @return true se as distancias foram calculadas, false caso contrario
+ */
+bool distanciasMultiplasOrigens(Grafo* grafo, NoVertice** origens, int numOrigens, int* distancias);
+
 /**
  * @brief Inicializa uma fila vazia
  * @return Apontador para a fila criada
@@ -185,6 +368,97 @@ bool libertarCaminhos(ListaCaminho* caminhos);
  */
 bool encontrarIntersecoes(Grafo* grafo, char frequenciaA, char frequenciaB, Intersecao* intersecoes, int* tamanhoIntersecoes, int maxIntersecoes);
 
+/**
+ * @brief Inicia um iterador sobre os vertices de uma frequencia
+ * @param iterador Apontador para o iterador
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia a percorrer
+ * @return true se o iterador foi iniciado, false caso contrario
+ */
+bool iniciarIteradorFrequencia(IteradorFrequencia* iterador, Grafo* grafo, char frequencia);
+
+/**
+ * @brief Devolve o vertice seguinte da frequencia
+ * @param iterador Apontador para o iterador
+ * @return Apontador para o vertice ou NULL quando nao ha mais vertices
+ */
+NoVertice* proximoVerticeFrequencia(IteradorFrequencia* iterador);
+
+/**
+ * @brief Termina um iterador de frequencia
+ * @param iterador Apontador para o iterador
+ * @return true se terminado com sucesso, false caso contrario
+ */
+bool fecharIteradorFrequencia(IteradorFrequencia* iterador);
+
+/**
+ * @brief Inicia um iterador sobre as intersecoes entre antenas de duas frequencias
+ * @param iterador Apontador para o iterador
+ * @param grafo Apontador para o grafo
+ * @param frequenciaA Frequencia A
+ * @param frequenciaB Frequencia B
+ * @return true se o iterador foi iniciado, false caso contrario
+ */
+bool iniciarIteradorIntersecoes(IteradorIntersecoes* iterador, Grafo* grafo, char frequenciaA, char frequenciaB);
+
+/**
+ * @brief Produz a intersecao seguinte
+ * @param iterador Apontador para o iterador
+ * @param intersecao Apontador onde e escrita a intersecao
+ * @return true se foi produzida uma intersecao, false quando nao ha mais
+ */
+bool proximaIntersecao(IteradorIntersecoes* iterador, Intersecao* intersecao);
+
+/**
+ * @brief Termina um iterador de intersecoes
+ * @param iterador Apontador para o iterador
+ * @return true se terminado com sucesso, false caso contrario
+ */
+bool fecharIteradorIntersecoes(IteradorIntersecoes* iterador);
+
+/**
+ * @brief Calcula os pontos onde as ligacoes da frequencia A cruzam as ligacoes da frequencia B
+ * Com cruzamentos igual a NULL a funcao funciona em modo de contagem.
+ * Varrimento de Bentley-Ottmann sobre os segmentos de A e de B juntos: custo
+ * O((|EA| + |EB| + I) log(|EA| + |EB|)), em que I e o numero de pontos de intersecao entre todos
+ * esses segmentos (incluindo os cruzamentos dentro da mesma frequencia, que o varrimento tem de
+ * processar para manter a ordem do estado). Os cruzamentos sao devolvidos pela ordem do varrimento
+ * (x e depois y). Com coordenadas de valor absoluto a partir de 2^19 testa todos os pares.
+ * @param grafo Apontador para o grafo
+ * @param frequenciaA Frequencia A
+ * @param frequenciaB Frequencia B (diferente de A)
+ * @param cruzamentos Array para armazenar os cruzamentos ou NULL para apenas contar
+ * @param maxCruzamentos Capacidade do array de cruzamentos
+ * @param totalCruzamentos Apontador para o numero total de cruzamentos (mesmo os que nao couberam no array)
+ * @return true se pelo menos um cruzamento foi encontrado, false caso contrario
+ */
+bool calcularCruzamentos(Grafo* grafo, char frequenciaA, char frequenciaB, Cruzamento* cruzamentos, int maxCruzamentos, int* totalCruzamentos);
+
+/**
+ * @brief Calcula os efeitos nefastos a partir das arestas do grafo, sem carregar o mapa na Fase1
+ * Cada aresta nao dirigida entre antenas da mesma frequencia e visitada uma vez e da origem a dois
+ * efeitos; o array fica ordenado por linha e coluna, como a lista de efeitos da Fase1
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia das antenas (0..255) ou -1 para todas
+ * @param efeitos Array alocado com os efeitos (a libertar pelo chamador; NULL se nao houver efeitos)
+ * @param numEfeitos Apontador para o numero de efeitos
+ * @return true se os efeitos foram calculados, false em caso de erro
+ */
+bool calcularEfeitosNefastos(Grafo* grafo, int frequencia, EfeitoNefasto** efeitos, int* numEfeitos);
+
+/**
+ * @brief Processa em lote os mapas de um diretorio ou manifesto: carrega cada um em grafo, calcula os
+ * efeitos nefastos e grava o instantaneo binario, com numTrabalhadores threads e uma fila limitada
+ * Escreve uma linha de resumo por mapa (antenas, efeitos, celulas afetadas e tempos de cada etapa)
+ * @param entrada Diretorio com mapas ou ficheiro manifesto (um caminho por linha)
+ * @param pastaSaida Pasta onde gravar o instantaneo de cada mapa (NULL para nao gravar)
+ * @param resumo Destino das linhas de resumo (NULL para stdout)
+ * @param numTrabalhadores Numero de threads
+ * @param capacidadeFila Numero maximo de mapas em espera
+ * @return Numero de mapas processados com sucesso ou -1 em caso de erro
+ */
+int processarLoteGrafos(const char* entrada, const char* pastaSaida, FILE* resumo, int numTrabalhadores, int capacidadeFila);
+
 /**
  * @brief Encontra o vertice com as coordenadas especificadas
  * @param grafo Apontador para o grafo
@@ -204,4 +478,380 @@ NoVertice* encontrarVerticePorCoordenadas(Grafo* grafo, int x, int y);
  */
 bool encontrarVerticesPorFrequencia(Grafo* grafo, char frequencia, NoVertice** vertices, int* tamanhoVertices, int maxVertices);;
 
+/**
+ * @brief Devolve os vertices de uma frequencia sem copiar (vista sobre o indice de frequencias)
+ * A vista deixa de ser valida quando o grafo e alterado
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia a ser procurada
+ * @param tamanho Apontador para o numero de vertices da frequencia
+ * @return Array so de leitura com os vertices ou NULL se nao existirem
+ */
+NoVertice* const* obterVerticesFrequencia(Grafo* grafo, char frequencia, int* tamanho);
+
+/**
+ * @brief Devolve o id do componente conexo de um vertice
+ * O indice union-find acompanha as insercoes em tempo quase constante, mas nao sabe separar
+ * componentes: depois de uma remocao de arestas (removerVertice ou alterarFrequencia de um vertice
+ * ligado) a consulta seguinte, desta funcao ou das outras de componentes, reconstroi-o em O(V + E).
+ * Alternar remocoes e consultas custa portanto O(V + E) por consulta; agrupar as remocoes amortiza-o
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ * @return Id do componente (id do vertice representante) ou -1 em caso de erro
+ */
+int encontrarComponente(Grafo* grafo, NoVertice* vertice);
+
+/**
+ * @brief Verifica se dois vertices estao no mesmo componente conexo
+ * @param grafo Apontador para o grafo
+ * @param a Apontador para o primeiro vertice
+ * @param b Apontador para o segundo vertice
+ * @return true se existe caminho entre os dois, false caso contrario
+ */
+bool mesmoComponente(Grafo* grafo, NoVertice* a, NoVertice* b);
+
+/**
+ * @brief Devolve o numero de vertices do componente de um vertice
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ * @return Tamanho do componente ou 0 em caso de erro
+ */
+int tamanhoComponente(Grafo* grafo, NoVertice* vertice);
+
+/**
+ * @brief Devolve o numero de componentes conexos do grafo
+ * @param grafo Apontador para o grafo
+ * @return Numero de componentes ou 0 se o grafo for NULL
+ */
+int numeroComponentes(Grafo* grafo);
+
+/**
+ * @brief Devolve o membro seguinte do componente, permitindo percorre-lo sem alocar memoria
+ * @param grafo Apontador para o grafo
+ * @param membro Apontador para o membro atual
+ * @return Apontador para o membro seguinte ou NULL em caso de erro
+ */
+NoVertice* proximoMembroComponente(Grafo* grafo, NoVertice* membro);
+
+/**
+ * @brief Lista todos os vertices do componente de um vertice
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para um vertice do componente
+ * @param membros Array alocado com os membros do componente (a libertar pelo chamador)
+ * @param tamanhoMembros Apontador para o numero de membros
+ * @return true se o componente foi listado, false caso contrario
+ */
+bool listarComponente(Grafo* grafo, NoVertice* vertice, NoVertice*** membros, int* tamanhoMembros);
+
+/**
+ * @brief Congela o grafo numa representacao compacta com os vertices reordenados para localidade
+ * A adjacencia e renumerada para os novos indices; alteracoes posteriores ao grafo nao se refletem na copia
+ * @param grafo Apontador para o grafo
+ * @param ordem Ordem pretendida para os vertices
+ * @return Apontador para o grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* congelarGrafo(Grafo* grafo, OrdemVertices ordem);
+
+/**
+ * @brief Cria um novo grafo compacto a partir do anterior, reconstruindo so os vertices alterados
+ * Os vertices que ja existiam mantem a ordem relativa do anterior e os novos ficam no fim, por
+ * isso a linha de um vertice nao alterado e copiada do anterior so com os indices traduzidos
+ * (continua ordenada) e os pesos copiados; as linhas dos alterados sao construidas a partir do
+ * grafo, como em congelarGrafo. Um vertice tem de ser marcado como alterado se a sua lista de
+ * adjacencia, a sua antena ou a posicao de algum vizinho mudou (incluindo ids reutilizados).
+ * Se o anterior estiver comprimido, ou se mais de 1/COMPACTO_FORA_DE_ORDEM dos vertices ficar
+ * fora da ordem pedida, faz um congelamento completo.
+ * @param grafo Apontador para o grafo
+ * @param anterior Grafo compacto anterior do mesmo grafo
+ * @param alterados Marca de cada id do grafo (os ids a partir de numAlterados contam como alterados)
+ * @param numAlterados Tamanho do array alterados
+ * @return Apontador para o novo grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* atualizarGrafoCompacto(Grafo* grafo, const GrafoCompacto* anterior, const bool* alterados, int numAlterados);
+
+/**
+ * @brief Liberta a memoria de um grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @return true se libertado com sucesso, false caso contrario
+ */
+bool libertarGrafoCompacto(GrafoCompacto* compacto);
+
+/**
+ * @brief Busca em largura sobre o grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param distancias Array com numVertices posicoes, preenchido com o numero de saltos ou -1 se inalcancavel
+ * @return Numero de vertices alcancados (incluindo a origem) ou -1 em caso de erro
+ */
+int buscaEmLarguraCompacta(const GrafoCompacto* compacto, int origem, int* distancias);
+
+/**
+ * @brief Comprime a adjacencia do grafo compacto (diferencas entre vizinhos ordenados em varint)
+ * Os arrays vizinhos e pesos sao libertados; os pesos passam a ser calculados a partir das posicoes
+ * @param compacto Apontador para o grafo compacto
+ * @return true se comprimido (ou ja estava), false em caso de erro
+ */
+bool comprimirAdjacencia(GrafoCompacto* compacto);
+
+/**
+ * @brief Constroi o grafo compacto ja comprimido diretamente a partir de um mapa de texto
+ * Produz a mesma adjacencia que carregarDadosGrafoParalelo seguido de congelarGrafo e
+ * comprimirAdjacencia (ids pela ordem do ficheiro, cada antena ligada a todas as outras da sua
+ * frequencia), mas sem criar o grafo de apontadores nem os arrays vizinhos/pesos: as linhas sao
+ * codificadas a partir dos grupos de frequencia. O grafo resultante nao tem deslocamentos.
+ * @param nomeFicheiro Nome do ficheiro a ler
+ * @param ordem Ordem pretendida para os vertices
+ * @param metrica Metrica dos pesos
+ * @return Apontador para o grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* carregarGrafoComprimido(const char* nomeFicheiro, OrdemVertices ordem, MetricaPeso metrica);
+
+/**
+ * @brief Memoria ocupada pelo grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @return Numero de bytes alocados ou 0 se o grafo for NULL
+ */
+size_t memoriaGrafoCompacto(GrafoCompacto* compacto);
+
+/**
+ * @brief Inicia um iterador sobre os vizinhos de um vertice do grafo compacto
+ * @param iterador Apontador para o iterador
+ * @param compacto Apontador para o grafo compacto
+ * @param vertice Indice compacto do vertice
+ * @return true se o iterador foi iniciado, false caso contrario
+ */
+bool iniciarIteradorVizinhos(IteradorVizinhos* iterador, const GrafoCompacto* compacto, int vertice);
+
+/**
+ * @brief Devolve o vizinho seguinte, por ordem crescente de indice
+ * @param iterador Apontador para o iterador
+ * @return Indice compacto do vizinho ou -1 quando nao houver mais
+ */
+int proximoVizinho(IteradorVizinhos* iterador);
+
+/**
+ * @brief Verifica se existe aresta entre dois vertices do grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @return true se a aresta existir, false caso contrario
+ */
+bool existeArestaCompacta(const GrafoCompacto* compacto, int origem, int destino);
+
+/**
+ * @brief Peso da aresta entre dois vertices do grafo compacto, segundo a metrica do grafo de origem
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @return Peso da aresta ou -1 se nao existir
+ */
+double pesoArestaCompacta(const GrafoCompacto* compacto, int origem, int destino);
+
+/**
+ * @brief Busca em profundidade sobre o grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param ordem Array com numVertices posicoes, preenchido com os vertices pela ordem de visita
+ * @return Numero de vertices visitados ou -1 em caso de erro
+ */
+int buscaEmProfundidadeCompacta(const GrafoCompacto* compacto, int origem, int* ordem);
+
+/**
+ * @brief Vertices de uma frequencia no grafo compacto
+ * @param compacto Apontador para o grafo compacto
+ * @param frequencia Frequencia pretendida
+ * @param tamanho Apontador para o numero de vertices da frequencia
+ * @return Indices compactos dos vertices, por ordem crescente (nao libertar), ou NULL se nao houver
+ */
+const int* verticesFrequenciaCompacta(const GrafoCompacto* compacto, char frequencia, int* tamanho);
+
+/**
+ * @brief Caminho com o menor numero de saltos entre dois vertices do grafo compacto (pesquisa em largura)
+ * So le o grafo compacto, por isso pode ser usado sem bloqueios num instantaneo fixado
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @return true se existe caminho, false caso contrario ou em caso de erro
+ */
+bool caminhoMenosSaltosCompacto(const GrafoCompacto* compacto, int origem, int destino, int** caminho, int* tamanhoCaminho);
+
+/**
+ * @brief Caminho de custo minimo entre dois vertices do grafo compacto (Dijkstra)
+ * Os pesos sao os do grafo de origem, calculados a partir das posicoes; so le o grafo compacto,
+ * por isso pode ser usado sem bloqueios num instantaneo fixado
+ * @param compacto Apontador para o grafo compacto
+ * @param origem Indice compacto da origem
+ * @param destino Indice compacto do destino
+ * @param caminho Array alocado com o caminho da origem ao destino (a libertar pelo chamador)
+ * @param tamanhoCaminho Apontador para o numero de vertices do caminho
+ * @param custo Apontador para o custo total do caminho
+ * @return true se existe caminho, false caso contrario ou em caso de erro
+ */
+bool caminhoMaisBaratoCompacto(const GrafoCompacto* compacto, int origem, int destino, int** caminho, int* tamanhoCaminho, double* custo);
+
+/**
+ * @brief Cria um grafo partilhado a partir de um grafo, que passa a pertencer-lhe
+ * @param grafo Apontador para o grafo (nao deve voltar a ser usado diretamente)
+ * @param ordem Ordem dos vertices nos instantaneos publicados
+ * @return Apontador para o grafo partilhado ou NULL em caso de erro
+ */
+GrafoPartilhado* criarGrafoPartilhado(Grafo* grafo, OrdemVertices ordem);
+
+/**
+ * @brief Liberta o grafo partilhado; nenhuma thread pode ter instantaneos fixados
+ * @param partilhado Apontador para o grafo partilhado
+ * @return true se libertado com sucesso, false caso contrario
+ */
+bool libertarGrafoPartilhado(GrafoPartilhado* partilhado);
+
+/**
+ * @brief Fixa o instantaneo atual para leitura, sem bloquear
+ * O instantaneo mantem-se valido e imutavel ate libertarInstantaneo
+ * @param partilhado Apontador para o grafo partilhado
+ * @param bilhete Apontador onde guardar o bilhete a entregar em libertarInstantaneo
+ * @return Instantaneo fixado ou NULL em caso de erro
+ */
+const GrafoCompacto* fixarInstantaneo(GrafoPartilhado* partilhado, int* bilhete);
+
+/**
+ * @brief Liberta um instantaneo fixado com fixarInstantaneo
+ * @param partilhado Apontador para o grafo partilhado
+ * @param bilhete Bilhete devolvido por fixarInstantaneo
+ * @return true se libertado, false caso contrario
+ */
+bool libertarInstantaneo(GrafoPartilhado* partilhado, int bilhete);
+
+/**
+ * @brief Aplica um lote de alteracoes e publica um novo instantaneo
+ * O novo instantaneo e criado com atualizarGrafoCompacto a partir do atual: so as linhas dos
+ * vertices alterados no lote (e dos seus vizinhos) sao reconstruidas a partir do mestre. Se o lote
+ * nao tocar em nenhum vertice, o instantaneo atual continua publicado.
+ * Os escritores sao serializados; o instantaneo anterior e libertado quando deixar de ter leitores
+ * @param partilhado Apontador para o grafo partilhado
+ * @param alteracoes Array de alteracoes
+ * @param numAlteracoes Numero de alteracoes
+ * @return Numero de alteracoes aplicadas ou -1 se o novo instantaneo nao puder ser criado
+ */
+int aplicarAlteracoes(GrafoPartilhado* partilhado, const Alteracao* alteracoes, int numAlteracoes);
+
+/**
+ * @brief Le um ficheiro inteiro para memoria
+ * O tamanho e obtido com 64 bits e a leitura e feita em varios fread de tamanho limitado
+ * @param nomeFicheiro Nome do ficheiro
+ * @param tamanho Apontador para o numero de bytes lidos
+ * @return Buffer alocado com o conteudo (a libertar pelo chamador) ou NULL em caso de erro
+ */
+unsigned char* lerFicheiroCompleto(const char* nomeFicheiro, size_t* tamanho);
+
+/**
+ * @brief Carrega o mapa de antenas usando varias threads (OpenMP) para a leitura e para as arestas
+ * Produz o mesmo grafo que carregarDadosGrafo, com os ids atribuidos pela ordem do ficheiro.
+ * O ficheiro e lido em trechos de tamanho fixo, sem o carregar inteiro para memoria
+ * @param nomeFicheiro Nome do ficheiro a ler
+ * @param numThreads Numero de threads a usar (0 para o valor por omissao do OpenMP); so se aplica
+ * a esta chamada, o valor global do OpenMP nao e alterado
+ * @return Apontador para o grafo criado ou NULL em caso de erro
+ */
+Grafo* carregarDadosGrafoParalelo(const char* nomeFicheiro, int numThreads);
+
+/**
+ * @brief Constroi o indice espacial (arvores k-d) com as antenas do grafo
+ * O indice guarda ids; as alteracoes ao grafo devem ser refletidas com inserirIndiceEspacial e removerIndiceEspacial
+ * @param grafo Apontador para o grafo
+ * @return Apontador para o indice ou NULL em caso de erro
+ */
+IndiceEspacial* construirIndiceEspacial(Grafo* grafo);
+
+/**
+ * @brief Reconstroi todas as arvores do indice, equilibradas e sem os nos removidos
+ * @param indice Apontador para o indice
+ * @return true se reconstruido com sucesso, false caso contrario
+ */
+bool reconstruirIndiceEspacial(IndiceEspacial* indice);
+
+/**
+ * @brief Insere um vertice no indice (arvore global e arvore da sua frequencia)
+ * A arvore e reconstruida quando a insercao a deixa demasiado desequilibrada
+ * @param indice Apontador para o indice
+ * @param vertice Vertice a inserir
+ * @return true se inserido com sucesso, false caso contrario
+ */
+bool inserirIndiceEspacial(IndiceEspacial* indice, NoVertice* vertice);
+
+/**
+ * @brief Remove um vertice do indice (deve ser chamado antes de o remover do grafo)
+ * @param indice Apontador para o indice
+ * @param vertice Vertice a remover
+ * @return true se removido, false se nao estava no indice
+ */
+bool removerIndiceEspacial(IndiceEspacial* indice, NoVertice* vertice);
+
+/**
+ * @brief Procura as k antenas mais proximas de um ponto (distancia euclidiana)
+ * @param indice Apontador para o indice
+ * @param ponto Ponto de procura
+ * @param frequencia Frequencia das antenas (0..255) ou -1 para todas
+ * @param k Numero de antenas pretendidas
+ * @param ids Array com k posicoes para os ids, do mais proximo para o mais afastado
+ * @param distancias Array com k posicoes para as distancias ou NULL
+ * @return Numero de antenas encontradas (menor que k se o indice tiver menos antenas) ou -1 em caso de erro
+ */
+int vizinhosMaisProximos(const IndiceEspacial* indice, Coordenada ponto, int frequencia, int k, int* ids, double* distancias);
+
+/**
+ * @brief Procura as antenas a distancia menor ou igual a raio de um ponto
+ * Com ids igual a NULL a funcao funciona em modo de contagem
+ * @param indice Apontador para o indice
+ * @param centro Centro do circulo
+ * @param raio Raio do circulo
+ * @param frequencia Frequencia das antenas (0..255) ou -1 para todas
+ * @param ids Array para os ids encontrados ou NULL
+ * @param maxIds Capacidade do array de ids
+ * @return Numero total de antenas no circulo (mesmo as que nao couberam no array) ou -1 em caso de erro
+ */
+int antenasNoRaio(const IndiceEspacial* indice, Coordenada centro, double raio, int frequencia, int* ids, int maxIds);
+
+/**
+ * @brief Liberta o indice espacial
+ * @param indice Apontador para o indice
+ * @return true se libertado com sucesso, false caso contrario
+ */
+bool libertarIndiceEspacial(IndiceEspacial* indice);
+
+/**
+ * @brief Cria uma cache LRU de resultados de consultas sobre um grafo
+ * As entradas sao invalidadas por componente: so sao recalculadas se o componente da origem mudou
+ * @param grafo Apontador para o grafo
+ * @param capacidade Numero maximo de resultados guardados
+ * @return Apontador para a cache criada ou NULL em caso de erro
+ */
+CacheConsultas* criarCacheConsultas(Grafo* grafo, int capacidade);
+
+/**
+ * @brief Obtem o resultado de uma consulta, a partir da cache ou calculando-o
+ * @param cache Apontador para a cache
+ * @param tipo Tipo de consulta
+ * @param origem Vertice de origem (ainda no grafo: o apontador e lido)
+ * @param destino Vertice de destino (ainda no grafo; ignorado nas buscas)
+ * @param parametro Maximo de caminhos guardados em CONSULTA_CAMINHOS (0 = todos; ignorado nos outros tipos)
+ * @param resultado Apontador para o resultado em ids (valido ate a proxima chamada sobre a cache)
+ * @return true se o resultado foi obtido, false em caso de erro
+ */
+bool consultarCache(CacheConsultas* cache, TipoConsulta tipo, NoVertice* origem, NoVertice* destino, int parametro, ResultadoConsulta* resultado);
+
+/**
+ * @brief Descarta todos os resultados guardados (os contadores mantem-se)
+ * @param cache Apontador para a cache
+ * @return true se a cache foi limpa, false caso contrario
+ */
+bool limparCacheConsultas(CacheConsultas* cache);
+
+/**
+ * @brief Liberta a cache de consultas
+ * @param cache Apontador para a cache
+ * @return true se libertada com sucesso, false caso contrario
+ */
+bool libertarCacheConsultas(CacheConsultas* cache);
+
 #endif // GRAFO_H
\ No newline at end of file
@@ -0,0 +1,304 @@
+/**
+ * @file instantaneo.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Gravacao e leitura do grafo num instantaneo binario compacto
+ * @details O ficheiro tem um cabecalho (com a metrica dos pesos) seguido de um bloco de inteiros de 32 bits:
+ * tabela de vertices (x, y, frequencia), indice de frequencias (tamanho de cada grupo
+ * seguido dos ids dos membros) e adjacencia compacta (deslocamentos + destinos).
+ * A leitura carrega o ficheiro para um buffer (em varios fread), reserva os vertices e as arestas
+ * em dois blocos contiguos (reservarBlocosGrafo, sem um malloc por estrutura) e liga os
+ * apontadores a partir dos ids e dos deslocamentos, evitando voltar a interpretar o mapa de texto
+ * e a construir as arestas.
+ * Os inteiros sao gravados na ordem de bytes da maquina.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#if !defined(_WIN32)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64    // off_t de 64 bits para fseeko/ftello
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // declara fseeko/ftello com -std=c11
+#endif
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "grafo.h"
+#include "struct.h"
+
+#define INSTANTANEO_MAGICO 0x47414445u // "EDAG"
+#define INSTANTANEO_VERSAO 2u
+#define INSTANTANEO_LEITURA ((size_t)64 << 20) // bytes pedidos em cada fread
+
+// posicoes em ficheiros de mais de 2 GiB (long tem 32 bits no Windows)
+#ifdef _WIN32
+#define fseekGrande(fp, posicao, origem) _fseeki64((fp), (long long)(posicao), (origem))
+#define ftellGrande(fp) ((long long)_ftelli64(fp))
+#else
+#define fseekGrande(fp, posicao, origem) fseeko((fp), (off_t)(posicao), (origem))
+#define ftellGrande(fp) ((long long)ftello(fp))
+#endif
+
+/**
+ * @brief Cabecalho do instantaneo binario
+ */
+typedef struct CabecalhoInstantaneo {
+    uint32_t magico;        // identificador do formato
+    uint32_t versao;        // versao do formato
+    uint32_t numVertices;   // numero de vertices
+    uint32_t numArestas;    // numero de arestas dirigidas
+    uint32_t numPalavras;   // numero de inteiros de 32 bits do bloco de dados
+    uint32_t metrica;       // metrica dos pesos das arestas (MetricaPeso)
+    uint32_t soma;          // soma de verificacao (FNV-1a) do bloco de dados
+} CabecalhoInstantaneo;
+
+/**
+ * @brief Soma de verificacao FNV-1a de 32 bits
+ * @param dados Bytes a verificar
+ * @param tamanho Numero de bytes
+ * @return Valor da soma
+ */
+static uint32_t somaVerificacao(const unsigned char* dados, size_t tamanho) {
+    uint32_t soma = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        soma ^= dados[i];
+        soma *= 16777619u;
+    }
+    return soma;
+}
+
+/**
+ * @brief Numero de inteiros do bloco de dados para um grafo com V vertices e E arestas
+ */
+static size_t palavrasInstantaneo(uint32_t numVertices, uint32_t numArestas) {
+    return (size_t)numVertices * 3 + NUM_FREQUENCIAS + numVertices + (size_t)numVertices + 1 + numArestas;
+}
+
+/**
+ * @brief Grava o grafo num instantaneo binario
+ * @param grafo Apontador para o grafo
+ * @param nomeFicheiro Nome do ficheiro a gravar
+ * @return true se gravado com sucesso, false caso contrario
+ */
+bool gravarGrafoBinario(Grafo* grafo, const char* nomeFicheiro) {
+    if (grafo == NULL || nomeFicheiro == NULL) return false;
+    uint32_t numVertices = (uint32_t)grafo->numVertices;
+    uint32_t numArestas = (uint32_t)grafo->numArestas;
+    size_t numPalavras = palavrasInstantaneo(numVertices, numArestas);
+    int32_t* dados = (int32_t*)malloc(numPalavras * sizeof(int32_t));
+    if (dados == NULL) return false;
+
+    int32_t* vertices = dados;
+    int32_t* tamanhosGrupos = vertices + (size_t)numVertices * 3;
+    int32_t* membros = tamanhosGrupos + NUM_FREQUENCIAS;
+    int32_t* deslocamentos = membros + numVertices;
+    int32_t* destinos = deslocamentos + numVertices + 1;
+
+    // os ids podem ter buracos (vertices removidos): o ficheiro usa ids densos 0..V-1
+    NoVertice** ordem = (NoVertice**)malloc((numVertices > 0 ? numVertices : 1) * sizeof(NoVertice*));
+    int* densos = (int*)malloc((grafo->limiteIds > 0 ? grafo->limiteIds : 1) * sizeof(int));
+    if (ordem == NULL || densos == NULL) {
+        free(ordem);
+        free(densos);
+        free(dados);
+        return false;
+    }
+    uint32_t n = 0;
+    for (int id = 0; id < grafo->limiteIds; id++) {
+        densos[id] = -1;
+        if (grafo->vertices[id] == NULL) continue;
+        densos[id] = (int)n;
+        ordem[n++] = grafo->vertices[id];
+    }
+
+    for (uint32_t i = 0; i < numVertices; i++) {
+        NoVertice* v = ordem[i];
+        vertices[i * 3] = v->dados.posicao.x;
+        vertices[i * 3 + 1] = v->dados.posicao.y;
+        vertices[i * 3 + 2] = (unsigned char)v->dados.frequencia;
+    }
+    int posicao = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        GrupoFrequencia* grupo = &grafo->frequencias[f];
+        tamanhosGrupos[f] = grupo->tamanho;
+        for (int k = 0; k < grupo->tamanho; k++) membros[posicao++] = densos[grupo->membros[k]->id];
+    }
+    uint32_t aresta = 0;
+    for (uint32_t i = 0; i < numVertices; i++) {
+        deslocamentos[i] = (int32_t)aresta;
+        for (Aresta* a = ordem[i]->primeiraAresta; a != NULL; a = a->proxima) {
+            destinos[aresta++] = densos[a->destino->id];
+        }
+    }
+    deslocamentos[numVertices] = (int32_t)aresta;
+    free(ordem);
+    free(densos);
+
+    CabecalhoInstantaneo cabecalho;
+    cabecalho.magico = INSTANTANEO_MAGICO;
+    cabecalho.versao = INSTANTANEO_VERSAO;
+    cabecalho.numVertices = numVertices;
+    cabecalho.numArestas = numArestas;
+    cabecalho.numPalavras = (uint32_t)numPalavras;
+    cabecalho.metrica = (uint32_t)grafo->metrica;
+    cabecalho.soma = somaVerificacao((const unsigned char*)dados, numPalavras * sizeof(int32_t));
+
+    FILE* fp = fopen(nomeFicheiro, "wb");
+    if (fp == NULL) {
+        free(dados);
+        return false;
+    }
+    bool sucesso = fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+        fwrite(dados, sizeof(int32_t), numPalavras, fp) == numPalavras;
+    if (fclose(fp) != 0) sucesso = false;
+    free(dados);
+    return sucesso;
+}
+
+/**
+ * @brief Le um ficheiro inteiro para memoria
+ * O tamanho e obtido com 64 bits (long tem 32 bits no Windows) e a leitura e feita em blocos de
+ * INSTANTANEO_LEITURA bytes, para ficheiros maiores do que um unico fread aceita
+ * @param nomeFicheiro Nome do ficheiro
+ * @param tamanho Apontador para o numero de bytes lidos
+ * @return Buffer alocado com o conteudo (a libertar pelo chamador) ou NULL em caso de erro
+ */
+unsigned char* lerFicheiroCompleto(const char* nomeFicheiro, size_t* tamanho) {
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    if (fp == NULL) return NULL;
+    if (fseekGrande(fp, 0, SEEK_END) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+    long long fim = ftellGrande(fp);
+    if (fim < 0 || (unsigned long long)fim > SIZE_MAX || fseekGrande(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+    size_t total = (size_t)fim;
+    unsigned char* buffer = (unsigned char*)malloc(total > 0 ? total : 1);
+    if (buffer == NULL) {
+        fclose(fp);
+        return NULL;
+    }
+    for (size_t lidos = 0; lidos < total;) {
+        size_t pedidos = total - lidos < INSTANTANEO_LEITURA ? total - lidos : INSTANTANEO_LEITURA;
+        if (fread(buffer + lidos, 1, pedidos, fp) != pedidos) {
+            free(buffer);
+            fclose(fp);
+            return NULL;
+        }
+        lidos += pedidos;
+    }
+    fclose(fp);
+    *tamanho = total;
+    return buffer;
+}
+
+/**
+ * @brief Carrega um grafo a partir de um instantaneo binario
+ * Os vertices e as arestas ficam em dois blocos contiguos (dois malloc no total); os que forem
+ * removidos depois so sao libertados com o grafo
+ * @param nomeFicheiro Nome do ficheiro a ler
+ * @return Apontador para o grafo criado ou NULL se o ficheiro nao existir ou estiver corrompido
+ * (incluindo ids repetidos no indice de frequencias, coordenadas repetidas ou arestas entre
+ * frequencias diferentes)
+ */
+Grafo* carregarGrafoBinario(const char* nomeFicheiro) {
+    if (nomeFicheiro == NULL) return NULL;
+    size_t tamanho = 0;
+    unsigned char* buffer = lerFicheiroCompleto(nomeFicheiro, &tamanho);
+    if (buffer == NULL) return NULL;
+
+    // validacao do cabecalho e da soma antes de confiar em qualquer indice
+    CabecalhoInstantaneo cabecalho;
+    if (tamanho < sizeof(cabecalho)) {
+        free(buffer);
+        return NULL;
+    }
+    memcpy(&cabecalho, buffer, sizeof(cabecalho));
+    size_t numPalavras = palavrasInstantaneo(cabecalho.numVertices, cabecalho.numArestas);
+    if (cabecalho.magico != INSTANTANEO_MAGICO || cabecalho.versao != INSTANTANEO_VERSAO ||
+        cabecalho.numVertices > INT32_MAX || cabecalho.numArestas > INT32_MAX ||
+        cabecalho.numPalavras != numPalavras || cabecalho.metrica > (uint32_t)METRICA_MANHATTAN ||
+        tamanho != sizeof(cabecalho) + numPalavras * sizeof(int32_t)) {
+        free(buffer);
+        return NULL;
+    }
+    const unsigned char* bytes = buffer + sizeof(cabecalho);
+    if (somaVerificacao(bytes, numPalavras * sizeof(int32_t)) != cabecalho.soma) {
+        free(buffer);
+        return NULL;
+    }
+    // o cabecalho ocupa um numero inteiro de palavras, por isso o bloco fica alinhado
+    const int32_t* vertices = (const int32_t*)bytes;
+    int numVertices = (int)cabecalho.numVertices;
+    const int32_t* tamanhosGrupos = vertices + (size_t)numVertices * 3;
+    const int32_t* membros = tamanhosGrupos + NUM_FREQUENCIAS;
+    const int32_t* deslocamentos = membros + numVertices;
+    const int32_t* destinos = deslocamentos + numVertices + 1;
+
+    // vertices e arestas vem de dois blocos contiguos, por isso nenhum dos ciclos seguintes chama malloc
+    Grafo* grafo = inicializarGrafo();
+    bool valido = grafo != NULL && reservarBlocosGrafo(grafo, numVertices, (int)cabecalho.numArestas);
+    for (int i = 0; valido && i < numVertices; i++) {
+        Antena antena = { (char)vertices[i * 3 + 2], { vertices[i * 3], vertices[i * 3 + 1] } };
+        // anexarVertice nao procura coordenadas repetidas, por isso um ficheiro com duas antenas na mesma posicao e recusado aqui
+        if (encontrarVerticePorCoordenadas(grafo, antena.posicao.x, antena.posicao.y) != NULL) valido = false;
+        else valido = anexarVertice(grafo, antena) != NULL;
+    }
+
+    // as arestas sao acrescentadas no inicio da lista, por isso cada linha e percorrida ao contrario
+    for (int i = 0; valido && i < numVertices; i++) {
+        int inicio = deslocamentos[i];
+        int fim = deslocamentos[i + 1];
+        if (inicio < 0 || fim < inicio || fim > (int)cabecalho.numArestas) {
+            valido = false;
+            break;
+        }
+        for (int k = fim - 1; valido && k >= inicio; k--) {
+            // so antenas da mesma frequencia podem estar ligadas
+            if (destinos[k] < 0 || destinos[k] >= numVertices ||
+                grafo->vertices[destinos[k]]->dados.frequencia != grafo->vertices[i]->dados.frequencia) valido = false;
+            else valido = anexarAresta(grafo, grafo->vertices[i], grafo->vertices[destinos[k]]);
+        }
+    }
+
+    // repoe a ordem gravada do indice de frequencias; um id repetido deixaria outro vertice fora do grupo
+    bool* vistos = valido ? (bool*)calloc(numVertices > 0 ? (size_t)numVertices : 1, sizeof(bool)) : NULL;
+    if (vistos == NULL) valido = false;
+    int posicao = 0;
+    for (int f = 0; valido && f < NUM_FREQUENCIAS; f++) {
+        GrupoFrequencia* grupo = &grafo->frequencias[f];
+        if (tamanhosGrupos[f] != grupo->tamanho) {
+            valido = false;
+            break;
+        }
+        for (int k = 0; k < grupo->tamanho; k++) {
+            int id = membros[posicao++];
+            if (id < 0 || id >= numVertices || vistos[id] || (unsigned char)grafo->vertices[id]->dados.frequencia != f) {
+                valido = false;
+                break;
+            }
+            vistos[id] = true;
+            grupo->membros[k] = grafo->vertices[id];
+            grupo->membros[k]->posicaoGrupo = k;
+        }
+    }
+
+    free(vistos);
+    free(buffer);
+    if (valido) valido = emparelharArestasGemeas(grafo);
+    // as arestas foram anexadas com a metrica unitaria do grafo novo: repoe a gravada e os pesos
+    if (valido && cabecalho.metrica != (uint32_t)grafo->metrica) valido = definirMetricaPesos(grafo, (MetricaPeso)cabecalho.metrica);
+    if (!valido) {
+        libertarGrafo(grafo);
+        return NULL;
+    }
+    return grafo;
+}
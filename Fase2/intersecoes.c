@@ -0,0 +1,779 @@
+/**
+ * @file intersecoes.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Calculo geometrico dos cruzamentos entre ligacoes de duas frequencias
+ * @details Cada aresta do grafo e tratada como um segmento de reta entre as duas antenas.
+ * Os segmentos das frequencias A e B sao percorridos em conjunto por um varrimento de
+ * Bentley-Ottmann: uma fila de eventos com os extremos e os cruzamentos ja encontrados, e um
+ * estado com os segmentos que cortam a linha de varrimento, por ordem de y. Em cada evento so
+ * se testam os segmentos que ficam vizinhos no estado, por isso o custo depende do numero de
+ * intersecoes e nao do numero de pares. Os eventos e o estado sao comparados com aritmetica
+ * inteira exata (pontos racionais e produtos de 128 bits), para que os casos degenerados
+ * (varios segmentos pelo mesmo ponto, verticais, colineares) sejam tratados sem erros de arredondamento.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "grafo.h"
+#include "struct.h"
+
+#define LIMITE_VARRIMENTO (1 << 19) // coordenadas (em valor absoluto) em que as contas exatas do varrimento cabem em 128 bits
+#define PRECISAO_VARRIMENTO 1e-6   // diferenca a partir da qual a aproximacao decide a ordem de dois pontos
+
+/**
+ * @brief Segmento de reta associado a uma aresta, com os extremos ordenados por x
+ */
+typedef struct Segmento {
+    Coordenada inicio;      // extremo com menor x (e menor y em caso de empate)
+    Coordenada fim;         // extremo com maior x
+} Segmento;
+
+/**
+ * @brief Compara dois segmentos pelo x inicial (ordem do varrimento)
+ */
+static int compararSegmentos(const void* a, const void* b) {
+    const Segmento* s1 = (const Segmento*)a;
+    const Segmento* s2 = (const Segmento*)b;
+    if (s1->inicio.x != s2->inicio.x) return s1->inicio.x < s2->inicio.x ? -1 : 1;
+    if (s1->inicio.y != s2->inicio.y) return s1->inicio.y < s2->inicio.y ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Cria os segmentos de todas as arestas entre vertices de uma frequencia
+ * Cada aresta nao dirigida (par de arestas u->v e v->u) da origem a um unico segmento
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia dos segmentos
+ * @param segmentos Array alocado com os segmentos (a libertar pelo chamador)
+ * @param tamanho Apontador para o numero de segmentos
+ * @return true se os segmentos foram criados, false em caso de erro
+ */
+static bool construirSegmentos(Grafo* grafo, char frequencia, Segmento** segmentos, int* tamanho) {
+    *segmentos = NULL;
+    *tamanho = 0;
+    int numMembros = 0;
+    NoVertice* const* membros = obterVerticesFrequencia(grafo, frequencia, &numMembros);
+    int capacidade = 0;
+    for (int i = 0; i < numMembros; i++) {
+        for (Aresta* aresta = membros[i]->primeiraAresta; aresta != NULL; aresta = aresta->proxima) {
+            NoVertice* u = membros[i];
+            NoVertice* v = aresta->destino;
+            if (v->dados.frequencia != frequencia) continue;
+            if (v->id < u->id && aresta->gemea != NULL) continue; // ja contado a partir de v
+            if (*tamanho == capacidade) {
+                int novaCapacidade = capacidade > 0 ? capacidade * 2 : 16;
+                Segmento* novos = (Segmento*)realloc(*segmentos, novaCapacidade * sizeof(Segmento));
+                if (novos == NULL) {
+                    free(*segmentos);
+                    *segmentos = NULL;
+                    *tamanho = 0;
+                    return false;
+                }
+                *segmentos = novos;
+                capacidade = novaCapacidade;
+            }
+            Coordenada p = u->dados.posicao;
+            Coordenada q = v->dados.posicao;
+            Segmento* s = &(*segmentos)[(*tamanho)++];
+            if (p.x < q.x || (p.x == q.x && p.y <= q.y)) {
+                s->inicio = p;
+                s->fim = q;
+            }
+            else {
+                s->inicio = q;
+                s->fim = p;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Produto vetorial (b - a) x (c - a) em aritmetica inteira de 64 bits
+ */
+static long long orientacao(Coordenada a, Coordenada b, Coordenada c) {
+    return (long long)(b.x - a.x) * (c.y - a.y) - (long long)(b.y - a.y) * (c.x - a.x);
+}
+
+/**
+ * @brief Verifica se c esta dentro da caixa delimitada por a e b (c colinear com ab)
+ */
+static bool dentroCaixa(Coordenada a, Coordenada b, Coordenada c) {
+    return (c.x >= (a.x < b.x ? a.x : b.x)) && (c.x <= (a.x > b.x ? a.x : b.x)) &&
+        (c.y >= (a.y < b.y ? a.y : b.y)) && (c.y <= (a.y > b.y ? a.y : b.y));
+}
+
+/**
+ * @brief Testa se dois segmentos se cruzam e calcula o ponto de cruzamento
+ * Se os segmentos forem colineares e sobrepostos, devolve o inicio da sobreposicao
+ * @param a Segmento da frequencia A
+ * @param b Segmento da frequencia B
+ * @param x Apontador para a coordenada x do cruzamento
+ * @param y Apontador para a coordenada y do cruzamento
+ * @return true se os segmentos se cruzam, false caso contrario
+ */
+static bool cruzamentoSegmentos(const Segmento* a, const Segmento* b, double* x, double* y) {
+    long long o1 = orientacao(a->inicio, a->fim, b->inicio);
+    long long o2 = orientacao(a->inicio, a->fim, b->fim);
+    long long o3 = orientacao(b->inicio, b->fim, a->inicio);
+    long long o4 = orientacao(b->inicio, b->fim, a->fim);
+
+    if (o1 == 0 && o2 == 0) {
+        // colineares: cruzam se as projecoes se sobrepoem
+        Coordenada inicio = compararSegmentos(a, b) >= 0 ? a->inicio : b->inicio;
+        if (!dentroCaixa(a->inicio, a->fim, inicio) || !dentroCaixa(b->inicio, b->fim, inicio)) return false;
+        *x = inicio.x;
+        *y = inicio.y;
+        return true;
+    }
+
+    bool cruzam = ((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0));
+    if (!cruzam) {
+        // toque num extremo
+        if (o1 == 0 && dentroCaixa(a->inicio, a->fim, b->inicio)) { *x = b->inicio.x; *y = b->inicio.y; return true; }
+        if (o2 == 0 && dentroCaixa(a->inicio, a->fim, b->fim)) { *x = b->fim.x; *y = b->fim.y; return true; }
+        if (o3 == 0 && dentroCaixa(b->inicio, b->fim, a->inicio)) { *x = a->inicio.x; *y = a->inicio.y; return true; }
+        if (o4 == 0 && dentroCaixa(b->inicio, b->fim, a->fim)) { *x = a->fim.x; *y = a->fim.y; return true; }
+        return false;
+    }
+
+    double rx = a->fim.x - a->inicio.x;
+    double ry = a->fim.y - a->inicio.y;
+    double sx = b->fim.x - b->inicio.x;
+    double sy = b->fim.y - b->inicio.y;
+    double denominador = rx * sy - ry * sx;
+    double t = ((b->inicio.x - a->inicio.x) * sy - (b->inicio.y - a->inicio.y) * sx) / denominador;
+    *x = a->inicio.x + t * rx;
+    *y = a->inicio.y + t * ry;
+    return true;
+}
+
+/**
+ * @brief Regista um cruzamento (ou apenas o conta, no modo de contagem)
+ */
+static void registarCruzamento(const Segmento* a, const Segmento* b, Cruzamento* cruzamentos, int maxCruzamentos, int* total) {
+    double x, y;
+    if (!cruzamentoSegmentos(a, b, &x, &y)) return;
+    if (cruzamentos != NULL && *total < maxCruzamentos) {
+        Cruzamento* c = &cruzamentos[*total];
+        c->x = x;
+        c->y = y;
+        c->segmentoA[0] = a->inicio;
+        c->segmentoA[1] = a->fim;
+        c->segmentoB[0] = b->inicio;
+        c->segmentoB[1] = b->fim;
+    }
+    (*total)++;
+}
+
+/**
+ * @brief Inteiro de 128 bits em complemento para dois (para as comparacoes exatas do varrimento)
+ */
+typedef struct Inteiro128 {
+    unsigned long long alto;
+    unsigned long long baixo;
+} Inteiro128;
+
+/**
+ * @brief Produto exato de dois inteiros de 64 bits
+ */
+static Inteiro128 multiplicar128(long long a, long long b) {
+    bool negativo = (a < 0) != (b < 0);
+    unsigned long long ua = a < 0 ? 0ULL - (unsigned long long)a : (unsigned long long)a;
+    unsigned long long ub = b < 0 ? 0ULL - (unsigned long long)b : (unsigned long long)b;
+    if ((ua | ub) <= 0x7FFFFFFFULL) {
+        // caso comum (mapas pequenos): o produto cabe em 63 bits
+        long long produto = a * b;
+        Inteiro128 r = { produto < 0 ? ~0ULL : 0ULL, (unsigned long long)produto };
+        return r;
+    }
+    unsigned long long a0 = ua & 0xFFFFFFFFULL, a1 = ua >> 32;
+    unsigned long long b0 = ub & 0xFFFFFFFFULL, b1 = ub >> 32;
+    unsigned long long p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    unsigned long long meio = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+    Inteiro128 r;
+    r.baixo = (p00 & 0xFFFFFFFFULL) | (meio << 32);
+    r.alto = p11 + (p01 >> 32) + (p10 >> 32) + (meio >> 32);
+    if (negativo) {
+        r.baixo = ~r.baixo + 1;
+        r.alto = ~r.alto + (r.baixo == 0 ? 1 : 0);
+    }
+    return r;
+}
+
+/**
+ * @brief Soma de dois inteiros de 128 bits
+ */
+static Inteiro128 somar128(Inteiro128 a, Inteiro128 b) {
+    Inteiro128 r;
+    r.baixo = a.baixo + b.baixo;
+    r.alto = a.alto + b.alto + (r.baixo < a.baixo ? 1 : 0);
+    return r;
+}
+
+/**
+ * @brief Compara dois inteiros de 128 bits
+ * @return -1, 0 ou 1 conforme a e menor, igual ou maior do que b
+ */
+static int comparar128(Inteiro128 a, Inteiro128 b) {
+    if (a.alto != b.alto) return (long long)a.alto < (long long)b.alto ? -1 : 1;
+    if (a.baixo != b.baixo) return a.baixo < b.baixo ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Ponto com coordenadas racionais (x / d, y / d), d > 0: extremos e cruzamentos do varrimento
+ */
+typedef struct PontoRacional {
+    long long x;
+    long long y;
+    long long d;
+    double aproximadoX;     // x / d em virgula flutuante (filtro das comparacoes)
+    double aproximadoY;     // y / d em virgula flutuante
+} PontoRacional;
+
+/**
+ * @brief Compara dois pontos pela ordem do varrimento (x e depois y)
+ */
+static int compararPontos(const PontoRacional* p, const PontoRacional* q) {
+    // o erro das aproximacoes fica muito abaixo de PRECISAO_VARRIMENTO dentro de LIMITE_VARRIMENTO:
+    // so os pontos muito proximos precisam das contas exatas
+    if (p->aproximadoX < q->aproximadoX - PRECISAO_VARRIMENTO) return -1;
+    if (p->aproximadoX > q->aproximadoX + PRECISAO_VARRIMENTO) return 1;
+    if (p->d == 1 && q->d == 1) {
+        if (p->x != q->x) return p->x < q->x ? -1 : 1;
+        if (p->y != q->y) return p->y < q->y ? -1 : 1;
+        return 0;
+    }
+    int c = comparar128(multiplicar128(p->x, q->d), multiplicar128(q->x, p->d));
+    if (c != 0) return c;
+    if (p->aproximadoY < q->aproximadoY - PRECISAO_VARRIMENTO) return -1;
+    if (p->aproximadoY > q->aproximadoY + PRECISAO_VARRIMENTO) return 1;
+    return comparar128(multiplicar128(p->y, q->d), multiplicar128(q->y, p->d));
+}
+
+/**
+ * @brief Converte uma coordenada inteira num ponto racional
+ */
+static PontoRacional pontoInteiro(Coordenada c) {
+    PontoRacional p = { c.x, c.y, 1, c.x, c.y };
+    return p;
+}
+
+/**
+ * @brief Ponto onde dois segmentos nao colineares se intersetam (cruzamento ou toque)
+ * @return true se se intersetam, false se nao se tocam ou forem paralelos
+ */
+static bool pontoCruzamento(const Segmento* a, const Segmento* b, PontoRacional* ponto) {
+    long long rx = (long long)a->fim.x - a->inicio.x;
+    long long ry = (long long)a->fim.y - a->inicio.y;
+    long long sx = (long long)b->fim.x - b->inicio.x;
+    long long sy = (long long)b->fim.y - b->inicio.y;
+    long long qx = (long long)b->inicio.x - a->inicio.x;
+    long long qy = (long long)b->inicio.y - a->inicio.y;
+    long long d = rx * sy - ry * sx;
+    if (d == 0) return false;
+    long long t = qx * sy - qy * sx;
+    long long u = qx * ry - qy * rx;
+    if (d < 0) {
+        d = -d;
+        t = -t;
+        u = -u;
+    }
+    if (t < 0 || t > d || u < 0 || u > d) return false;
+    ponto->x = a->inicio.x * d + t * rx;
+    ponto->y = a->inicio.y * d + t * ry;
+    ponto->d = d;
+    ponto->aproximadoX = (double)ponto->x / (double)d;
+    ponto->aproximadoY = (double)ponto->y / (double)d;
+    return true;
+}
+
+/**
+ * @brief Posicao de um segmento do estado em relacao ao ponto do evento, na vertical do ponto
+ * @return -1 se o segmento passa abaixo do ponto, 0 se passa pelo ponto, 1 se passa acima
+ */
+static int posicaoSegmento(const Segmento* s, const PontoRacional* p) {
+    if (s->inicio.x == s->fim.x) {
+        // um segmento vertical no estado esta sempre na vertical do evento
+        if (comparar128(multiplicar128(p->y, 1), multiplicar128(s->inicio.y, p->d)) < 0) return 1;
+        if (comparar128(multiplicar128(p->y, 1), multiplicar128(s->fim.y, p->d)) > 0) return -1;
+        return 0;
+    }
+    // sinal de y(p.x) - p.y, multiplicado por dx * d (ambos positivos)
+    long long dx = (long long)s->fim.x - s->inicio.x;
+    long long dy = (long long)s->fim.y - s->inicio.y;
+    Inteiro128 y = somar128(multiplicar128((long long)s->inicio.y * dx, p->d), multiplicar128(p->x - s->inicio.x * p->d, dy));
+    return comparar128(y, multiplicar128(p->y, dx));
+}
+
+/**
+ * @brief Compara dois segmentos que passam pelo ponto do evento pela ordem logo a seguir ao ponto
+ * (declive crescente, verticais no fim, indice como desempate entre colineares)
+ */
+static int compararDeclives(const void* a, const void* b) {
+    const Segmento* s1 = *(const Segmento* const*)a;
+    const Segmento* s2 = *(const Segmento* const*)b;
+    long long dx1 = (long long)s1->fim.x - s1->inicio.x;
+    long long dy1 = (long long)s1->fim.y - s1->inicio.y;
+    long long dx2 = (long long)s2->fim.x - s2->inicio.x;
+    long long dy2 = (long long)s2->fim.y - s2->inicio.y;
+    if ((dx1 == 0) != (dx2 == 0)) return dx1 == 0 ? 1 : -1;
+    if (dx1 != 0) {
+        long long c1 = dy1 * dx2;
+        long long c2 = dy2 * dx1;
+        if (c1 != c2) return c1 < c2 ? -1 : 1;
+    }
+    if (s1 != s2) return s1 < s2 ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Evento do varrimento: extremo esquerdo de um segmento, extremo direito ou cruzamento
+ */
+typedef struct EventoVarrimento {
+    PontoRacional ponto;
+    int segmento;           // segmento que comeca no ponto, primeiro do par que se cruza no ponto ou -1 (fim)
+    int outro;              // segundo segmento do par que se cruza no ponto ou -1
+} EventoVarrimento;
+
+/**
+ * @brief Estado do varrimento de Bentley-Ottmann sobre os segmentos de A e de B
+ * O estado (segmentos que cortam a linha de varrimento, por ordem de y) e uma treap de posicoes;
+ * cada posicao guarda um segmento e esta ligada as posicoes vizinhas, para que um cruzamento
+ * simples (dois segmentos vizinhos) se resolva trocando os segmentos das duas posicoes, sem
+ * percorrer a arvore. A fila de eventos e um heap minimo pela ordem do varrimento.
+ */
+typedef struct Varrimento {
+    const Segmento* segmentos;  // segmentos de A (0..numA-1) seguidos dos de B
+    int numSegmentos;
+    int numA;
+    int* esquerda;              // filho esquerdo de cada posicao na treap (-1 se nao houver)
+    int* direita;               // filho direito
+    unsigned int* prioridade;   // prioridade de heap de cada posicao
+    int* anterior;              // posicao abaixo no estado (-1 se nao houver)
+    int* seguinte;              // posicao acima no estado (-1 se nao houver)
+    int* segmentoPosicao;       // segmento guardado em cada posicao
+    int* posicaoSegmento;       // posicao de cada segmento ativo
+    int* livres;                // posicoes livres (pilha)
+    int numLivres;
+    int raiz;                   // raiz da treap (-1 se vazia)
+    EventoVarrimento* eventos;  // heap de eventos
+    int numEventos;
+    int capacidadeEventos;
+    const Segmento** passam;    // segmentos que passam pelo evento atual
+    int* indices;               // indices dos segmentos de passam separados por frequencia
+} Varrimento;
+
+/**
+ * @brief Acrescenta um evento ao heap
+ * @return true se acrescentado, false em caso de erro de alocacao
+ */
+static bool colocarEvento(Varrimento* v, PontoRacional ponto, int segmento, int outro) {
+    if (v->numEventos == v->capacidadeEventos) {
+        int novaCapacidade = v->capacidadeEventos * 2;
+        EventoVarrimento* novos = (EventoVarrimento*)realloc(v->eventos, novaCapacidade * sizeof(EventoVarrimento));
+        if (novos == NULL) return false;
+        v->eventos = novos;
+        v->capacidadeEventos = novaCapacidade;
+    }
+    EventoVarrimento novo = { ponto, segmento, outro };
+    int k = v->numEventos++;
+    while (k > 0 && compararPontos(&v->eventos[(k - 1) / 2].ponto, &ponto) > 0) {
+        v->eventos[k] = v->eventos[(k - 1) / 2];
+        k = (k - 1) / 2;
+    }
+    v->eventos[k] = novo;
+    return true;
+}
+
+/**
+ * @brief Retira o primeiro evento do heap
+ */
+static EventoVarrimento retirarEvento(Varrimento* v) {
+    EventoVarrimento primeiro = v->eventos[0];
+    EventoVarrimento ultimo = v->eventos[--v->numEventos];
+    int k = 0;
+    for (;;) {
+        int filho = 2 * k + 1;
+        if (filho >= v->numEventos) break;
+        if (filho + 1 < v->numEventos && compararPontos(&v->eventos[filho + 1].ponto, &v->eventos[filho].ponto) < 0) filho++;
+        if (compararPontos(&v->eventos[filho].ponto, &ultimo.ponto) >= 0) break;
+        v->eventos[k] = v->eventos[filho];
+        k = filho;
+    }
+    if (v->numEventos > 0) v->eventos[k] = ultimo;
+    return primeiro;
+}
+
+/**
+ * @brief Junta duas treaps (todas as posicoes de a antes das de b)
+ */
+static int juntarTreap(Varrimento* v, int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (v->prioridade[a] > v->prioridade[b]) {
+        v->direita[a] = juntarTreap(v, v->direita[a], b);
+        return a;
+    }
+    v->esquerda[b] = juntarTreap(v, a, v->esquerda[b]);
+    return b;
+}
+
+/**
+ * @brief Posicao do segmento guardado num no da treap em relacao ao ponto do evento
+ */
+static int posicaoNo(const Varrimento* v, int no, const PontoRacional* ponto) {
+    return posicaoSegmento(&v->segmentos[v->segmentoPosicao[no]], ponto);
+}
+
+/**
+ * @brief Divide a treap: os nos cuja posicao em relacao ao ponto e menor do que limite ficam a esquerda
+ * A posicao e monotona ao longo do estado, por isso a divisao so segue um caminho da raiz
+ */
+static void dividirTreap(Varrimento* v, int no, const PontoRacional* ponto, int limite, int* menores, int* restantes) {
+    if (no < 0) {
+        *menores = -1;
+        *restantes = -1;
+        return;
+    }
+    if (posicaoNo(v, no, ponto) < limite) {
+        dividirTreap(v, v->direita[no], ponto, limite, &v->direita[no], restantes);
+        *menores = no;
+    }
+    else {
+        dividirTreap(v, v->esquerda[no], ponto, limite, menores, &v->esquerda[no]);
+        *restantes = no;
+    }
+}
+
+/**
+ * @brief Divide a treap nos segmentos abaixo do ponto, nos que passam pelo ponto e nos acima
+ * Desce um unico caminho ate ao primeiro segmento que passa pelo ponto e so ai se divide em dois
+ */
+static void separarTreap(Varrimento* v, int no, const PontoRacional* ponto, int* abaixo, int* passa, int* acima) {
+    if (no < 0) {
+        *abaixo = -1;
+        *passa = -1;
+        *acima = -1;
+        return;
+    }
+    int posicao = posicaoNo(v, no, ponto);
+    if (posicao < 0) {
+        separarTreap(v, v->direita[no], ponto, &v->direita[no], passa, acima);
+        *abaixo = no;
+    }
+    else if (posicao > 0) {
+        separarTreap(v, v->esquerda[no], ponto, abaixo, passa, &v->esquerda[no]);
+        *acima = no;
+    }
+    else {
+        dividirTreap(v, v->esquerda[no], ponto, 0, abaixo, &v->esquerda[no]);
+        dividirTreap(v, v->direita[no], ponto, 1, &v->direita[no], acima);
+        *passa = no;
+    }
+}
+
+/**
+ * @brief Primeiro (ou ultimo) no de uma treap, -1 se vazia
+ */
+static int extremoTreap(const Varrimento* v, int no, bool ultimo) {
+    if (no < 0) return -1;
+    const int* filho = ultimo ? v->direita : v->esquerda;
+    while (filho[no] >= 0) no = filho[no];
+    return no;
+}
+
+/**
+ * @brief Acrescenta a passam os segmentos de uma treap e liberta as suas posicoes
+ */
+static void retirarTreap(Varrimento* v, int no, int* tamanho) {
+    while (no >= 0) {
+        retirarTreap(v, v->esquerda[no], tamanho);
+        v->passam[(*tamanho)++] = &v->segmentos[v->segmentoPosicao[no]];
+        v->livres[v->numLivres++] = no;
+        no = v->direita[no];
+    }
+}
+
+/**
+ * @brief Testa os segmentos de duas posicoes vizinhas no estado e agenda o cruzamento se for depois do evento atual
+ * @return true se correu bem, false em caso de erro de alocacao
+ */
+static bool testarVizinhos(Varrimento* v, int abaixo, int acima, const PontoRacional* atual) {
+    if (abaixo < 0 || acima < 0) return true;
+    int s = v->segmentoPosicao[abaixo];
+    int t = v->segmentoPosicao[acima];
+    PontoRacional ponto;
+    if (!pontoCruzamento(&v->segmentos[s], &v->segmentos[t], &ponto)) return true;
+    if (compararPontos(&ponto, atual) <= 0) return true;
+    return colocarEvento(v, ponto, s, t);
+}
+
+/**
+ * @brief Regista os cruzamentos A/B entre os segmentos que passam pelo ponto do evento
+ * Dois segmentos nao colineares que passam pelo mesmo ponto so se tocam ai; um par colinear
+ * sobreposto passa por varios eventos e so e registado no inicio da sobreposicao
+ */
+static void registarPassam(Varrimento* v, int numPassam, const PontoRacional* ponto, Cruzamento* cruzamentos, int maxCruzamentos, int* total) {
+    int numDeA = 0;
+    int numDeB = 0;
+    for (int k = 0; k < numPassam; k++) {
+        int indice = (int)(v->passam[k] - v->segmentos);
+        if (indice < v->numA) v->indices[numDeA++] = indice;
+        else v->indices[numPassam - 1 - numDeB++] = indice;
+    }
+    for (int i = 0; i < numDeA; i++) {
+        const Segmento* a = &v->segmentos[v->indices[i]];
+        for (int j = numPassam - numDeB; j < numPassam; j++) {
+            const Segmento* b = &v->segmentos[v->indices[j]];
+            if (orientacao(a->inicio, a->fim, b->inicio) == 0 && orientacao(a->inicio, a->fim, b->fim) == 0) {
+                PontoRacional inicio = pontoInteiro(compararSegmentos(a, b) >= 0 ? a->inicio : b->inicio);
+                if (compararPontos(&inicio, ponto) != 0) continue;
+            }
+            registarCruzamento(a, b, cruzamentos, maxCruzamentos, total);
+        }
+    }
+}
+
+/**
+ * @brief Verifica se um segmento termina no ponto
+ */
+static bool terminaEm(const Segmento* s, const PontoRacional* ponto) {
+    PontoRacional fim = pontoInteiro(s->fim);
+    return compararPontos(&fim, ponto) == 0;
+}
+
+/**
+ * @brief Resolve um cruzamento simples: so os dois segmentos do par passam pelo ponto, sao
+ * vizinhos no estado e continuam depois dele. Troca os segmentos das duas posicoes e testa os
+ * novos vizinhos, sem percorrer a arvore
+ * @param resolvido Apontador preenchido com true se o cruzamento era simples e foi resolvido
+ * @return true se correu bem, false em caso de erro de alocacao
+ */
+static bool trocarVizinhos(Varrimento* v, int s, int t, const PontoRacional* ponto, Cruzamento* cruzamentos, int maxCruzamentos, int* total, bool* resolvido) {
+    *resolvido = false;
+    int abaixo = v->posicaoSegmento[s];
+    int acima = v->posicaoSegmento[t];
+    if (v->seguinte[acima] == abaixo) {
+        int troca = abaixo;
+        abaixo = acima;
+        acima = troca;
+    }
+    if (v->seguinte[abaixo] != acima) return true;
+    if (terminaEm(&v->segmentos[s], ponto) || terminaEm(&v->segmentos[t], ponto)) return true;
+    if (v->anterior[abaixo] >= 0 && posicaoNo(v, v->anterior[abaixo], ponto) == 0) return true;
+    if (v->seguinte[acima] >= 0 && posicaoNo(v, v->seguinte[acima], ponto) == 0) return true;
+
+    *resolvido = true;
+    if ((s < v->numA) != (t < v->numA)) {
+        if (s < v->numA) registarCruzamento(&v->segmentos[s], &v->segmentos[t], cruzamentos, maxCruzamentos, total);
+        else registarCruzamento(&v->segmentos[t], &v->segmentos[s], cruzamentos, maxCruzamentos, total);
+    }
+    int debaixo = v->segmentoPosicao[abaixo];
+    v->segmentoPosicao[abaixo] = v->segmentoPosicao[acima];
+    v->segmentoPosicao[acima] = debaixo;
+    v->posicaoSegmento[v->segmentoPosicao[abaixo]] = abaixo;
+    v->posicaoSegmento[v->segmentoPosicao[acima]] = acima;
+    return testarVizinhos(v, v->anterior[abaixo], abaixo, ponto) && testarVizinhos(v, acima, v->seguinte[acima], ponto);
+}
+
+/**
+ * @brief Processa um evento no caso geral
+ * O estado e dividido nos segmentos abaixo, nos que passam pelo ponto (os que terminam ou se
+ * cruzam ai) e nos acima; os que passam e nao terminam sao reinseridos com os que comecam no
+ * ponto, pela ordem logo a seguir ao ponto, e so os novos pares de vizinhos sao testados
+ * @param numComecam Numero de segmentos que comecam no ponto, ja no inicio de passam
+ * @return true se correu bem, false em caso de erro de alocacao
+ */
+static bool processarPonto(Varrimento* v, const PontoRacional* ponto, int numComecam, Cruzamento* cruzamentos, int maxCruzamentos, int* total) {
+    int abaixo, passa, acima;
+    separarTreap(v, v->raiz, ponto, &abaixo, &passa, &acima);
+    int numPassam = numComecam;
+    retirarTreap(v, passa, &numPassam);
+    registarPassam(v, numPassam, ponto, cruzamentos, maxCruzamentos, total);
+
+    int numContinuam = 0;
+    for (int k = 0; k < numPassam; k++) {
+        if (!terminaEm(v->passam[k], ponto)) v->passam[numContinuam++] = v->passam[k];
+    }
+    if (numContinuam > 1) qsort(v->passam, numContinuam, sizeof(const Segmento*), compararDeclives);
+    int ultimoAbaixo = extremoTreap(v, abaixo, true);
+    int primeiroAcima = extremoTreap(v, acima, false);
+    int continuam = -1;
+    int primeiro = -1;
+    int ultimo = ultimoAbaixo;
+    for (int k = 0; k < numContinuam; k++) {
+        int no = v->livres[--v->numLivres];
+        int segmento = (int)(v->passam[k] - v->segmentos);
+        v->segmentoPosicao[no] = segmento;
+        v->posicaoSegmento[segmento] = no;
+        v->esquerda[no] = -1;
+        v->direita[no] = -1;
+        v->anterior[no] = ultimo;
+        if (ultimo >= 0) v->seguinte[ultimo] = no;
+        if (primeiro < 0) primeiro = no;
+        ultimo = no;
+        continuam = juntarTreap(v, continuam, no);
+    }
+    if (ultimo >= 0) v->seguinte[ultimo] = primeiroAcima;
+    if (primeiroAcima >= 0) v->anterior[primeiroAcima] = ultimo;
+    v->raiz = juntarTreap(v, juntarTreap(v, abaixo, continuam), acima);
+    if (continuam < 0) return testarVizinhos(v, ultimoAbaixo, primeiroAcima, ponto);
+    return testarVizinhos(v, ultimoAbaixo, primeiro, ponto) && testarVizinhos(v, ultimo, primeiroAcima, ponto);
+}
+
+/**
+ * @brief Processa todos os eventos do varrimento, pela ordem da fila
+ * @return true se correu bem, false em caso de erro de alocacao
+ */
+static bool varrer(Varrimento* v, Cruzamento* cruzamentos, int maxCruzamentos, int* total) {
+    while (v->numEventos > 0) {
+        EventoVarrimento evento = retirarEvento(v);
+        PontoRacional ponto = evento.ponto;
+        // junta os eventos do mesmo ponto: os segmentos que comecam vao para o inicio de passam
+        int numComecam = 0;
+        bool soPar = evento.outro >= 0;
+        if (evento.segmento >= 0 && evento.outro < 0) v->passam[numComecam++] = &v->segmentos[evento.segmento];
+        while (v->numEventos > 0 && compararPontos(&v->eventos[0].ponto, &ponto) == 0) {
+            EventoVarrimento igual = retirarEvento(v);
+            if (igual.segmento >= 0 && igual.outro < 0) v->passam[numComecam++] = &v->segmentos[igual.segmento];
+            if (!((igual.segmento == evento.segmento && igual.outro == evento.outro) ||
+                (igual.segmento == evento.outro && igual.outro == evento.segmento))) soPar = false;
+        }
+        bool resolvido = false;
+        bool valido = true;
+        if (soPar) valido = trocarVizinhos(v, evento.segmento, evento.outro, &ponto, cruzamentos, maxCruzamentos, total, &resolvido);
+        if (valido && !resolvido) valido = processarPonto(v, &ponto, numComecam, cruzamentos, maxCruzamentos, total);
+        if (!valido) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Testa todos os pares A/B (para coordenadas fora do limite das comparacoes exatas do varrimento)
+ */
+static void cruzamentosTodosPares(const Segmento* segmentosA, int numA, const Segmento* segmentosB, int numB, Cruzamento* cruzamentos, int maxCruzamentos, int* total) {
+    for (int i = 0; i < numA; i++) {
+        for (int j = 0; j < numB; j++) registarCruzamento(&segmentosA[i], &segmentosB[j], cruzamentos, maxCruzamentos, total);
+    }
+}
+
+/**
+ * @brief Verifica se os extremos dos segmentos cabem no limite das comparacoes exatas do varrimento
+ */
+static bool dentroLimiteVarrimento(const Segmento* segmentos, int numSegmentos) {
+    for (int s = 0; s < numSegmentos; s++) {
+        const Coordenada* extremos[2] = { &segmentos[s].inicio, &segmentos[s].fim };
+        for (int k = 0; k < 2; k++) {
+            if (extremos[k]->x <= -LIMITE_VARRIMENTO || extremos[k]->x >= LIMITE_VARRIMENTO ||
+                extremos[k]->y <= -LIMITE_VARRIMENTO || extremos[k]->y >= LIMITE_VARRIMENTO) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Calcula os pontos onde as ligacoes da frequencia A cruzam as ligacoes da frequencia B
+ * Com cruzamentos igual a NULL a funcao funciona em modo de contagem.
+ * Varrimento de Bentley-Ottmann sobre os segmentos de A e de B juntos: custo
+ * O((|EA| + |EB| + I) log(|EA| + |EB|)), em que I e o numero de pontos de intersecao entre todos
+ * esses segmentos (incluindo os cruzamentos dentro da mesma frequencia, que o varrimento tem de
+ * processar para manter a ordem do estado). Os cruzamentos sao devolvidos pela ordem do varrimento
+ * (x e depois y). Com coordenadas fora de +-LIMITE_VARRIMENTO testa todos os pares.
+ * @param grafo Apontador para o grafo
+ * @param frequenciaA Frequencia A
+ * @param frequenciaB Frequencia B (diferente de A)
+ * @param cruzamentos Array para armazenar os cruzamentos ou NULL para apenas contar
+ * @param maxCruzamentos Capacidade do array de cruzamentos
+ * @param totalCruzamentos Apontador para o numero total de cruzamentos (mesmo os que nao couberam no array)
+ * @return true se pelo menos um cruzamento foi encontrado, false caso contrario
+ */
+bool calcularCruzamentos(Grafo* grafo, char frequenciaA, char frequenciaB, Cruzamento* cruzamentos, int maxCruzamentos, int* totalCruzamentos) {
+    if (grafo == NULL || totalCruzamentos == NULL || frequenciaA == frequenciaB) return false;
+    *totalCruzamentos = 0;
+    Segmento* segmentosA = NULL;
+    Segmento* segmentosB = NULL;
+    int numA = 0;
+    int numB = 0;
+    if (!construirSegmentos(grafo, frequenciaA, &segmentosA, &numA)) return false;
+    if (!construirSegmentos(grafo, frequenciaB, &segmentosB, &numB)) {
+        free(segmentosA);
+        return false;
+    }
+    if (numA == 0 || numB == 0) {
+        free(segmentosA);
+        free(segmentosB);
+        return false;
+    }
+    if (!dentroLimiteVarrimento(segmentosA, numA) || !dentroLimiteVarrimento(segmentosB, numB)) {
+        cruzamentosTodosPares(segmentosA, numA, segmentosB, numB, cruzamentos, maxCruzamentos, totalCruzamentos);
+        free(segmentosA);
+        free(segmentosB);
+        return (*totalCruzamentos > 0);
+    }
+
+    // A e B num unico array: o varrimento tem de ordenar todos os segmentos
+    int n = numA + numB;
+    Segmento* segmentos = (Segmento*)realloc(segmentosA, n * sizeof(Segmento));
+    if (segmentos == NULL) {
+        free(segmentosA);
+        free(segmentosB);
+        return false;
+    }
+    memcpy(&segmentos[numA], segmentosB, numB * sizeof(Segmento));
+    free(segmentosB);
+
+    Varrimento v;
+    v.segmentos = segmentos;
+    v.numSegmentos = n;
+    v.numA = numA;
+    v.raiz = -1;
+    v.numLivres = 0;
+    v.numEventos = 0;
+    v.capacidadeEventos = 2 * n;
+    v.esquerda = (int*)malloc(n * sizeof(int));
+    v.direita = (int*)malloc(n * sizeof(int));
+    v.prioridade = (unsigned int*)malloc(n * sizeof(unsigned int));
+    v.anterior = (int*)malloc(n * sizeof(int));
+    v.seguinte = (int*)malloc(n * sizeof(int));
+    v.segmentoPosicao = (int*)malloc(n * sizeof(int));
+    v.posicaoSegmento = (int*)malloc(n * sizeof(int));
+    v.livres = (int*)malloc(n * sizeof(int));
+    v.eventos = (EventoVarrimento*)malloc(v.capacidadeEventos * sizeof(EventoVarrimento));
+    v.passam = (const Segmento**)malloc(n * sizeof(const Segmento*));
+    v.indices = (int*)malloc(n * sizeof(int));
+    bool valido = v.esquerda != NULL && v.direita != NULL && v.prioridade != NULL && v.anterior != NULL &&
+        v.seguinte != NULL && v.segmentoPosicao != NULL && v.posicaoSegmento != NULL && v.livres != NULL &&
+        v.eventos != NULL && v.passam != NULL && v.indices != NULL;
+    unsigned int estado = 2463534242u; // xorshift: prioridades da treap deterministicas
+    for (int s = 0; valido && s < n; s++) {
+        estado ^= estado << 13;
+        estado ^= estado >> 17;
+        estado ^= estado << 5;
+        v.prioridade[s] = estado;
+        v.livres[v.numLivres++] = n - 1 - s;
+        valido = colocarEvento(&v, pontoInteiro(segmentos[s].inicio), s, -1) &&
+            colocarEvento(&v, pontoInteiro(segmentos[s].fim), -1, -1);
+    }
+    if (valido) valido = varrer(&v, cruzamentos, maxCruzamentos, totalCruzamentos);
+
+    free(v.esquerda);
+    free(v.direita);
+    free(v.prioridade);
+    free(v.anterior);
+    free(v.seguinte);
+    free(v.segmentoPosicao);
+    free(v.posicaoSegmento);
+    free(v.livres);
+    free(v.eventos);
+    free(v.passam);
+    free(v.indices);
+    free(segmentos);
+    if (!valido) *totalCruzamentos = 0;
+    return (*totalCruzamentos > 0);
+}
@@ -0,0 +1,418 @@
+/**
+ * @file lote.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Processamento em lote de muitos mapas em grafos, com um conjunto fixo de threads
+ * @details E o equivalente do processarLote da Fase1 para o carregamento em grafo. A thread
+ * principal le a lista de mapas (diretorio ou ficheiro manifesto) para uma fila limitada, que a
+ * bloqueia quando esta cheia. Cada trabalhador retira um mapa e faz as tres etapas: carrega-o no
+ * seu grafo, calcula os efeitos nefastos com calcularEfeitosNefastos e, se houver pasta de saida,
+ * grava o instantaneo binario com gravarGrafoBinario. Cada trabalhador tem um grafo e um buffer de
+ * texto proprios que passam de mapa para mapa: limparGrafo esvazia o grafo sem devolver a memoria
+ * e reservarBlocosGrafo reaproveita os blocos de vertices e arestas, que so crescem quando aparece
+ * um mapa maior. Cada mapa produz uma linha de resumo com o formato da Fase1, com as celulas
+ * contadas dentro do tamanho do ficheiro do mapa, como na Fase1.
+ * A fila, a listagem do diretorio e o manifesto seguem o lote.c da Fase1 mas ficam copiados aqui:
+ * cada fase e um projeto que compila so a sua pasta (tal como efeitos.c repete a regra de
+ * pontosEfeito), e juntar os dois obrigaria a Fase2 a incluir ficheiros da Fase1.
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <threads.h>
+#include <time.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+#include "grafo.h"
+#include "struct.h"
+
+/**
+ * @brief Fila limitada de caminhos de mapas
+ */
+typedef struct FilaMapas {
+    char** caminhos;
+    int capacidade;
+    int inicio;
+    int tamanho;
+    bool fechada;           // nao vao chegar mais mapas
+    mtx_t trinco;
+    cnd_t naoVazia;
+    cnd_t naoCheia;
+} FilaMapas;
+
+/**
+ * @brief Estado partilhado pelos trabalhadores
+ */
+typedef struct LoteGrafos {
+    FilaMapas fila;
+    const char* pastaSaida; // onde gravar os instantaneos (NULL para nao gravar)
+    FILE* resumo;           // destino das linhas de resumo
+    mtx_t trincoResumo;
+    int sucessos;
+    int falhas;
+} LoteGrafos;
+
+/**
+ * @brief Memoria de um trabalhador, reutilizada de mapa para mapa
+ */
+typedef struct TrabalhadorGrafos {
+    Grafo* grafo;           // esvaziado com limparGrafo antes de cada mapa
+    char* texto;            // conteudo do mapa atual
+    size_t capacidadeTexto; // tamanho alocado de texto
+} TrabalhadorGrafos;
+
+/**
+ * @brief Resultado do processamento de um mapa
+ */
+typedef struct ResultadoMapa {
+    int antenas;
+    int efeitos;
+    int celulas;
+    double msCarregar;
+    double msEfeitos;
+    double msGravar;
+} ResultadoMapa;
+
+static bool iniciarFilaMapas(FilaMapas* fila, int capacidade) {
+    fila->caminhos = (char**)malloc(capacidade * sizeof(char*));
+    fila->capacidade = capacidade;
+    fila->inicio = 0;
+    fila->tamanho = 0;
+    fila->fechada = false;
+    if (fila->caminhos == NULL) return false;
+    if (mtx_init(&fila->trinco, mtx_plain) != thrd_success) {
+        free(fila->caminhos);
+        return false;
+    }
+    cnd_init(&fila->naoVazia);
+    cnd_init(&fila->naoCheia);
+    return true;
+}
+
+static void destruirFilaMapas(FilaMapas* fila) {
+    for (int i = 0; i < fila->tamanho; i++) free(fila->caminhos[(fila->inicio + i) % fila->capacidade]);
+    free(fila->caminhos);
+    mtx_destroy(&fila->trinco);
+    cnd_destroy(&fila->naoVazia);
+    cnd_destroy(&fila->naoCheia);
+}
+
+/**
+ * @brief Coloca um caminho na fila, esperando enquanto estiver cheia
+ */
+static bool colocarMapa(FilaMapas* fila, const char* caminho) {
+    size_t tamanho = strlen(caminho) + 1;
+    char* copia = (char*)malloc(tamanho);
+    if (copia == NULL) return false;
+    memcpy(copia, caminho, tamanho);
+    mtx_lock(&fila->trinco);
+    while (fila->tamanho == fila->capacidade) cnd_wait(&fila->naoCheia, &fila->trinco);
+    fila->caminhos[(fila->inicio + fila->tamanho) % fila->capacidade] = copia;
+    fila->tamanho++;
+    cnd_signal(&fila->naoVazia);
+    mtx_unlock(&fila->trinco);
+    return true;
+}
+
+/**
+ * @brief Retira um caminho da fila, esperando enquanto estiver vazia
+ * @return Caminho a libertar pelo chamador, NULL quando a fila esta fechada e vazia
+ */
+static char* retirarMapa(FilaMapas* fila) {
+    mtx_lock(&fila->trinco);
+    while (fila->tamanho == 0 && !fila->fechada) cnd_wait(&fila->naoVazia, &fila->trinco);
+    char* caminho = NULL;
+    if (fila->tamanho > 0) {
+        caminho = fila->caminhos[fila->inicio];
+        fila->inicio = (fila->inicio + 1) % fila->capacidade;
+        fila->tamanho--;
+        cnd_signal(&fila->naoCheia);
+    }
+    mtx_unlock(&fila->trinco);
+    return caminho;
+}
+
+static void fecharFilaMapas(FilaMapas* fila) {
+    mtx_lock(&fila->trinco);
+    fila->fechada = true;
+    cnd_broadcast(&fila->naoVazia);
+    mtx_unlock(&fila->trinco);
+}
+
+/**
+ * @brief Tempo atual em milissegundos
+ */
+static double agoraMs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1.0e6;
+}
+
+/**
+ * @brief Le um ficheiro inteiro para o buffer do trabalhador, aumentando-o se for preciso
+ * @return Numero de bytes lidos ou -1 em caso de erro
+ */
+static long long lerFicheiroLote(const char* caminho, TrabalhadorGrafos* trabalho) {
+    FILE* fp = fopen(caminho, "rb");
+    if (fp == NULL) return -1;
+    size_t usado = 0;
+    for (;;) {
+        if (usado == trabalho->capacidadeTexto) {
+            size_t novaCapacidade = trabalho->capacidadeTexto > 0 ? trabalho->capacidadeTexto * 2 : 4096;
+            char* novo = (char*)realloc(trabalho->texto, novaCapacidade);
+            if (novo == NULL) {
+                fclose(fp);
+                return -1;
+            }
+            trabalho->texto = novo;
+            trabalho->capacidadeTexto = novaCapacidade;
+        }
+        size_t lidos = fread(trabalho->texto + usado, 1, trabalho->capacidadeTexto - usado, fp);
+        usado += lidos;
+        if (lidos == 0) break;
+    }
+    bool erro = ferror(fp) != 0;
+    fclose(fp);
+    return erro ? -1 : (long long)usado;
+}
+
+/**
+ * @brief Carrega um mapa de texto no grafo (vazio) do trabalhador
+ * Segue as regras de carregarDadosGrafo (x e a posicao na linha e y o numero da linha, a partir
+ * de 0; '.' e ' ' sao posicoes vazias; ligacoes entre todas as antenas da mesma frequencia), mas
+ * conta primeiro as antenas de cada frequencia para reservar os vertices e as arestas de uma vez
+ * nos blocos do grafo. Devolve tambem o tamanho do mapa, como o processarLote da Fase1: linhas do
+ * ficheiro e comprimento da linha mais longa (sem '\r')
+ * @param caminho Mapa de texto
+ * @param trabalho Grafo e buffer do trabalhador
+ * @param linhas Numero de linhas do mapa
+ * @param colunas Numero de colunas do mapa
+ * @return true se carregado, false em caso de erro
+ */
+static bool carregarMapaLote(const char* caminho, TrabalhadorGrafos* trabalho, int* linhas, int* colunas) {
+    long long tamanho = lerFicheiroLote(caminho, trabalho);
+    if (tamanho < 0) return false;
+    const char* texto = trabalho->texto;
+
+    long long porFrequencia[NUM_FREQUENCIAS] = { 0 };
+    long long numAntenas = 0;
+    int numLinhas = 0, maxColunas = 0, coluna = 0;
+    for (long long i = 0; i < tamanho; i++) {
+        char c = texto[i];
+        if (c == '\n') {
+            numLinhas++;
+            coluna = 0;
+            continue;
+        }
+        if (c == '\r') {
+            coluna++;
+            continue;
+        }
+        if (c != '.' && c != ' ') {
+            porFrequencia[(unsigned char)c]++;
+            numAntenas++;
+        }
+        if (++coluna > maxColunas) maxColunas = coluna;
+    }
+    if (tamanho > 0 && texto[tamanho - 1] != '\n') numLinhas++;
+    long long numArestas = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) numArestas += porFrequencia[f] * (porFrequencia[f] - 1);
+    if (numAntenas > INT_MAX || numArestas > INT_MAX) return false;
+
+    Grafo* grafo = trabalho->grafo;
+    if (!reservarBlocosGrafo(grafo, (int)numAntenas, (int)numArestas)) return false;
+    // cada posicao do texto aparece uma vez, por isso nao e preciso procurar coordenadas repetidas
+    int x = 0, y = 0;
+    for (long long i = 0; i < tamanho; i++) {
+        char c = texto[i];
+        if (c == '\n') {
+            y++;
+            x = 0;
+            continue;
+        }
+        if (c != '.' && c != ' ' && c != '\r') {
+            Antena antena = { c, {x, y} };
+            if (anexarVertice(grafo, antena) == NULL) return false;
+        }
+        x++;
+    }
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        GrupoFrequencia* grupo = &grafo->frequencias[f];
+        for (int i = 0; i < grupo->tamanho; i++) {
+            for (int j = i + 1; j < grupo->tamanho; j++) {
+                if (!anexarArestaDupla(grafo, grupo->membros[i], grupo->membros[j])) return false;
+            }
+        }
+    }
+    *linhas = numLinhas;
+    *colunas = maxColunas;
+    return true;
+}
+
+/**
+ * @brief Processa um mapa: carregamento em grafo, efeitos e gravacao opcional do instantaneo
+ * As celulas afetadas sao as posicoes distintas dos efeitos dentro do tamanho do mapa
+ * @param caminho Mapa de texto (o formato de carregarDadosGrafo)
+ * @param pastaSaida Pasta para o instantaneo ou NULL
+ * @param trabalho Grafo e buffer do trabalhador (o grafo fica com o mapa ate ao seguinte)
+ * @param resultado Contagens e tempos
+ * @return true se o mapa foi processado, false em caso de erro
+ */
+static bool processarMapaGrafo(const char* caminho, const char* pastaSaida, TrabalhadorGrafos* trabalho, ResultadoMapa* resultado) {
+    double t0 = agoraMs();
+    Grafo* grafo = trabalho->grafo;
+    limparGrafo(grafo);
+    int linhas = 0, colunas = 0;
+    if (!carregarMapaLote(caminho, trabalho, &linhas, &colunas)) return false;
+    double t1 = agoraMs();
+
+    EfeitoNefasto* efeitos = NULL;
+    int numEfeitos = 0;
+    if (!calcularEfeitosNefastos(grafo, -1, &efeitos, &numEfeitos)) return false;
+    // os efeitos vem ordenados por linha e coluna, por isso as posicoes repetidas sao seguidas
+    int celulas = 0;
+    for (int i = 0; i < numEfeitos; i++) {
+        EfeitoNefasto* e = &efeitos[i];
+        if (e->linha < 1 || e->coluna < 1 || e->linha > linhas || e->coluna > colunas) continue;
+        if (i > 0 && efeitos[i - 1].linha == e->linha && efeitos[i - 1].coluna == e->coluna) continue;
+        celulas++;
+    }
+    free(efeitos);
+    double t2 = agoraMs();
+
+    bool sucesso = true;
+    if (pastaSaida != NULL) {
+        const char* base = caminho;
+        for (const char* p = caminho; *p != '\0'; p++) {
+            if (*p == '/' || *p == '\\') base = p + 1;
+        }
+        char nome[1024];
+        snprintf(nome, sizeof(nome), "%s/%s.grafo.bin", pastaSaida, base);
+        sucesso = gravarGrafoBinario(grafo, nome);
+    }
+    double t3 = agoraMs();
+
+    resultado->antenas = grafo->numVertices;
+    resultado->efeitos = numEfeitos;
+    resultado->celulas = celulas;
+    resultado->msCarregar = t1 - t0;
+    resultado->msEfeitos = t2 - t1;
+    resultado->msGravar = t3 - t2;
+    return sucesso;
+}
+
+/**
+ * @brief Ciclo de um trabalhador: retira mapas da fila ate ela fechar
+ */
+static int trabalhadorGrafos(void* argumento) {
+    LoteGrafos* lote = (LoteGrafos*)argumento;
+    TrabalhadorGrafos trabalho = { inicializarGrafo(), NULL, 0 };
+    char* caminho;
+    while ((caminho = retirarMapa(&lote->fila)) != NULL) {
+        ResultadoMapa r = { 0 };
+        bool sucesso = trabalho.grafo != NULL && processarMapaGrafo(caminho, lote->pastaSaida, &trabalho, &r);
+        mtx_lock(&lote->trincoResumo);
+        if (sucesso) {
+            fprintf(lote->resumo, "%s antenas=%d efeitos=%d celulas=%d carregar_ms=%.3f efeitos_ms=%.3f gravar_ms=%.3f\n",
+                caminho, r.antenas, r.efeitos, r.celulas, r.msCarregar, r.msEfeitos, r.msGravar);
+            lote->sucessos++;
+        }
+        else {
+            fprintf(lote->resumo, "%s erro\n", caminho);
+            lote->falhas++;
+        }
+        mtx_unlock(&lote->trincoResumo);
+        free(caminho);
+    }
+    libertarGrafo(trabalho.grafo);
+    free(trabalho.texto);
+    return 0;
+}
+
+/**
+ * @brief Coloca na fila todos os ficheiros de um diretorio
+ * @return Numero de ficheiros, -1 se nao for um diretorio
+ */
+static int listarMapasDiretorio(const char* pasta, FilaMapas* fila) {
+    char caminho[1024];
+    int total = 0;
+#ifdef _WIN32
+    struct _finddata_t dados;
+    snprintf(caminho, sizeof(caminho), "%s\\*", pasta);
+    intptr_t procura = _findfirst(caminho, &dados);
+    if (procura == -1) return -1;
+    do {
+        if ((dados.attrib & _A_SUBDIR) != 0 || dados.name[0] == '.') continue;
+        snprintf(caminho, sizeof(caminho), "%s\\%s", pasta, dados.name);
+        if (colocarMapa(fila, caminho)) total++;
+    } while (_findnext(procura, &dados) == 0);
+    _findclose(procura);
+#else
+    DIR* dir = opendir(pasta);
+    if (dir == NULL) return -1;
+    struct dirent* entrada;
+    while ((entrada = readdir(dir)) != NULL) {
+        if (entrada->d_name[0] == '.') continue;
+        snprintf(caminho, sizeof(caminho), "%s/%s", pasta, entrada->d_name);
+        if (colocarMapa(fila, caminho)) total++;
+    }
+    closedir(dir);
+#endif
+    return total;
+}
+
+/**
+ * @brief Coloca na fila os mapas de um manifesto (um caminho por linha; '#' inicia comentario)
+ * @return Numero de mapas, -1 se o manifesto nao abrir
+ */
+static int lerManifestoMapas(const char* manifesto, FilaMapas* fila) {
+    FILE* fp = fopen(manifesto, "r");
+    if (fp == NULL) return -1;
+    char linha[1024];
+    int total = 0;
+    while (fgets(linha, sizeof(linha), fp) != NULL) {
+        linha[strcspn(linha, "\r\n")] = '\0';
+        if (linha[0] == '\0' || linha[0] == '#') continue;
+        if (colocarMapa(fila, linha)) total++;
+    }
+    fclose(fp);
+    return total;
+}
+
+int processarLoteGrafos(const char* entrada, const char* pastaSaida, FILE* resumo, int numTrabalhadores, int capacidadeFila) {
+    if (entrada == NULL || numTrabalhadores <= 0 || capacidadeFila <= 0) return -1;
+    LoteGrafos lote;
+    lote.pastaSaida = pastaSaida;
+    lote.resumo = resumo != NULL ? resumo : stdout;
+    lote.sucessos = 0;
+    lote.falhas = 0;
+    if (!iniciarFilaMapas(&lote.fila, capacidadeFila)) return -1;
+    if (mtx_init(&lote.trincoResumo, mtx_plain) != thrd_success) {
+        destruirFilaMapas(&lote.fila);
+        return -1;
+    }
+    thrd_t* threads = (thrd_t*)malloc(numTrabalhadores * sizeof(thrd_t));
+    int iniciadas = 0;
+    while (threads != NULL && iniciadas < numTrabalhadores &&
+        thrd_create(&threads[iniciadas], trabalhadorGrafos, &lote) == thrd_success) iniciadas++;
+
+    int total = -1;
+    if (iniciadas > 0) {
+        total = listarMapasDiretorio(entrada, &lote.fila);
+        if (total < 0) total = lerManifestoMapas(entrada, &lote.fila);
+    }
+    fecharFilaMapas(&lote.fila);
+    for (int i = 0; i < iniciadas; i++) thrd_join(threads[i], NULL);
+    free(threads);
+    mtx_destroy(&lote.trincoResumo);
+    destruirFilaMapas(&lote.fila);
+    return total < 0 ? -1 : lote.sucessos;
+}
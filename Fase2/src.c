@@ -10,9 +10,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <ctype.h>
+#include <math.h>
 #include "grafo.h"
 #include "struct.h"
+#include "estatisticas.h"
 
  /**
   * @brief Inicializa um grafo vazio
@@ -21,11 +24,308 @@
 Grafo* inicializarGrafo() {
     Grafo* grafo = (Grafo*)malloc(sizeof(Grafo));
     if (grafo == NULL) return NULL;
+    ESTAT_ALOCACAO(ESTAT_GRAFO, sizeof(Grafo));
     grafo->primeiro = NULL;
     grafo->numVertices = 0;
+    grafo->numArestas = 0;
+    grafo->vertices = NULL;
+    grafo->capacidade = 0;
+    grafo->limiteIds = 0;
+    grafo->geracoes = NULL;
+    grafo->idsLivres = NULL;
+    grafo->numIdsLivres = 0;
+    grafo->geracao = 0;
+    grafo->metrica = METRICA_UNITARIA;
+    grafo->componentes.pai = NULL;
+    grafo->componentes.tamanho = NULL;
+    grafo->componentes.proximoMembro = NULL;
+    grafo->componentes.numComponentes = 0;
+    grafo->componentesDesatualizados = false;
+    grafo->coordenadas.ids = NULL;
+    grafo->coordenadas.capacidade = 0;
+    grafo->coordenadas.ocupados = 0;
+    for (int i = 0; i < NUM_FREQUENCIAS; i++) {
+        grafo->frequencias[i].membros = NULL;
+        grafo->frequencias[i].tamanho = 0;
+        grafo->frequencias[i].capacidade = 0;
+    }
+    grafo->blocoVertices = NULL;
+    grafo->capacidadeBlocoVertices = 0;
+    grafo->usadosBlocoVertices = 0;
+    grafo->blocoArestas = NULL;
+    grafo->capacidadeBlocoArestas = 0;
+    grafo->usadosBlocoArestas = 0;
     return grafo;
 }
 
+/**
+ * @brief Verifica se um apontador esta dentro de um bloco reservado
+ */
+static bool dentroDoBloco(const void* p, const void* bloco, int capacidade, size_t tamanho) {
+    uintptr_t endereco = (uintptr_t)p;
+    uintptr_t inicio = (uintptr_t)bloco;
+    return bloco != NULL && endereco >= inicio && endereco < inicio + (uintptr_t)capacidade * tamanho;
+}
+
+/**
+ * @brief Obtem a memoria de um vertice novo: do bloco reservado enquanto houver, senao com malloc
+ */
+static NoVertice* alocarVertice(Grafo* grafo) {
+    if (grafo->usadosBlocoVertices < grafo->capacidadeBlocoVertices) return &grafo->blocoVertices[grafo->usadosBlocoVertices++];
+    NoVertice* vertice = (NoVertice*)malloc(sizeof(NoVertice));
+    if (vertice != NULL) ESTAT_ALOCACAO(ESTAT_VERTICE, sizeof(NoVertice));
+    return vertice;
+}
+
+/**
+ * @brief Liberta a memoria de um vertice (os do bloco so sao libertados com o grafo)
+ */
+static void libertarMemoriaVertice(Grafo* grafo, NoVertice* vertice) {
+    if (dentroDoBloco(vertice, grafo->blocoVertices, grafo->capacidadeBlocoVertices, sizeof(NoVertice))) return;
+    free(vertice);
+    ESTAT_LIBERTACAO(ESTAT_VERTICE, sizeof(NoVertice));
+}
+
+/**
+ * @brief Obtem a memoria de uma aresta nova: do bloco reservado enquanto houver, senao com malloc
+ */
+static Aresta* alocarAresta(Grafo* grafo) {
+    if (grafo->usadosBlocoArestas < grafo->capacidadeBlocoArestas) return &grafo->blocoArestas[grafo->usadosBlocoArestas++];
+    Aresta* aresta = (Aresta*)malloc(sizeof(Aresta));
+    if (aresta != NULL) ESTAT_ALOCACAO(ESTAT_ARESTA, sizeof(Aresta));
+    return aresta;
+}
+
+/**
+ * @brief Liberta a memoria de uma aresta (as do bloco so sao libertadas com o grafo)
+ */
+static void libertarMemoriaAresta(Grafo* grafo, Aresta* aresta) {
+    if (dentroDoBloco(aresta, grafo->blocoArestas, grafo->capacidadeBlocoArestas, sizeof(Aresta))) return;
+    free(aresta);
+    ESTAT_LIBERTACAO(ESTAT_ARESTA, sizeof(Aresta));
+}
+
+/**
+ * @brief Acrescenta um vertice ao grupo da sua frequencia
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ * @return true se acrescentado, false em caso de erro de alocacao
+ */
+static bool adicionarAoGrupoFrequencia(Grafo* grafo, NoVertice* vertice) {
+    GrupoFrequencia* grupo = &grafo->frequencias[(unsigned char)vertice->dados.frequencia];
+    if (grupo->tamanho == grupo->capacidade) {
+        int novaCapacidade = grupo->capacidade > 0 ? grupo->capacidade * 2 : 8;
+        NoVertice** membros = (NoVertice**)realloc(grupo->membros, novaCapacidade * sizeof(NoVertice*));
+        if (membros == NULL) return false;
+        grupo->membros = membros;
+        grupo->capacidade = novaCapacidade;
+    }
+    vertice->posicaoGrupo = grupo->tamanho;
+    grupo->membros[grupo->tamanho++] = vertice;
+    return true;
+}
+
+/**
+ * @brief Retira um vertice do grupo da sua frequencia em O(1) (o ultimo membro ocupa o seu lugar)
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ */
+static void removerDoGrupoFrequencia(Grafo* grafo, NoVertice* vertice) {
+    GrupoFrequencia* grupo = &grafo->frequencias[(unsigned char)vertice->dados.frequencia];
+    NoVertice* ultimo = grupo->membros[--grupo->tamanho];
+    grupo->membros[vertice->posicaoGrupo] = ultimo;
+    ultimo->posicaoGrupo = vertice->posicaoGrupo;
+}
+
+/**
+ * @brief Garante que os arrays indexados por id tem espaco para pelo menos n vertices
+ * @param grafo Apontador para o grafo
+ * @param n Numero de vertices pretendido
+ * @return true se existe espaco, false em caso de erro de alocacao
+ */
+static bool garantirCapacidade(Grafo* grafo, int n) {
+    if (n <= grafo->capacidade) return true;
+    int novaCapacidade = grafo->capacidade > 0 ? grafo->capacidade * 2 : 16;
+    while (novaCapacidade < n) novaCapacidade *= 2;
+    NoVertice** vertices = (NoVertice**)realloc(grafo->vertices, novaCapacidade * sizeof(NoVertice*));
+    if (vertices == NULL) return false;
+    grafo->vertices = vertices;
+    unsigned int* geracoes = (unsigned int*)realloc(grafo->geracoes, novaCapacidade * sizeof(unsigned int));
+    if (geracoes == NULL) return false;
+    grafo->geracoes = geracoes;
+    int* idsLivres = (int*)realloc(grafo->idsLivres, novaCapacidade * sizeof(int));
+    if (idsLivres == NULL) return false;
+    grafo->idsLivres = idsLivres;
+    int* pai = (int*)realloc(grafo->componentes.pai, novaCapacidade * sizeof(int));
+    if (pai == NULL) return false;
+    grafo->componentes.pai = pai;
+    int* tamanho = (int*)realloc(grafo->componentes.tamanho, novaCapacidade * sizeof(int));
+    if (tamanho == NULL) return false;
+    grafo->componentes.tamanho = tamanho;
+    int* proximoMembro = (int*)realloc(grafo->componentes.proximoMembro, novaCapacidade * sizeof(int));
+    if (proximoMembro == NULL) return false;
+    grafo->componentes.proximoMembro = proximoMembro;
+    grafo->capacidade = novaCapacidade;
+    return true;
+}
+
+/**
+ * @brief Funcao de dispersao para um par de coordenadas
+ */
+static unsigned int dispersaoCoordenadas(int x, int y) {
+    unsigned int h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u;
+    return h ^ (h >> 15);
+}
+
+/**
+ * @brief Procura o id do vertice com as coordenadas dadas
+ * @param grafo Apontador para o grafo
+ * @param x Coordenada x
+ * @param y Coordenada y
+ * @return Id do vertice ou -1 se nao existir
+ */
+static int procurarCoordenadas(Grafo* grafo, int x, int y) {
+    IndiceCoordenadas* indice = &grafo->coordenadas;
+    if (indice->capacidade == 0) return -1;
+    unsigned int mascara = (unsigned int)indice->capacidade - 1;
+    for (unsigned int i = dispersaoCoordenadas(x, y) & mascara; indice->ids[i] >= 0; i = (i + 1) & mascara) {
+        Coordenada p = grafo->vertices[indice->ids[i]]->dados.posicao;
+        if (p.x == x && p.y == y) return indice->ids[i];
+    }
+    return -1;
+}
+
+/**
+ * @brief Coloca um id na tabela de coordenadas (sondagem linear)
+ */
+static void colocarCoordenadas(Grafo* grafo, int id) {
+    IndiceCoordenadas* indice = &grafo->coordenadas;
+    Coordenada p = grafo->vertices[id]->dados.posicao;
+    unsigned int mascara = (unsigned int)indice->capacidade - 1;
+    unsigned int i = dispersaoCoordenadas(p.x, p.y) & mascara;
+    while (indice->ids[i] >= 0) i = (i + 1) & mascara;
+    indice->ids[i] = id;
+    indice->ocupados++;
+}
+
+/**
+ * @brief Insere um vertice na tabela de coordenadas, aumentando-a quando passa de metade
+ * @param grafo Apontador para o grafo
+ * @param id Id do vertice (com as coordenadas ja preenchidas)
+ * @return true se inserido, false em caso de erro de alocacao
+ */
+static bool inserirCoordenadas(Grafo* grafo, int id) {
+    IndiceCoordenadas* indice = &grafo->coordenadas;
+    if ((indice->ocupados + 1) * 2 > indice->capacidade) {
+        int novaCapacidade = indice->capacidade > 0 ? indice->capacidade * 2 : 32;
+        int* ids = (int*)malloc(novaCapacidade * sizeof(int));
+        if (ids == NULL) return false;
+        for (int i = 0; i < novaCapacidade; i++) ids[i] = -1;
+        int* antigos = indice->ids;
+        int capacidadeAntiga = indice->capacidade;
+        indice->ids = ids;
+        indice->capacidade = novaCapacidade;
+        indice->ocupados = 0;
+        for (int i = 0; i < capacidadeAntiga; i++) {
+            if (antigos[i] >= 0) colocarCoordenadas(grafo, antigos[i]);
+        }
+        free(antigos);
+    }
+    colocarCoordenadas(grafo, id);
+    return true;
+}
+
+/**
+ * @brief Retira um vertice da tabela de coordenadas, recuando as entradas seguintes do mesmo bloco
+ * @param grafo Apontador para o grafo
+ * @param id Id do vertice (ainda com as coordenadas antigas)
+ */
+static void removerCoordenadas(Grafo* grafo, int id) {
+    IndiceCoordenadas* indice = &grafo->coordenadas;
+    if (indice->capacidade == 0) return;
+    unsigned int mascara = (unsigned int)indice->capacidade - 1;
+    Coordenada p = grafo->vertices[id]->dados.posicao;
+    unsigned int i = dispersaoCoordenadas(p.x, p.y) & mascara;
+    while (indice->ids[i] >= 0 && indice->ids[i] != id) i = (i + 1) & mascara;
+    if (indice->ids[i] < 0) return;
+    indice->ids[i] = -1;
+    indice->ocupados--;
+    for (unsigned int j = (i + 1) & mascara; indice->ids[j] >= 0; j = (j + 1) & mascara) {
+        Coordenada q = grafo->vertices[indice->ids[j]]->dados.posicao;
+        unsigned int inicial = dispersaoCoordenadas(q.x, q.y) & mascara;
+        // a entrada pode ocupar o buraco se a sua posicao inicial nao estiver entre i e j
+        bool entre = (i <= j) ? (i < inicial && inicial <= j) : (i < inicial || inicial <= j);
+        if (!entre) {
+            indice->ids[i] = indice->ids[j];
+            indice->ids[j] = -1;
+            i = j;
+        }
+    }
+}
+
+/**
+ * @brief Devolve a raiz union-find do vertice com o id dado (com compressao de caminho)
+ * @param componentes Indice de componentes
+ * @param id Id do vertice
+ * @return Id da raiz do componente
+ */
+static int raizComponente(IndiceComponentes* componentes, int id) {
+    while (componentes->pai[id] != id) {
+        componentes->pai[id] = componentes->pai[componentes->pai[id]];
+        id = componentes->pai[id];
+    }
+    return id;
+}
+
+/**
+ * @brief Junta os componentes de dois vertices (uniao por tamanho)
+ * @param componentes Indice de componentes
+ * @param a Id do primeiro vertice
+ * @param b Id do segundo vertice
+ */
+static void unirComponentes(IndiceComponentes* componentes, int a, int b) {
+    int raizA = raizComponente(componentes, a);
+    int raizB = raizComponente(componentes, b);
+    if (raizA == raizB) return;
+    if (componentes->tamanho[raizA] < componentes->tamanho[raizB]) {
+        int temp = raizA;
+        raizA = raizB;
+        raizB = temp;
+    }
+    componentes->pai[raizB] = raizA;
+    componentes->tamanho[raizA] += componentes->tamanho[raizB];
+    // junta as duas listas circulares trocando os sucessores das raizes
+    int temp = componentes->proximoMembro[raizA];
+    componentes->proximoMembro[raizA] = componentes->proximoMembro[raizB];
+    componentes->proximoMembro[raizB] = temp;
+    componentes->numComponentes--;
+}
+
+/**
+ * @brief Reconstroi o union-find a partir das arestas atuais
+ * O union-find nao suporta separar componentes, por isso as remocoes apenas marcam o indice
+ * como desatualizado e a reconstrucao (O(V + E)) e feita na consulta seguinte
+ * @param grafo Apontador para o grafo
+ */
+static void atualizarComponentes(Grafo* grafo) {
+    if (!grafo->componentesDesatualizados) return;
+    IndiceComponentes* componentes = &grafo->componentes;
+    componentes->numComponentes = 0;
+    for (int id = 0; id < grafo->limiteIds; id++) {
+        if (grafo->vertices[id] == NULL) continue;
+        componentes->pai[id] = id;
+        componentes->tamanho[id] = 1;
+        componentes->proximoMembro[id] = id;
+        componentes->numComponentes++;
+    }
+    for (NoVertice* v = grafo->primeiro; v != NULL; v = v->proximo) {
+        for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) {
+            unirComponentes(componentes, v->id, a->destino->id);
+        }
+    }
+    grafo->componentesDesatualizados = false;
+}
+
 /**
  * @brief Liberta a memoria alocada para um grafo
  * @param grafo Apontador para o grafo a ser libertado
@@ -39,13 +339,30 @@ bool libertarGrafo(Grafo* grafo) {
         Aresta* aresta = atual->primeiraAresta;
         while (aresta != NULL) {
             Aresta* proxima = aresta->proxima;
-            free(aresta);
+            libertarMemoriaAresta(grafo, aresta);
             aresta = proxima;
         }
-        free(atual);
+        libertarMemoriaVertice(grafo, atual);
         atual = proximo;
     }
+    if (grafo->blocoVertices != NULL) {
+        free(grafo->blocoVertices);
+        ESTAT_LIBERTACAO(ESTAT_VERTICE, (size_t)grafo->capacidadeBlocoVertices * sizeof(NoVertice));
+    }
+    if (grafo->blocoArestas != NULL) {
+        free(grafo->blocoArestas);
+        ESTAT_LIBERTACAO(ESTAT_ARESTA, (size_t)grafo->capacidadeBlocoArestas * sizeof(Aresta));
+    }
+    free(grafo->vertices);
+    free(grafo->geracoes);
+    free(grafo->idsLivres);
+    free(grafo->componentes.pai);
+    free(grafo->componentes.tamanho);
+    free(grafo->componentes.proximoMembro);
+    free(grafo->coordenadas.ids);
+    for (int i = 0; i < NUM_FREQUENCIAS; i++) free(grafo->frequencias[i].membros);
     free(grafo);
+    ESTAT_LIBERTACAO(ESTAT_GRAFO, sizeof(Grafo));
     return true;
 }
 
@@ -61,21 +378,138 @@ NoVertice* adicionarVertice(Grafo* grafo, Antena antena) {
     if (antena.posicao.x < 0 || antena.posicao.y < 0) {
         return NULL;
     }
+    int existente = procurarCoordenadas(grafo, antena.posicao.x, antena.posicao.y);
+    if (existente >= 0) return grafo->vertices[existente];
+    return anexarVertice(grafo, antena);
+}
+
+/**
+ * @brief Esvazia o grafo mantendo a memoria ja reservada para o reutilizar
+ * Os vertices e arestas obtidos com malloc sao libertados; os arrays indexados por id, a tabela de
+ * coordenadas, os grupos de frequencia e os blocos de reservarBlocosGrafo ficam com a capacidade
+ * que tinham. Os ids recomecam em 0, por isso as referencias anteriores deixam de ser validas
+ * (como depois de libertarGrafo)
+ * @param grafo Apontador para o grafo
+ * @return true se esvaziado, false se o grafo for NULL
+ */
+bool limparGrafo(Grafo* grafo) {
+    if (grafo == NULL) return false;
     NoVertice* atual = grafo->primeiro;
     while (atual != NULL) {
-        if (atual->dados.posicao.x == antena.posicao.x &&
-            atual->dados.posicao.y == antena.posicao.y) {
-            return atual;
+        NoVertice* proximo = atual->proximo;
+        Aresta* aresta = atual->primeiraAresta;
+        while (aresta != NULL) {
+            Aresta* proxima = aresta->proxima;
+            libertarMemoriaAresta(grafo, aresta);
+            aresta = proxima;
         }
-        atual = atual->proximo;
+        libertarMemoriaVertice(grafo, atual);
+        atual = proximo;
+    }
+    grafo->primeiro = NULL;
+    grafo->numVertices = 0;
+    grafo->numArestas = 0;
+    for (int i = 0; i < grafo->limiteIds; i++) grafo->vertices[i] = NULL;
+    grafo->limiteIds = 0;
+    grafo->numIdsLivres = 0;
+    grafo->componentes.numComponentes = 0;
+    grafo->componentesDesatualizados = false;
+    for (int i = 0; i < grafo->coordenadas.capacidade; i++) grafo->coordenadas.ids[i] = -1;
+    grafo->coordenadas.ocupados = 0;
+    for (int i = 0; i < NUM_FREQUENCIAS; i++) grafo->frequencias[i].tamanho = 0;
+    grafo->usadosBlocoVertices = 0;
+    grafo->usadosBlocoArestas = 0;
+    grafo->geracao++;
+    return true;
+}
+
+/**
+ * @brief Reserva de uma vez a memoria dos proximos vertices e arestas
+ * anexarVertice e anexarAresta passam a usar estes dois blocos contiguos em vez de um malloc por
+ * estrutura; quando se esgotam voltam ao malloc. Um vertice ou aresta do bloco que seja removido
+ * so e libertado com o grafo. Se o grafo ja tiver blocos sem nada em uso (ex.: depois de
+ * limparGrafo) sao reaproveitados e so crescem quando forem pequenos para o pedido
+ * @param grafo Apontador para o grafo
+ * @param numVertices Numero de vertices a reservar
+ * @param numArestas Numero de arestas dirigidas a reservar
+ * @return true se reservado, false se os blocos existentes estiverem em uso ou faltar memoria
+ */
+bool reservarBlocosGrafo(Grafo* grafo, int numVertices, int numArestas) {
+    if (grafo == NULL || numVertices < 0 || numArestas < 0) return false;
+    if (grafo->usadosBlocoVertices > 0 || grafo->usadosBlocoArestas > 0) return false;
+    if (!garantirCapacidade(grafo, grafo->limiteIds + numVertices)) return false;
+    if (numVertices > grafo->capacidadeBlocoVertices) {
+        NoVertice* vertices = (NoVertice*)malloc((size_t)numVertices * sizeof(NoVertice));
+        if (vertices == NULL) return false;
+        if (grafo->blocoVertices != NULL) {
+            free(grafo->blocoVertices);
+            ESTAT_LIBERTACAO(ESTAT_VERTICE, (size_t)grafo->capacidadeBlocoVertices * sizeof(NoVertice));
+        }
+        ESTAT_ALOCACAO(ESTAT_VERTICE, (size_t)numVertices * sizeof(NoVertice));
+        grafo->blocoVertices = vertices;
+        grafo->capacidadeBlocoVertices = numVertices;
     }
-    NoVertice* novo = (NoVertice*)malloc(sizeof(NoVertice));
+    if (numArestas > grafo->capacidadeBlocoArestas) {
+        Aresta* arestas = (Aresta*)malloc((size_t)numArestas * sizeof(Aresta));
+        if (arestas == NULL) return false;
+        if (grafo->blocoArestas != NULL) {
+            free(grafo->blocoArestas);
+            ESTAT_LIBERTACAO(ESTAT_ARESTA, (size_t)grafo->capacidadeBlocoArestas * sizeof(Aresta));
+        }
+        ESTAT_ALOCACAO(ESTAT_ARESTA, (size_t)numArestas * sizeof(Aresta));
+        grafo->blocoArestas = arestas;
+        grafo->capacidadeBlocoArestas = numArestas;
+    }
+    return true;
+}
+
+/**
+ * @brief Acrescenta um vertice ao grafo sem verificar se as coordenadas ja existem
+ * Usado por quem ja garante posicoes unicas (ex.: leitura de um instantaneo binario)
+ * @param grafo Apontador para o grafo
+ * @param antena Dados da antena a ser adicionada
+ * @return Apontador para o novo vertice ou NULL em caso de erro
+ */
+NoVertice* anexarVertice(Grafo* grafo, Antena antena) {
+    if (grafo == NULL) return NULL;
+    if (!garantirCapacidade(grafo, grafo->limiteIds + 1)) return NULL;
+    NoVertice* novo = alocarVertice(grafo);
     if (novo == NULL) return NULL;
     novo->dados = antena;
     novo->primeiraAresta = NULL;
+    novo->grauEntrada = 0;
+    if (!adicionarAoGrupoFrequencia(grafo, novo)) {
+        libertarMemoriaVertice(grafo, novo);
+        return NULL;
+    }
+    // reutiliza ids de vertices removidos para manter os arrays densos
+    if (grafo->numIdsLivres > 0) {
+        novo->id = grafo->idsLivres[--grafo->numIdsLivres];
+    }
+    else {
+        novo->id = grafo->limiteIds++;
+        grafo->geracoes[novo->id] = 0;
+    }
+    grafo->vertices[novo->id] = novo;
+    if (!inserirCoordenadas(grafo, novo->id)) {
+        grafo->vertices[novo->id] = NULL;
+        grafo->idsLivres[grafo->numIdsLivres++] = novo->id;
+        removerDoGrupoFrequencia(grafo, novo);
+        libertarMemoriaVertice(grafo, novo);
+        return NULL;
+    }
+    novo->anterior = NULL;
     novo->proximo = grafo->primeiro;
+    if (grafo->primeiro != NULL) grafo->primeiro->anterior = novo;
     grafo->primeiro = novo;
+    // cada vertice novo comeca num componente proprio
+    grafo->componentes.pai[novo->id] = novo->id;
+    grafo->componentes.tamanho[novo->id] = 1;
+    grafo->componentes.proximoMembro[novo->id] = novo->id;
+    grafo->componentes.numComponentes++;
     grafo->numVertices++;
+    grafo->geracao++;
+    novo->geracaoAlteracao = grafo->geracao;
     return novo;
 }
 
@@ -95,6 +529,64 @@ bool existeAresta(NoVertice* origem, NoVertice* destino) {
     return false;
 }
 
+/**
+ * @brief Distancia entre as posicoes de dois vertices segundo uma metrica
+ * @param a Apontador para o primeiro vertice
+ * @param b Apontador para o segundo vertice
+ * @param metrica Metrica a usar
+ * @return Distancia (1 para a metrica unitaria)
+ */
+double distanciaVertices(NoVertice* a, NoVertice* b, MetricaPeso metrica) {
+    double dx = (double)a->dados.posicao.x - b->dados.posicao.x;
+    double dy = (double)a->dados.posicao.y - b->dados.posicao.y;
+    switch (metrica) {
+    case METRICA_EUCLIDIANA: return sqrt(dx * dx + dy * dy);
+    case METRICA_MANHATTAN: return fabs(dx) + fabs(dy);
+    default: return 1.0;
+    }
+}
+
+/**
+ * @brief Recalcula o peso das arestas que saem ou chegam a um vertice
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ */
+static void atualizarPesosVertice(Grafo* grafo, NoVertice* vertice) {
+    int entradasAtualizadas = 0;
+    for (Aresta* a = vertice->primeiraAresta; a != NULL; a = a->proxima) {
+        a->peso = distanciaVertices(vertice, a->destino, grafo->metrica);
+        if (a->gemea != NULL) {
+            a->gemea->peso = a->peso;
+            entradasAtualizadas++;
+        }
+    }
+    if (entradasAtualizadas == vertice->grauEntrada) return;
+    // ha arestas de entrada sem gemea: so se encontram percorrendo o grafo
+    for (NoVertice* v = grafo->primeiro; v != NULL; v = v->proximo) {
+        for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) {
+            if (a->destino == vertice) a->peso = distanciaVertices(v, vertice, grafo->metrica);
+        }
+    }
+}
+
+/**
+ * @brief Define a metrica dos pesos e recalcula o peso de todas as arestas
+ * @param grafo Apontador para o grafo
+ * @param metrica Metrica a usar
+ * @return true se os pesos foram atualizados, false caso contrario
+ */
+bool definirMetricaPesos(Grafo* grafo, MetricaPeso metrica) {
+    if (grafo == NULL) return false;
+    grafo->metrica = metrica;
+    for (NoVertice* v = grafo->primeiro; v != NULL; v = v->proximo) {
+        for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) {
+            a->peso = distanciaVertices(v, a->destino, metrica);
+        }
+    }
+    grafo->geracao++;
+    return true;
+}
+
 /**
  * @brief Adiciona uma aresta entre dois vertices
  * @param grafo Apontador para o grafo
@@ -105,20 +597,327 @@ bool existeAresta(NoVertice* origem, NoVertice* destino) {
 bool adicionarAresta(Grafo* grafo, NoVertice* origem, NoVertice* destino) {
     if (grafo == NULL || origem == NULL || destino == NULL) return false;
     if (existeAresta(origem, destino)) return true;
-    Aresta* novaAresta = (Aresta*)malloc(sizeof(Aresta));
-    if (novaAresta == NULL) return false;
+    if (!anexarAresta(grafo, origem, destino)) return false;
+    // liga a aresta a sua gemea (destino -> origem), se ja existir
+    for (Aresta* a = destino->primeiraAresta; a != NULL; a = a->proxima) {
+        if (a->destino == origem && a->gemea == NULL) {
+            a->gemea = origem->primeiraAresta;
+            origem->primeiraAresta->gemea = a;
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Liga uma aresta ja alocada no inicio da lista da origem (nao falha)
+ * @param grafo Apontador para o grafo
+ * @param origem Apontador para o vertice de origem
+ * @param destino Apontador para o vertice de destino
+ * @param novaAresta Aresta por ligar
+ */
+static void ligarAresta(Grafo* grafo, NoVertice* origem, NoVertice* destino, Aresta* novaAresta) {
     novaAresta->destino = destino;
+    novaAresta->peso = distanciaVertices(origem, destino, grafo->metrica);
+    novaAresta->gemea = NULL;
+    novaAresta->anterior = NULL;
     novaAresta->proxima = origem->primeiraAresta;
+    if (origem->primeiraAresta != NULL) origem->primeiraAresta->anterior = novaAresta;
     origem->primeiraAresta = novaAresta;
+    destino->grauEntrada++;
+    grafo->numArestas++;
+    grafo->geracao++;
+    origem->geracaoAlteracao = grafo->geracao;
+    destino->geracaoAlteracao = grafo->geracao;
+    if (!grafo->componentesDesatualizados) unirComponentes(&grafo->componentes, origem->id, destino->id);
+}
+
+/**
+ * @brief Acrescenta uma aresta no inicio da lista da origem sem verificar se ja existe
+ * @param grafo Apontador para o grafo
+ * @param origem Apontador para o vertice de origem
+ * @param destino Apontador para o vertice de destino
+ * @return true se a aresta foi adicionada, false caso contrario
+ */
+bool anexarAresta(Grafo* grafo, NoVertice* origem, NoVertice* destino) {
+    if (grafo == NULL || origem == NULL || destino == NULL) return false;
+    Aresta* novaAresta = alocarAresta(grafo);
+    if (novaAresta == NULL) return false;
+    ligarAresta(grafo, origem, destino, novaAresta);
     return true;
 }
 
 /**
- * @brief Carrega os dados das antenas de um ficheiro para um grafo
+ * @brief Acrescenta as duas arestas a->b e b->a, ligadas como gemeas, sem verificar se ja existem
+ * @param grafo Apontador para o grafo
+ * @param a Apontador para o primeiro vertice
+ * @param b Apontador para o segundo vertice
+ * @return true se as arestas foram adicionadas, false caso contrario
+ */
+bool anexarArestaDupla(Grafo* grafo, NoVertice* a, NoVertice* b) {
+    if (!anexarAresta(grafo, a, b)) return false;
+    if (!anexarAresta(grafo, b, a)) return false;
+    a->primeiraAresta->gemea = b->primeiraAresta;
+    b->primeiraAresta->gemea = a->primeiraAresta;
+    return true;
+}
+
+/**
+ * @brief Liga como gemeas todas as arestas u->v e v->u que ainda nao o estao, em O(V + E)
+ * @param grafo Apontador para o grafo
+ * @return true se concluido, false em caso de erro de alocacao
+ */
+bool emparelharArestasGemeas(Grafo* grafo) {
+    if (grafo == NULL) return false;
+    // inicioEntradas[v]..inicioEntradas[v+1] guarda as arestas que chegam a v (ordenacao por contagem)
+    int* inicioEntradas = (int*)calloc(grafo->limiteIds + 1, sizeof(int));
+    Aresta** entradas = (Aresta**)malloc((grafo->numArestas > 0 ? grafo->numArestas : 1) * sizeof(Aresta*));
+    int* origens = (int*)malloc((grafo->numArestas > 0 ? grafo->numArestas : 1) * sizeof(int));
+    Aresta** saidaPara = (Aresta**)calloc(grafo->limiteIds > 0 ? grafo->limiteIds : 1, sizeof(Aresta*));
+    if (inicioEntradas == NULL || entradas == NULL || origens == NULL || saidaPara == NULL) {
+        free(inicioEntradas);
+        free(entradas);
+        free(origens);
+        free(saidaPara);
+        return false;
+    }
+    for (NoVertice* v = grafo->primeiro; v != NULL; v = v->proximo) {
+        for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) inicioEntradas[a->destino->id + 1]++;
+    }
+    for (int i = 0; i < grafo->limiteIds; i++) inicioEntradas[i + 1] += inicioEntradas[i];
+    for (NoVertice* v = grafo->primeiro; v != NULL; v = v->proximo) {
+        for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) {
+            int k = inicioEntradas[a->destino->id]++;
+            entradas[k] = a;
+            origens[k] = v->id;
+        }
+    }
+    // depois do ciclo anterior inicioEntradas[v] aponta para o fim das entradas de v
+    int inicio = 0;
+    for (int id = 0; id < grafo->limiteIds; id++) {
+        int fim = inicioEntradas[id];
+        NoVertice* v = grafo->vertices[id];
+        if (v != NULL) {
+            for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) {
+                if (a->gemea == NULL) saidaPara[a->destino->id] = a;
+            }
+            for (int k = inicio; k < fim; k++) {
+                Aresta* saida = saidaPara[origens[k]];
+                if (entradas[k]->gemea == NULL && saida != NULL && saida->gemea == NULL) {
+                    entradas[k]->gemea = saida;
+                    saida->gemea = entradas[k];
+                }
+            }
+            for (Aresta* a = v->primeiraAresta; a != NULL; a = a->proxima) saidaPara[a->destino->id] = NULL;
+        }
+        inicio = fim;
+    }
+    free(inicioEntradas);
+    free(entradas);
+    free(origens);
+    free(saidaPara);
+    return true;
+}
+
+/**
+ * @brief Retira uma aresta da lista do vertice de origem e liberta-a
+ * @param grafo Apontador para o grafo
+ * @param origem Vertice que contem a aresta na sua lista
+ * @param aresta Aresta a remover
+ */
+static void retirarAresta(Grafo* grafo, NoVertice* origem, Aresta* aresta) {
+    if (aresta->anterior != NULL) aresta->anterior->proxima = aresta->proxima;
+    else origem->primeiraAresta = aresta->proxima;
+    if (aresta->proxima != NULL) aresta->proxima->anterior = aresta->anterior;
+    if (aresta->gemea != NULL) aresta->gemea->gemea = NULL;
+    aresta->destino->grauEntrada--;
+    grafo->numArestas--;
+    grafo->geracao++;
+    origem->geracaoAlteracao = grafo->geracao;
+    aresta->destino->geracaoAlteracao = grafo->geracao;
+    libertarMemoriaAresta(grafo, aresta);
+}
+
+/**
+ * @brief Remove todas as arestas que saem ou chegam a um vertice
+ * As arestas de entrada sao encontradas pelas gemeas em O(grau); so se existirem arestas
+ * de entrada sem gemea (arestas so num sentido) e que e percorrido o grafo inteiro
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ * @return true se o vertice tinha arestas (o indice de componentes fica desatualizado)
+ */
+static bool desligarVertice(Grafo* grafo, NoVertice* vertice) {
+    bool tinhaArestas = vertice->primeiraAresta != NULL || vertice->grauEntrada > 0;
+    while (vertice->primeiraAresta != NULL) {
+        Aresta* aresta = vertice->primeiraAresta;
+        if (aresta->gemea != NULL) retirarAresta(grafo, aresta->destino, aresta->gemea);
+        retirarAresta(grafo, vertice, aresta);
+    }
+    if (vertice->grauEntrada > 0) {
+        for (NoVertice* v = grafo->primeiro; v != NULL && vertice->grauEntrada > 0; v = v->proximo) {
+            Aresta* aresta = v->primeiraAresta;
+            while (aresta != NULL) {
+                Aresta* proxima = aresta->proxima;
+                if (aresta->destino == vertice) retirarAresta(grafo, v, aresta);
+                aresta = proxima;
+            }
+        }
+    }
+    // o union-find nao separa componentes; um vertice isolado e um componente so seu e nao invalida o indice
+    if (tinhaArestas) grafo->componentesDesatualizados = true;
+    grafo->geracao++;
+    return tinhaArestas;
+}
+
+/**
+ * @brief Verifica se um apontador e um vertice deste grafo
+ * Apanha NULL e vertices de outro grafo, mas le vertice->id: o apontador tem de estar vivo.
+ * Um vertice removido ja foi libertado, por isso quem guarda vertices entre alteracoes usa RefVertice
+ */
+static bool verticeDoGrafo(Grafo* grafo, NoVertice* vertice) {
+    return grafo != NULL && vertice != NULL && vertice->id >= 0 && vertice->id < grafo->limiteIds &&
+        grafo->vertices[vertice->id] == vertice;
+}
+
+/**
+ * @brief Remove um vertice e todas as suas arestas do grafo
+ * A referencia deixa de resolver (a geracao do id avanca) e o id pode ser reutilizado
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia do vertice a remover
+ * @return true se removido, false se a referencia ja nao resolver
+ */
+bool removerVertice(Grafo* grafo, RefVertice ref) {
+    NoVertice* vertice = resolverReferencia(grafo, ref);
+    if (vertice == NULL) return false;
+    if (!desligarVertice(grafo, vertice) && !grafo->componentesDesatualizados) grafo->componentes.numComponentes--;
+    removerDoGrupoFrequencia(grafo, vertice);
+    removerCoordenadas(grafo, vertice->id);
+    if (vertice->anterior != NULL) vertice->anterior->proximo = vertice->proximo;
+    else grafo->primeiro = vertice->proximo;
+    if (vertice->proximo != NULL) vertice->proximo->anterior = vertice->anterior;
+    grafo->vertices[vertice->id] = NULL;
+    grafo->geracoes[vertice->id]++;
+    grafo->idsLivres[grafo->numIdsLivres++] = vertice->id;
+    grafo->numVertices--;
+    libertarMemoriaVertice(grafo, vertice);
+    return true;
+}
+
+/**
+ * @brief Muda a posicao de um vertice; as arestas mantem-se e os seus pesos sao recalculados
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia do vertice
+ * @param x Nova coordenada x
+ * @param y Nova coordenada y
+ * @return true se movido, false se a referencia nao resolver ou as coordenadas forem invalidas ou estiverem ocupadas
+ */
+bool moverVertice(Grafo* grafo, RefVertice ref, int x, int y) {
+    NoVertice* vertice = resolverReferencia(grafo, ref);
+    if (vertice == NULL || x < 0 || y < 0) return false;
+    int ocupante = procurarCoordenadas(grafo, x, y);
+    if (ocupante == vertice->id) return true;
+    if (ocupante >= 0) return false;
+    removerCoordenadas(grafo, vertice->id);
+    vertice->dados.posicao.x = x;
+    vertice->dados.posicao.y = y;
+    colocarCoordenadas(grafo, vertice->id);
+    if (grafo->metrica != METRICA_UNITARIA) atualizarPesosVertice(grafo, vertice);
+    grafo->geracao++;
+    vertice->geracaoAlteracao = grafo->geracao;
+    return true;
+}
+
+/**
+ * @brief Muda a frequencia de um vertice e refaz as suas ligacoes
+ * As arestas antigas sao removidas e o vertice e ligado a todas as antenas da nova frequencia,
+ * mantendo a regra de carregarDadosGrafo; o custo e O(grau + tamanho do novo grupo).
+ * Toda a memoria e reservada antes de mexer no grafo, por isso em caso de falha nada muda
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia do vertice
+ * @param frequencia Nova frequencia
+ * @return true se alterado, false se a referencia nao resolver ou faltar memoria (grafo inalterado)
+ */
+bool alterarFrequencia(Grafo* grafo, RefVertice ref, char frequencia) {
+    NoVertice* vertice = resolverReferencia(grafo, ref);
+    if (vertice == NULL) return false;
+    if (vertice->dados.frequencia == frequencia) return true;
+    GrupoFrequencia* grupo = &grafo->frequencias[(unsigned char)frequencia];
+    if (grupo->tamanho == grupo->capacidade) {
+        int novaCapacidade = grupo->capacidade > 0 ? grupo->capacidade * 2 : 8;
+        NoVertice** membros = (NoVertice**)realloc(grupo->membros, novaCapacidade * sizeof(NoVertice*));
+        if (membros == NULL) return false;
+        grupo->membros = membros;
+        grupo->capacidade = novaCapacidade;
+    }
+    // duas arestas por membro do novo grupo, encadeadas por proxima ate serem ligadas
+    int numNovas = 2 * grupo->tamanho;
+    Aresta* novas = NULL;
+    for (int i = 0; i < numNovas; i++) {
+        Aresta* aresta = (Aresta*)malloc(sizeof(Aresta));
+        if (aresta == NULL) {
+            while (novas != NULL) {
+                Aresta* proxima = novas->proxima;
+                free(novas);
+                ESTAT_LIBERTACAO(ESTAT_ARESTA, sizeof(Aresta));
+                novas = proxima;
+            }
+            return false;
+        }
+        ESTAT_ALOCACAO(ESTAT_ARESTA, sizeof(Aresta));
+        aresta->proxima = novas;
+        novas = aresta;
+    }
+    desligarVertice(grafo, vertice);
+    removerDoGrupoFrequencia(grafo, vertice);
+    vertice->dados.frequencia = frequencia;
+    vertice->geracaoAlteracao = ++grafo->geracao;
+    int tamanho = grupo->tamanho;
+    adicionarAoGrupoFrequencia(grafo, vertice); // ha capacidade reservada, nao falha
+    for (int i = 0; i < tamanho; i++) {
+        NoVertice* membro = grupo->membros[i];
+        Aresta* ida = novas;
+        Aresta* volta = novas->proxima;
+        novas = volta->proxima;
+        ligarAresta(grafo, vertice, membro, ida);
+        ligarAresta(grafo, membro, vertice, volta);
+        ida->gemea = volta;
+        volta->gemea = ida;
+    }
+    return true;
+}
+
+/**
+ * @brief Obtem uma referencia estavel para o vertice com um dado id
+ * @param grafo Apontador para o grafo
+ * @param id Id do vertice
+ * @return Referencia (id -1 se nao houver vertice com esse id)
+ */
+RefVertice obterReferencia(Grafo* grafo, int id) {
+    RefVertice ref = { -1, 0 };
+    if (grafo == NULL || id < 0 || id >= grafo->limiteIds || grafo->vertices[id] == NULL) return ref;
+    ref.id = id;
+    ref.geracao = grafo->geracoes[id];
+    return ref;
+}
+
+/**
+ * @brief Resolve uma referencia para o vertice, detetando referencias antigas
+ * @param grafo Apontador para o grafo
+ * @param ref Referencia obtida com obterReferencia
+ * @return Apontador para o vertice ou NULL se ele ja tiver sido removido
+ */
+NoVertice* resolverReferencia(Grafo* grafo, RefVertice ref) {
+    if (grafo == NULL || ref.id < 0 || ref.id >= grafo->limiteIds) return NULL;
+    if (grafo->geracoes[ref.id] != ref.geracao) return NULL;
+    return grafo->vertices[ref.id];
+}
+
+/**
+ * @brief Le o mapa de antenas para um grafo novo (o trabalho de carregarDadosGrafo, sem a instrumentacao)
  * @param nomeFicheiro Nome do ficheiro a ser lido
  * @return Apontador para o grafo criado ou NULL em caso de erro
  */
-Grafo* carregarDadosGrafo(const char* nomeFicheiro) {
+static Grafo* lerDadosGrafo(const char* nomeFicheiro) {
     FILE* ficheiro = fopen(nomeFicheiro, "r");
     if (ficheiro == NULL) {
         perror("Erro ao abrir ficheiro");
@@ -148,21 +947,35 @@ Grafo* carregarDadosGrafo(const char* nomeFicheiro) {
         y++;
     }
     fclose(ficheiro);
-    NoVertice* v1 = grafo->primeiro;
-    while (v1 != NULL) {
-        NoVertice* v2 = v1->proximo;
-        while (v2 != NULL) {
-            if (v1->dados.frequencia == v2->dados.frequencia) {
-                adicionarAresta(grafo, v1, v2);
-                adicionarAresta(grafo, v2, v1);
+    // so antenas da mesma frequencia sao ligadas, por isso basta percorrer cada grupo
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        GrupoFrequencia* grupo = &grafo->frequencias[f];
+        for (int i = 0; i < grupo->tamanho; i++) {
+            for (int j = i + 1; j < grupo->tamanho; j++) {
+                if (!anexarArestaDupla(grafo, grupo->membros[i], grupo->membros[j])) {
+                    libertarGrafo(grafo);
+                    return NULL;
+                }
             }
-            v2 = v2->proximo;
         }
-        v1 = v1->proximo;
     }
     return grafo;
 }
 
+/**
+ * @brief Carrega os dados das antenas de um ficheiro para um grafo
+ * @param nomeFicheiro Nome do ficheiro a ser lido
+ * @return Apontador para o grafo criado ou NULL em caso de erro
+ */
+Grafo* carregarDadosGrafo(const char* nomeFicheiro) {
+    // uma so saida para que o tempo das chamadas que falham tambem seja registado
+    ESTAT_INICIO(ESTAT_CARREGAR_DADOS_GRAFO);
+    Grafo* grafo = lerDadosGrafo(nomeFicheiro);
+    if (grafo != NULL) ESTAT_VISITAS(ESTAT_CARREGAR_DADOS_GRAFO, grafo->numVertices, grafo->numArestas);
+    ESTAT_FIM(ESTAT_CARREGAR_DADOS_GRAFO);
+    return grafo;
+}
+
 /**
  * @brief Busca em profundidade a partir de um vertice
  * @param grafo Apontador para o grafo
@@ -221,6 +1034,7 @@ bool buscaEmProfundidade(Grafo* grafo, NoVertice* verticeInicial, bool* visitado
 Fila* inicializarFila() {
     Fila* fila = (Fila*)malloc(sizeof(Fila));
     if (fila == NULL) return NULL;
+    ESTAT_ALOCACAO(ESTAT_FILA, sizeof(Fila));
     fila->frente = NULL;
     fila->tras = NULL;
     return fila;
@@ -245,6 +1059,7 @@ bool enfileirar(Fila* fila, NoVertice* valor) {
     if (fila == NULL || valor == NULL) return false;
     ElementoFila* novoElemento = (ElementoFila*)malloc(sizeof(ElementoFila));
     if (novoElemento == NULL) return false;
+    ESTAT_ALOCACAO(ESTAT_ELEMENTO_FILA, sizeof(ElementoFila));
     novoElemento->valor = valor;
     novoElemento->proximo = NULL;
     if (filaVazia(fila)) {
@@ -269,6 +1084,7 @@ NoVertice* desenfileirar(Fila* fila) {
     fila->frente = elementoRemovido->proximo;
     if (fila->frente == NULL) fila->tras = NULL;
     free(elementoRemovido);
+    ESTAT_LIBERTACAO(ESTAT_ELEMENTO_FILA, sizeof(ElementoFila));
     return valor;
 }
 
@@ -281,19 +1097,16 @@ bool libertarFila(Fila* fila) {
     if (fila == NULL) return false;
     while (!filaVazia(fila)) desenfileirar(fila);
     free(fila);
+    ESTAT_LIBERTACAO(ESTAT_FILA, sizeof(Fila));
     return true;
 }
 
 /**
- * @brief Busca em largura a partir de um vertice
- * @param grafo Apontador para o grafo
- * @param verticeInicial Apontador para o vertice inicial
- * @param resultado Lista para armazenar os vertices visitados
- * @param tamanhoResultado Apontador para o tamanho do resultado
+ * @brief Percurso em largura de buscaEmLargura, sem o registo do tempo (argumentos ja validados)
  * @return true se a busca foi realizada, false caso contrario
  */
-bool buscaEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, NoVertice*** resultado, int* tamanhoResultado) {
-    if (grafo == NULL || verticeInicial == NULL || visitados == NULL || resultado == NULL || tamanhoResultado == NULL) return false;
+static bool percorrerEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, NoVertice*** resultado, int* tamanhoResultado) {
+    ESTAT_CONTADOR(arestasVisitadas);
     if (*resultado != NULL) {
         free(*resultado); // Evitar vazamento se j alocado
         *resultado = NULL;
@@ -333,6 +1146,7 @@ bool buscaEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, No
         (*tamanhoResultado)++;
         Aresta* aresta = verticeAtual->primeiraAresta;
         while (aresta != NULL) {
+            ESTAT_INCREMENTA(arestasVisitadas);
             int destinoIndice = 0;
             atual = grafo->primeiro;
             while (atual != NULL) {
@@ -348,8 +1162,26 @@ bool buscaEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, No
         }
     }
     libertarFila(fila);
+    ESTAT_VISITAS(ESTAT_BUSCA_LARGURA, *tamanhoResultado, arestasVisitadas);
     return true;
 }
+
+/**
+ * @brief Busca em largura a partir de um vertice
+ * @param grafo Apontador para o grafo
+ * @param verticeInicial Apontador para o vertice inicial
+ * @param resultado Lista para armazenar os vertices visitados
+ * @param tamanhoResultado Apontador para o tamanho do resultado
+ * @return true se a busca foi realizada, false caso contrario
+ */
+bool buscaEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, NoVertice*** resultado, int* tamanhoResultado) {
+    if (grafo == NULL || verticeInicial == NULL || visitados == NULL || resultado == NULL || tamanhoResultado == NULL) return false;
+    // uma so saida para que o tempo das chamadas que falham tambem seja registado
+    ESTAT_INICIO(ESTAT_BUSCA_LARGURA);
+    bool sucesso = percorrerEmLargura(grafo, verticeInicial, visitados, resultado, tamanhoResultado);
+    ESTAT_FIM(ESTAT_BUSCA_LARGURA);
+    return sucesso;
+}
 /**
  * @brief Adiciona um vertice a um caminho
  * @param caminho Apontador para o caminho
@@ -359,6 +1191,7 @@ bool buscaEmLargura(Grafo* grafo, NoVertice* verticeInicial, bool* visitados, No
 ElementoCaminho* adicionarVerticeCaminho(ElementoCaminho* caminho, NoVertice* vertice) {
     ElementoCaminho* novo = (ElementoCaminho*)malloc(sizeof(ElementoCaminho));
     if (novo == NULL) return NULL;
+    ESTAT_ALOCACAO(ESTAT_ELEMENTO_CAMINHO, sizeof(ElementoCaminho));
     novo->vertice = vertice;
     novo->proximo = NULL;
     if (caminho == NULL) {
@@ -401,6 +1234,7 @@ bool adicionarCaminho(ListaCaminho** caminhos, ElementoCaminho* caminho) {
     if (caminhos == NULL || caminho == NULL) return false;
     ListaCaminho* novoCaminho = (ListaCaminho*)malloc(sizeof(ListaCaminho));
     if (novoCaminho == NULL) return false;
+    ESTAT_ALOCACAO(ESTAT_LISTA_CAMINHO, sizeof(ListaCaminho));
     novoCaminho->caminho = caminho;
     novoCaminho->proximo = NULL;
     if (*caminhos == NULL) {
@@ -425,6 +1259,7 @@ bool libertarCaminho(ElementoCaminho* caminho) {
     while (atual != NULL) {
         ElementoCaminho* proximo = atual->proximo;
         free(atual);
+        ESTAT_LIBERTACAO(ESTAT_ELEMENTO_CAMINHO, sizeof(ElementoCaminho));
         atual = proximo;
     }
     return true;
@@ -444,6 +1279,7 @@ bool libertarCaminhos(ListaCaminho* caminhos) {
             libertarCaminho(atual->caminho);
         }
         free(atual);
+        ESTAT_LIBERTACAO(ESTAT_LISTA_CAMINHO, sizeof(ListaCaminho));
         atual = proximo;
     }
     return true;
@@ -462,6 +1298,8 @@ bool libertarCaminhos(ListaCaminho* caminhos) {
  */
 bool encontrarCaminhosRecursivo(Grafo* grafo, NoVertice* atual, NoVertice* destino, bool* visitados, ElementoCaminho* caminho, ListaCaminho** caminhos) {
     if (grafo == NULL || atual == NULL || destino == NULL || visitados == NULL || caminhos == NULL) return false;
+    ESTAT_CHAMADA(ESTAT_CAMINHOS_RECURSIVO);
+    ESTAT_CONTADOR(arestasVisitadas);
     int indiceAtual = 0;
     NoVertice* temp = grafo->primeiro;
     while (temp != NULL) {
@@ -486,6 +1324,7 @@ bool encontrarCaminhosRecursivo(Grafo* grafo, NoVertice* atual, NoVertice* desti
     else {
         Aresta* aresta = atual->primeiraAresta;
         while (aresta != NULL) {
+            ESTAT_INCREMENTA(arestasVisitadas);
             int destinoIndice = 0;
             temp = grafo->primeiro;
             while (temp != NULL) {
@@ -502,6 +1341,7 @@ bool encontrarCaminhosRecursivo(Grafo* grafo, NoVertice* atual, NoVertice* desti
         }
     }
     visitados[indiceAtual] = false;
+    ESTAT_VISITAS(ESTAT_CAMINHOS_RECURSIVO, 1, arestasVisitadas);
     return encontrouCaminho;
 }
 
@@ -515,11 +1355,15 @@ bool encontrarCaminhosRecursivo(Grafo* grafo, NoVertice* atual, NoVertice* desti
  */
 bool encontrarCaminhos(Grafo* grafo, NoVertice* origem, NoVertice* destino, ListaCaminho** caminhos) {
     if (grafo == NULL || origem == NULL || destino == NULL || caminhos == NULL) return false;
+    ESTAT_INICIO(ESTAT_ENCONTRAR_CAMINHOS);
+    bool resultado = false;
     bool* visitados = (bool*)calloc(grafo->numVertices, sizeof(bool));
-    if (visitados == NULL) return false;
-    *caminhos = NULL;
-    bool resultado = encontrarCaminhosRecursivo(grafo, origem, destino, visitados, NULL, caminhos);
-    free(visitados);
+    if (visitados != NULL) {
+        *caminhos = NULL;
+        resultado = encontrarCaminhosRecursivo(grafo, origem, destino, visitados, NULL, caminhos);
+        free(visitados);
+    }
+    ESTAT_FIM(ESTAT_ENCONTRAR_CAMINHOS);
     return resultado;
 }
 
@@ -532,12 +1376,24 @@ bool encontrarCaminhos(Grafo* grafo, NoVertice* origem, NoVertice* destino, List
  */
 NoVertice* encontrarVerticePorCoordenadas(Grafo* grafo, int x, int y) {
     if (grafo == NULL) return NULL;
-    NoVertice* atual = grafo->primeiro;
-    while (atual != NULL) {
-        if (atual->dados.posicao.x == x && atual->dados.posicao.y == y) return atual;
-        atual = atual->proximo;
-    }
-    return NULL;
+    int id = procurarCoordenadas(grafo, x, y);
+    return id >= 0 ? grafo->vertices[id] : NULL;
+}
+
+/**
+ * @brief Devolve os vertices de uma frequencia sem copiar (vista sobre o indice de frequencias)
+ * A vista deixa de ser valida quando o grafo e alterado
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia a ser procurada
+ * @param tamanho Apontador para o numero de vertices da frequencia
+ * @return Array so de leitura com os vertices ou NULL se nao existirem
+ */
+NoVertice* const* obterVerticesFrequencia(Grafo* grafo, char frequencia, int* tamanho) {
+    if (tamanho != NULL) *tamanho = 0;
+    if (grafo == NULL || tamanho == NULL) return NULL;
+    GrupoFrequencia* grupo = &grafo->frequencias[(unsigned char)frequencia];
+    *tamanho = grupo->tamanho;
+    return grupo->tamanho > 0 ? grupo->membros : NULL;
 }
 
 /**
@@ -550,16 +1406,10 @@ NoVertice* encontrarVerticePorCoordenadas(Grafo* grafo, int x, int y) {
  */
 bool encontrarVerticesPorFrequencia(Grafo* grafo, char frequencia, NoVertice** vertices, int* tamanhoVertices, int maxVertices) {
     if (grafo == NULL || vertices == NULL || tamanhoVertices == NULL) return false;
-    *tamanhoVertices = 0;
-    NoVertice* atual = grafo->primeiro;
-    while (atual != NULL) {
-        if (atual->dados.frequencia == frequencia) {
-            if (*tamanhoVertices >= maxVertices) break;
-            vertices[*tamanhoVertices] = atual;
-            (*tamanhoVertices)++;
-        }
-        atual = atual->proximo;
-    }
+    int tamanhoGrupo = 0;
+    NoVertice* const* grupo = obterVerticesFrequencia(grafo, frequencia, &tamanhoGrupo);
+    *tamanhoVertices = tamanhoGrupo < maxVertices ? tamanhoGrupo : maxVertices;
+    if (*tamanhoVertices > 0) memcpy(vertices, grupo, *tamanhoVertices * sizeof(NoVertice*));
     return true;
 }
 
@@ -575,26 +1425,12 @@ bool encontrarVerticesPorFrequencia(Grafo* grafo, char frequencia, NoVertice** v
 bool encontrarIntersecoes(Grafo* grafo, char frequenciaA, char frequenciaB, Intersecao* intersecoes, int* tamanhoIntersecoes, int maxIntersecoes) {
     if (grafo == NULL || intersecoes == NULL || tamanhoIntersecoes == NULL) return false;
     *tamanhoIntersecoes = 0;
-    int maxVertices = grafo->numVertices; // Tamanho mximo dos arrays verticesA e verticesB
-    NoVertice** verticesA = (NoVertice**)malloc(maxVertices * sizeof(NoVertice*));
-    if (verticesA == NULL) return false;
     int tamanhoVerticesA = 0;
-    if (!encontrarVerticesPorFrequencia(grafo, frequenciaA, verticesA, &tamanhoVerticesA, maxVertices) || tamanhoVerticesA == 0) {
-        free(verticesA);
-        return false;
-    }
-    NoVertice** verticesB = (NoVertice**)malloc(maxVertices * sizeof(NoVertice*));
-    if (verticesB == NULL) {
-        free(verticesA);
-        return false;
-    }
     int tamanhoVerticesB = 0;
-    if (!encontrarVerticesPorFrequencia(grafo, frequenciaB, verticesB, &tamanhoVerticesB, maxVertices) || tamanhoVerticesB == 0) {
-        free(verticesA);
-        free(verticesB);
-        return false;
-    }
-    for (int i = 0; i < tamanhoVerticesA; i++) {
+    NoVertice* const* verticesA = obterVerticesFrequencia(grafo, frequenciaA, &tamanhoVerticesA);
+    NoVertice* const* verticesB = obterVerticesFrequencia(grafo, frequenciaB, &tamanhoVerticesB);
+    if (tamanhoVerticesA == 0 || tamanhoVerticesB == 0) return false;
+    for (int i = 0; i < tamanhoVerticesA && *tamanhoIntersecoes < maxIntersecoes; i++) {
         for (int j = 0; j < tamanhoVerticesB; j++) {
             if (*tamanhoIntersecoes >= maxIntersecoes) break;
             intersecoes[*tamanhoIntersecoes].antenaA = verticesA[i]->dados.posicao;
@@ -602,7 +1438,183 @@ bool encontrarIntersecoes(Grafo* grafo, char frequenciaA, char frequenciaB, Inte
             (*tamanhoIntersecoes)++;
         }
     }
-    free(verticesA);
-    free(verticesB);
     return (*tamanhoIntersecoes > 0);
+}
+
+/**
+ * @brief Inicia um iterador sobre os vertices de uma frequencia
+ * @param iterador Apontador para o iterador
+ * @param grafo Apontador para o grafo
+ * @param frequencia Frequencia a percorrer
+ * @return true se o iterador foi iniciado, false caso contrario
+ */
+bool iniciarIteradorFrequencia(IteradorFrequencia* iterador, Grafo* grafo, char frequencia) {
+    if (iterador == NULL || grafo == NULL) return false;
+    iterador->grafo = grafo;
+    iterador->frequencia = frequencia;
+    iterador->posicao = 0;
+    return true;
+}
+
+/**
+ * @brief Devolve o vertice seguinte da frequencia
+ * O grupo e relido em cada chamada, por isso vertices acrescentados durante a iteracao tambem sao produzidos
+ * @param iterador Apontador para o iterador
+ * @return Apontador para o vertice ou NULL quando nao ha mais vertices
+ */
+NoVertice* proximoVerticeFrequencia(IteradorFrequencia* iterador) {
+    if (iterador == NULL || iterador->grafo == NULL) return NULL;
+    GrupoFrequencia* grupo = &iterador->grafo->frequencias[(unsigned char)iterador->frequencia];
+    if (iterador->posicao >= grupo->tamanho) return NULL;
+    return grupo->membros[iterador->posicao++];
+}
+
+/**
+ * @brief Termina um iterador de frequencia
+ * @param iterador Apontador para o iterador
+ * @return true se terminado com sucesso, false caso contrario
+ */
+bool fecharIteradorFrequencia(IteradorFrequencia* iterador) {
+    if (iterador == NULL) return false;
+    iterador->grafo = NULL;
+    return true;
+}
+
+/**
+ * @brief Inicia um iterador sobre as intersecoes entre antenas de duas frequencias
+ * Produz os mesmos pares que encontrarIntersecoes, pela mesma ordem, mas sem limite de capacidade
+ * @param iterador Apontador para o iterador
+ * @param grafo Apontador para o grafo
+ * @param frequenciaA Frequencia A
+ * @param frequenciaB Frequencia B
+ * @return true se o iterador foi iniciado, false caso contrario
+ */
+bool iniciarIteradorIntersecoes(IteradorIntersecoes* iterador, Grafo* grafo, char frequenciaA, char frequenciaB) {
+    if (iterador == NULL || grafo == NULL) return false;
+    iterador->grafo = grafo;
+    iterador->frequenciaA = frequenciaA;
+    iterador->frequenciaB = frequenciaB;
+    iterador->posicaoA = 0;
+    iterador->posicaoB = 0;
+    return true;
+}
+
+/**
+ * @brief Produz a intersecao seguinte
+ * @param iterador Apontador para o iterador
+ * @param intersecao Apontador onde e escrita a intersecao
+ * @return true se foi produzida uma intersecao, false quando nao ha mais
+ */
+bool proximaIntersecao(IteradorIntersecoes* iterador, Intersecao* intersecao) {
+    if (iterador == NULL || iterador->grafo == NULL || intersecao == NULL) return false;
+    GrupoFrequencia* grupoA = &iterador->grafo->frequencias[(unsigned char)iterador->frequenciaA];
+    GrupoFrequencia* grupoB = &iterador->grafo->frequencias[(unsigned char)iterador->frequenciaB];
+    if (grupoB->tamanho == 0) return false;
+    if (iterador->posicaoB >= grupoB->tamanho) {
+        iterador->posicaoA++;
+        iterador->posicaoB = 0;
+    }
+    if (iterador->posicaoA >= grupoA->tamanho) return false;
+    intersecao->antenaA = grupoA->membros[iterador->posicaoA]->dados.posicao;
+    intersecao->antenaB = grupoB->membros[iterador->posicaoB]->dados.posicao;
+    iterador->posicaoB++;
+    return true;
+}
+
+/**
+ * @brief Termina um iterador de intersecoes
+ * @param iterador Apontador para o iterador
+ * @return true se terminado com sucesso, false caso contrario
+ */
+bool fecharIteradorIntersecoes(IteradorIntersecoes* iterador) {
+    if (iterador == NULL) return false;
+    iterador->grafo = NULL;
+    return true;
+}
+
+/**
+ * @brief Devolve o id do componente conexo de um vertice
+ * O indice union-find acompanha as insercoes em tempo quase constante, mas nao sabe separar
+ * componentes: depois de uma remocao de arestas (removerVertice ou alterarFrequencia de um vertice
+ * ligado) a consulta seguinte, desta funcao ou das outras de componentes, reconstroi-o em O(V + E).
+ * Alternar remocoes e consultas custa portanto O(V + E) por consulta; agrupar as remocoes amortiza-o
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ * @return Id do componente (id do vertice representante) ou -1 em caso de erro
+ */
+int encontrarComponente(Grafo* grafo, NoVertice* vertice) {
+    if (!verticeDoGrafo(grafo, vertice)) return -1;
+    atualizarComponentes(grafo);
+    return raizComponente(&grafo->componentes, vertice->id);
+}
+
+/**
+ * @brief Verifica se dois vertices estao no mesmo componente conexo
+ * @param grafo Apontador para o grafo
+ * @param a Apontador para o primeiro vertice
+ * @param b Apontador para o segundo vertice
+ * @return true se existe caminho entre os dois, false caso contrario
+ */
+bool mesmoComponente(Grafo* grafo, NoVertice* a, NoVertice* b) {
+    int componenteA = encontrarComponente(grafo, a);
+    if (componenteA < 0) return false;
+    return componenteA == encontrarComponente(grafo, b);
+}
+
+/**
+ * @brief Devolve o numero de vertices do componente de um vertice
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para o vertice
+ * @return Tamanho do componente ou 0 em caso de erro
+ */
+int tamanhoComponente(Grafo* grafo, NoVertice* vertice) {
+    int componente = encontrarComponente(grafo, vertice);
+    if (componente < 0) return 0;
+    return grafo->componentes.tamanho[componente];
+}
+
+/**
+ * @brief Devolve o numero de componentes conexos do grafo
+ * @param grafo Apontador para o grafo
+ * @return Numero de componentes ou 0 se o grafo for NULL
+ */
+int numeroComponentes(Grafo* grafo) {
+    if (grafo == NULL) return 0;
+    atualizarComponentes(grafo);
+    return grafo->componentes.numComponentes;
+}
+
+/**
+ * @brief Devolve o membro seguinte do componente, permitindo percorre-lo sem alocar memoria
+ * A lista de membros e circular: a enumeracao termina quando se volta ao vertice inicial
+ * @param grafo Apontador para o grafo
+ * @param membro Apontador para o membro atual
+ * @return Apontador para o membro seguinte ou NULL em caso de erro
+ */
+NoVertice* proximoMembroComponente(Grafo* grafo, NoVertice* membro) {
+    if (encontrarComponente(grafo, membro) < 0) return NULL;
+    return grafo->vertices[grafo->componentes.proximoMembro[membro->id]];
+}
+
+/**
+ * @brief Lista todos os vertices do componente de um vertice
+ * @param grafo Apontador para o grafo
+ * @param vertice Apontador para um vertice do componente
+ * @param membros Array alocado com os membros do componente (a libertar pelo chamador)
+ * @param tamanhoMembros Apontador para o numero de membros
+ * @return true se o componente foi listado, false caso contrario
+ */
+bool listarComponente(Grafo* grafo, NoVertice* vertice, NoVertice*** membros, int* tamanhoMembros) {
+    if (membros == NULL || tamanhoMembros == NULL) return false;
+    int tamanho = tamanhoComponente(grafo, vertice);
+    if (tamanho == 0) return false;
+    *membros = (NoVertice**)malloc(tamanho * sizeof(NoVertice*));
+    if (*membros == NULL) return false;
+    *tamanhoMembros = 0;
+    NoVertice* atual = vertice;
+    do {
+        (*membros)[(*tamanhoMembros)++] = atual;
+        atual = grafo->vertices[grafo->componentes.proximoMembro[atual->id]];
+    } while (atual != vertice);
+    return true;
 }
\ No newline at end of file
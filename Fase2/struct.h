@@ -10,6 +10,8 @@
 #ifndef ESTRUTURAS_H
 #define ESTRUTURAS_H
 
+#include <stdbool.h>
+
  /**
   * @brief Estrutura para representar as coordenadas de uma antena
   */
@@ -33,6 +35,11 @@ typedef struct NoVertice {
     Antena dados;           
     struct Aresta* primeiraAresta; // lista de arestas
     struct NoVertice* proximo; 
+    struct NoVertice* anterior; // vertice anterior na lista
+    int id;                 // indice denso do vertice no grafo
+    int posicaoGrupo;       // posicao no grupo da sua frequencia
+    int grauEntrada;        // numero de arestas que chegam ao vertice
+    unsigned long geracaoAlteracao; // geracao do grafo na ultima alteracao das arestas ou dados do vertice
 } NoVertice;
 
 /**
@@ -41,14 +48,85 @@ typedef struct NoVertice {
 typedef struct Aresta {
     NoVertice* destino;     
     struct Aresta* proxima; // proxima aresta na lista
+    struct Aresta* anterior; // aresta anterior na lista
+    struct Aresta* gemea;   // aresta no sentido contrario (destino -> origem) ou NULL
+    double peso;            // custo da ligacao, segundo a metrica do grafo
 } Aresta;
 
+/**
+ * @brief Metrica usada para calcular o peso das arestas a partir das posicoes
+ */
+typedef enum MetricaPeso {
+    METRICA_UNITARIA,       // todas as arestas pesam 1 (numero de saltos)
+    METRICA_EUCLIDIANA,     // distancia em linha reta entre as antenas
+    METRICA_MANHATTAN       // |dx| + |dy|
+} MetricaPeso;
+
+/**
+ * @brief Referencia estavel para um vertice: id mais a geracao do id
+ * Quando o vertice e removido a geracao do id muda e a referencia deixa de resolver
+ */
+typedef struct RefVertice {
+    int id;                 // id do vertice
+    unsigned int geracao;   // geracao do id quando a referencia foi obtida
+} RefVertice;
+
+/**
+ * @brief Indice de componentes conexos mantido com union-find
+ * Os arrays sao indexados pelo id do vertice
+ */
+typedef struct IndiceComponentes {
+    int* pai;               // pai de cada vertice na floresta union-find
+    int* tamanho;           // numero de membros do componente (valido na raiz)
+    int* proximoMembro;     // lista circular com os membros de cada componente
+    int numComponentes;     // numero de componentes conexos
+} IndiceComponentes;
+
+/**
+ * @brief Tabela de dispersao (enderecamento aberto) das coordenadas para o id do vertice
+ */
+typedef struct IndiceCoordenadas {
+    int* ids;               // id guardado em cada posicao ou -1 se vazia
+    int capacidade;         // numero de posicoes (potencia de 2)
+    int ocupados;           // numero de posicoes ocupadas
+} IndiceCoordenadas;
+
+/**
+ * @brief Grupo contiguo com os vertices de uma frequencia
+ */
+typedef struct GrupoFrequencia {
+    NoVertice** membros;    // vertices com a frequencia, por ordem de insercao
+    int tamanho;            // numero de membros
+    int capacidade;         // tamanho alocado do array de membros
+} GrupoFrequencia;
+
+#define NUM_FREQUENCIAS 256 // uma entrada por valor de char
+
 /**
  * @brief Estrutura para representar um grafo
  */
 typedef struct Grafo{
     NoVertice* primeiro;    // primeiro vertice da lista
     int numVertices;        // numero de vertices
+    int numArestas;         // numero de arestas (dirigidas)
+    NoVertice** vertices;   // vertices indexados pelo id (NULL nos ids livres)
+    int capacidade;         // tamanho alocado dos arrays indexados por id
+    int limiteIds;          // ids em uso estao em [0, limiteIds)
+    unsigned int* geracoes; // geracao de cada id, incrementada quando o vertice e removido
+    int* idsLivres;         // pilha de ids libertados para reutilizar
+    int numIdsLivres;       // numero de ids livres
+    unsigned long geracao;  // incrementado em cada alteracao do grafo
+    MetricaPeso metrica;    // metrica dos pesos das arestas
+    IndiceComponentes componentes; // componentes conexos
+    bool componentesDesatualizados; // o union-find tem de ser reconstruido (apos remocoes)
+    IndiceCoordenadas coordenadas; // procura de vertices por coordenadas
+    GrupoFrequencia frequencias[NUM_FREQUENCIAS]; // vertices agrupados por frequencia
+    NoVertice* blocoVertices; // vertices reservados de uma vez com reservarBlocosGrafo (NULL se nao houver)
+    int capacidadeBlocoVertices; // vertices no bloco
+    int usadosBlocoVertices; // vertices do bloco ja entregues
+    Aresta* blocoArestas;   // arestas reservadas de uma vez com reservarBlocosGrafo (NULL se nao houver)
+    int capacidadeBlocoArestas; // arestas no bloco
+    int usadosBlocoArestas; // arestas do bloco ja entregues
 } Grafo;
 
 /**
@@ -91,4 +169,204 @@ typedef struct Intersecao{
     Coordenada antenaB;     // coordenadas da antena com frequencia B
 } Intersecao;
 
+/**
+ * @brief Iterador sobre os vertices de uma frequencia (estado constante)
+ */
+typedef struct IteradorFrequencia {
+    Grafo* grafo;           // grafo percorrido
+    char frequencia;        // frequencia pretendida
+    int posicao;            // posicao seguinte no grupo da frequencia
+} IteradorFrequencia;
+
+/**
+ * @brief Iterador sobre as intersecoes entre duas frequencias (estado constante)
+ */
+typedef struct IteradorIntersecoes {
+    Grafo* grafo;           // grafo percorrido
+    char frequenciaA;       // frequencia A
+    char frequenciaB;       // frequencia B
+    int posicaoA;           // posicao atual no grupo da frequencia A
+    int posicaoB;           // posicao seguinte no grupo da frequencia B
+} IteradorIntersecoes;
+
+/**
+ * @brief Estrutura para representar o cruzamento entre uma ligacao da frequencia A e uma da frequencia B
+ */
+typedef struct Cruzamento {
+    double x;               // coordenada x do ponto de cruzamento
+    double y;               // coordenada y do ponto de cruzamento
+    Coordenada segmentoA[2]; // extremos da ligacao da frequencia A
+    Coordenada segmentoB[2]; // extremos da ligacao da frequencia B
+} Cruzamento;
+
+/**
+ * @brief Efeito nefasto de um par de antenas da mesma frequencia, no formato plano da Fase1
+ * Os campos seguem o Nefasto da Fase1 (sem o next): linha e coluna contam a partir de 1
+ */
+typedef struct EfeitoNefasto {
+    int linha;              // linha do efeito (y + 1)
+    int coluna;             // coluna do efeito (x + 1)
+    int idAntena1;          // id do vertice mais proximo do efeito
+    int idAntena2;          // id do outro vertice do par
+} EfeitoNefasto;
+
+/**
+ * @brief Ordem pela qual os vertices sao dispostos na representacao compacta
+ */
+typedef enum OrdemVertices {
+    ORDEM_IDS,              // ordem dos ids do grafo original
+    ORDEM_HILBERT,          // ordem da curva de Hilbert sobre as posicoes (vizinhos no mapa ficam proximos)
+    ORDEM_FREQUENCIA        // agrupados por frequencia e, dentro de cada uma, pela curva de Hilbert
+} OrdemVertices;
+
+/**
+ * @brief Representacao congelada do grafo em arrays contiguos (CSR), so de leitura
+ */
+typedef struct GrafoCompacto {
+    int numVertices;        // numero de vertices (indices compactos 0..numVertices-1)
+    int numArestas;         // numero de arestas dirigidas
+    OrdemVertices ordem;    // ordem usada na disposicao dos vertices
+    Antena* antenas;        // antena de cada vertice, pela nova ordem
+    int* idOriginal;        // id no grafo de origem de cada vertice compacto
+    int* idCompacto;        // indice compacto de cada id do grafo de origem (-1 nos ids livres)
+    int limiteIdsOriginal;  // tamanho do array idCompacto
+    int* deslocamentos;     // vizinhos de v em vizinhos[deslocamentos[v] .. deslocamentos[v+1]-1] (NULL se carregado ja comprimido)
+    int* vizinhos;          // indices compactos dos destinos, por ordem crescente em cada vertice (NULL se comprimido)
+    double* pesos;          // peso de cada aresta, alinhado com vizinhos (NULL se comprimido)
+    MetricaPeso metrica;    // metrica dos pesos no grafo de origem
+    unsigned char* adjacenciaComprimida; // vizinhos em delta + varint (NULL se nao comprimido)
+    unsigned int* inicioComprimido; // linha de v em adjacenciaComprimida[inicio[v] .. inicio[v+1]-1]
+    int inicioFrequencia[NUM_FREQUENCIAS + 1]; // membros da frequencia f em membrosFrequencia[inicio[f] .. inicio[f+1]-1]
+    int* membrosFrequencia; // indices compactos agrupados por frequencia (crescentes em cada grupo)
+    int numForaDeOrdem;     // vertices acrescentados no fim por atualizarGrafoCompacto desde o ultimo congelarGrafo
+} GrafoCompacto;
+
+/**
+ * @brief Iterador sobre os vizinhos de um vertice do grafo compacto (comprimido ou nao)
+ */
+typedef struct IteradorVizinhos {
+    const GrafoCompacto* compacto; // grafo percorrido
+    unsigned int posicao;   // posicao seguinte (aresta ou byte, conforme o modo)
+    unsigned int fim;       // fim da linha do vertice
+    int anterior;           // ultimo vizinho devolvido (base do delta)
+} IteradorVizinhos;
+
+/**
+ * @brief Tipo de alteracao aplicada a um grafo partilhado
+ */
+typedef enum TipoAlteracao {
+    ALTERACAO_INSERIR,      // insere a antena e liga-a as antenas da mesma frequencia
+    ALTERACAO_REMOVER,      // remove a antena na posicao indicada
+    ALTERACAO_MOVER,        // move a antena para novaPosicao
+    ALTERACAO_FREQUENCIA    // muda a frequencia da antena para antena.frequencia
+} TipoAlteracao;
+
+/**
+ * @brief Alteracao a aplicar, num lote, a um grafo partilhado
+ */
+typedef struct Alteracao {
+    TipoAlteracao tipo;     // tipo de alteracao
+    Antena antena;          // antena a inserir ou posicao atual (+ nova frequencia) da antena a alterar
+    Coordenada novaPosicao; // destino, so para ALTERACAO_MOVER
+} Alteracao;
+
+/**
+ * @brief Grafo partilhado entre threads: leitores usam instantaneos imutaveis, escritores publicam novos
+ * A definicao esta em concorrente.c (usa tipos atomicos)
+ */
+typedef struct GrafoPartilhado GrafoPartilhado;
+
+/**
+ * @brief No de uma arvore k-d, guardado num array (os filhos sao indices nesse array)
+ */
+typedef struct NoKD {
+    Coordenada posicao;     // posicao da antena
+    int id;                 // id do vertice no grafo
+    int esquerdo;           // filho com coordenada menor no eixo (-1 se nao existir)
+    int direito;            // filho com coordenada maior ou igual no eixo (-1 se nao existir)
+    unsigned char eixo;     // eixo de divisao: 0 = x, 1 = y
+    bool removido;          // removido desde a ultima reconstrucao (continua a dividir o espaco)
+} NoKD;
+
+/**
+ * @brief Arvore k-d de duas dimensoes sobre as posicoes das antenas
+ */
+typedef struct ArvoreKD {
+    NoKD* nos;              // nos da arvore
+    int numNos;             // nos usados, incluindo os removidos
+    int capacidade;         // tamanho alocado do array de nos
+    int raiz;               // indice da raiz (-1 se vazia)
+    int numRemovidos;       // nos marcados como removidos
+    int numConstruidos;     // nos na ultima reconstrucao
+} ArvoreKD;
+
+/**
+ * @brief Indice espacial com uma arvore k-d global e uma por frequencia
+ */
+typedef struct IndiceEspacial {
+    ArvoreKD global;        // todas as antenas
+    ArvoreKD frequencias[NUM_FREQUENCIAS]; // antenas de cada frequencia
+} IndiceEspacial;
+
+/**
+ * @brief Tipo de consulta guardada na cache de consultas
+ */
+typedef enum TipoConsulta {
+    CONSULTA_LARGURA,       // buscaEmLargura a partir da origem
+    CONSULTA_PROFUNDIDADE,  // buscaEmProfundidade a partir da origem
+    CONSULTA_CAMINHOS,      // encontrarCaminhos entre origem e destino
+    CONSULTA_MENOS_SALTOS   // caminhoMenosSaltos entre origem e destino
+} TipoConsulta;
+
+/**
+ * @brief Resultado de uma consulta, em ids de vertices (vista sobre a entrada da cache)
+ * Os caminhos estao seguidos em ids: o caminho c ocupa ids[inicios[c] .. inicios[c+1]-1]
+ */
+typedef struct ResultadoConsulta {
+    bool encontrado;        // valor devolvido pela funcao consultada
+    const int* ids;         // vertices visitados ou caminhos seguidos
+    int tamanho;            // numero de ids
+    const int* inicios;     // numCaminhos + 1 posicoes (NULL nas buscas)
+    int numCaminhos;        // numero de caminhos (0 nas buscas)
+} ResultadoConsulta;
+
+/**
+ * @brief Entrada da cache de consultas
+ */
+typedef struct EntradaCache {
+    TipoConsulta tipo;      // tipo da consulta
+    RefVertice origem;      // vertice de origem
+    RefVertice destino;     // vertice de destino (id -1 nas buscas)
+    int parametro;          // maximo de caminhos guardados (0 = todos)
+    unsigned long geracao;  // geracao do grafo em que o resultado foi validado
+    RefVertice* dependencias; // membros do componente da origem quando o resultado foi calculado
+    int numDependencias;    // numero de dependencias
+    bool encontrado;        // valor devolvido pela funcao consultada
+    int* ids;               // resultado em ids de vertices
+    int tamanho;            // numero de ids
+    int* inicios;           // inicio de cada caminho em ids (numCaminhos + 1 posicoes)
+    int numCaminhos;        // numero de caminhos
+    int anterior;           // entrada usada mais recentemente antes desta (-1 se for a primeira)
+    int seguinte;           // entrada usada menos recentemente depois desta (-1 se for a ultima)
+    int proximaDispersao;   // entrada seguinte no mesmo balde (-1 se nao existir)
+} EntradaCache;
+
+/**
+ * @brief Cache LRU de resultados de consultas sobre um grafo
+ */
+typedef struct CacheConsultas {
+    Grafo* grafo;           // grafo consultado
+    EntradaCache* entradas; // entradas (capacidade posicoes)
+    int capacidade;         // numero maximo de entradas
+    int numEntradas;        // entradas em uso
+    int* baldes;            // primeira entrada de cada balde (-1 se vazio)
+    int numBaldes;          // numero de baldes (potencia de 2)
+    int maisRecente;        // cabeca da lista LRU (-1 se vazia)
+    int menosRecente;       // cauda da lista LRU (-1 se vazia)
+    int livres;             // primeira entrada livre, encadeadas por proximaDispersao (-1 se nao houver)
+    unsigned long acertos;  // consultas respondidas pela cache
+    unsigned long falhas;   // consultas calculadas (entrada inexistente)
+    unsigned long invalidacoes; // entradas recalculadas por o componente ter mudado
+} CacheConsultas;
+
 #endif // ESTRUTURAS_H
\ No newline at end of file
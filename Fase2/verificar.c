@@ -0,0 +1,400 @@
+/**
+ * @file verificar.c
+ * @author Matheus Delgado (a31542@alunos.ipca.pt)
+ * @brief Programa de verificacao das alteracoes do grafo e do instantaneo binario
+ * @details Gera (com semente fixa) um mapa de antenas, carrega-o com carregarDadosGrafo e aplica uma
+ * sequencia aleatoria de insercoes, remocoes, movimentos e mudancas de frequencia, sempre atraves de
+ * RefVertice. Depois de cada alteracao verifica os invariantes do grafo: lista de vertices e arrays
+ * por id, ids livres, arestas gemeas e graus de entrada, grupos de frequencia (cada grupo e um
+ * subgrafo completo, a regra de carregarDadosGrafo), tabela de coordenadas, pesos e componentes.
+ * Verifica tambem que referencias a vertices removidos deixam de resolver, mesmo quando o id e
+ * reutilizado, e, de tantas em tantas alteracoes, que gravarGrafoBinario seguido de
+ * carregarGrafoBinario devolve o mesmo grafo, com a mesma metrica e os mesmos pesos (a metrica muda a
+ * cada instantaneo). Depois de cada alteracao compara tambem consultarCache (largura, profundidade e
+ * menos saltos, com origens repetidas para que haja resultados guardados de geracoes anteriores) com
+ * buscaEmLargura, buscaEmProfundidade e caminhoMenosSaltos calculados de novo. Termina com 0 se tudo
+ * estiver certo, 1 se algum invariante falhar e 2 em caso de erro.
+ *
+ * Exemplo: verificar --semente 7 --lado 40 --alteracoes 5000
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2025
+ */
+#define _CRT_SECURE_NO_WARNINGS //para poder usar fopen sem erro
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include "grafo.h"
+#include "struct.h"
+
+#define VERIFICAR_FREQUENCIAS "ABCDEF"
+#define VERIFICAR_MAX_ANTIGAS 64    // referencias a vertices removidos guardadas para verificar
+#define VERIFICAR_MAX_ERROS 20      // erros mostrados antes de parar
+#define VERIFICAR_CAPACIDADE_CACHE 16 // entradas da cache de consultas (pequena para haver substituicoes)
+#define VERIFICAR_ORIGENS_CACHE 6   // ids preferidos como origem, para que as consultas se repitam
+#define VERIFICAR_CONSULTAS 3       // consultas a cache depois de cada alteracao
+
+/**
+ * @brief Parametros da verificacao
+ */
+typedef struct ConfiguracaoVerificar {
+    unsigned long long semente; // semente do gerador
+    int lado;               // lado do mapa gerado
+    double densidade;       // fracao das celulas com antena
+    int alteracoes;         // numero de alteracoes aleatorias
+    int intervaloInstantaneo; // alteracoes entre verificacoes do instantaneo binario
+    const char* temporario; // prefixo dos ficheiros temporarios
+} ConfiguracaoVerificar;
+
+/**
+ * @brief Estado da verificacao
+ */
+typedef struct Verificacao {
+    unsigned long long estado; // estado do gerador
+    int erros;              // invariantes que falharam
+    RefVertice antigas[VERIFICAR_MAX_ANTIGAS]; // referencias a vertices ja removidos
+    int numAntigas;
+} Verificacao;
+
+/**
+ * @brief Gerador xorshift64* (o mesmo resultado em todas as plataformas)
+ */
+static unsigned long long aleatorio(Verificacao* v) {
+    v->estado ^= v->estado >> 12;
+    v->estado ^= v->estado << 25;
+    v->estado ^= v->estado >> 27;
+    return v->estado * 2685821657736338717ull;
+}
+
+static int aleatorioAte(Verificacao* v, int n) {
+    return (int)(aleatorio(v) % (unsigned long long)n);
+}
+
+/**
+ * @brief Regista um invariante que falhou
+ */
+static void falhou(Verificacao* v, int passo, const char* mensagem, int id) {
+    if (v->erros < VERIFICAR_MAX_ERROS) fprintf(stderr, "passo %d: %s (id %d)\n", passo, mensagem, id);
+    v->erros++;
+}
+
+/**
+ * @brief Verifica todos os invariantes do grafo
+ * @return true se o grafo esta consistente
+ */
+static bool verificarInvariantes(Grafo* grafo, Verificacao* v, int passo) {
+    int errosAntes = v->erros;
+    int numVertices = 0, numArestas = 0;
+    int* grauEntrada = (int*)calloc(grafo->limiteIds > 0 ? grafo->limiteIds : 1, sizeof(int));
+    if (grauEntrada == NULL) return false;
+
+    // lista de vertices, arrays por id e arestas
+    for (NoVertice* u = grafo->primeiro; u != NULL; u = u->proximo) {
+        numVertices++;
+        if (u->id < 0 || u->id >= grafo->limiteIds || grafo->vertices[u->id] != u) falhou(v, passo, "vertice fora do array por id", u->id);
+        if (u->proximo != NULL && u->proximo->anterior != u) falhou(v, passo, "lista de vertices mal ligada", u->id);
+        if (encontrarVerticePorCoordenadas(grafo, u->dados.posicao.x, u->dados.posicao.y) != u) falhou(v, passo, "tabela de coordenadas", u->id);
+        GrupoFrequencia* grupo = &grafo->frequencias[(unsigned char)u->dados.frequencia];
+        if (u->posicaoGrupo < 0 || u->posicaoGrupo >= grupo->tamanho || grupo->membros[u->posicaoGrupo] != u) falhou(v, passo, "grupo de frequencia", u->id);
+        int grau = 0;
+        for (Aresta* a = u->primeiraAresta; a != NULL; a = a->proxima) {
+            numArestas++;
+            grau++;
+            grauEntrada[a->destino->id]++;
+            if (a->proxima != NULL && a->proxima->anterior != a) falhou(v, passo, "lista de arestas mal ligada", u->id);
+            if (a->gemea == NULL || a->gemea->gemea != a || a->gemea->destino != u) falhou(v, passo, "aresta sem gemea", u->id);
+            if (a->destino->dados.frequencia != u->dados.frequencia) falhou(v, passo, "aresta entre frequencias diferentes", u->id);
+            if (fabs(a->peso - distanciaVertices(u, a->destino, grafo->metrica)) > 1e-9) falhou(v, passo, "peso desatualizado", u->id);
+        }
+        // cada grupo de frequencia e um subgrafo completo
+        if (grau != grupo->tamanho - 1) falhou(v, passo, "grau diferente do tamanho do grupo", u->id);
+    }
+    if (numVertices != grafo->numVertices) falhou(v, passo, "numVertices", numVertices);
+    if (numArestas != grafo->numArestas) falhou(v, passo, "numArestas", numArestas);
+    for (int id = 0; id < grafo->limiteIds; id++) {
+        if (grafo->vertices[id] != NULL && grafo->vertices[id]->grauEntrada != grauEntrada[id]) falhou(v, passo, "grau de entrada", id);
+    }
+    free(grauEntrada);
+
+    // ids livres: todos vazios e, com os usados, cobrem [0, limiteIds)
+    for (int i = 0; i < grafo->numIdsLivres; i++) {
+        if (grafo->vertices[grafo->idsLivres[i]] != NULL) falhou(v, passo, "id livre em uso", grafo->idsLivres[i]);
+    }
+    if (numVertices + grafo->numIdsLivres != grafo->limiteIds) falhou(v, passo, "ids perdidos", grafo->limiteIds);
+
+    // componentes: com grupos completos, cada grupo nao vazio e um componente
+    int gruposNaoVazios = 0, somaGrupos = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        GrupoFrequencia* grupo = &grafo->frequencias[f];
+        somaGrupos += grupo->tamanho;
+        if (grupo->tamanho == 0) continue;
+        gruposNaoVazios++;
+        NoVertice* primeiro = grupo->membros[0];
+        if (tamanhoComponente(grafo, primeiro) != grupo->tamanho) falhou(v, passo, "tamanho do componente", primeiro->id);
+        NoVertice* outro = grupo->membros[grupo->tamanho - 1];
+        if (!mesmoComponente(grafo, primeiro, outro)) falhou(v, passo, "grupo separado em componentes", outro->id);
+    }
+    if (somaGrupos != numVertices) falhou(v, passo, "soma dos grupos", somaGrupos);
+    if (numeroComponentes(grafo) != gruposNaoVazios) falhou(v, passo, "numero de componentes", numeroComponentes(grafo));
+    return v->erros == errosAntes;
+}
+
+/**
+ * @brief Verifica que as referencias a vertices removidos nunca resolvem, mesmo com o id reutilizado
+ */
+static bool verificarReferenciasAntigas(Grafo* grafo, Verificacao* v, int passo) {
+    int errosAntes = v->erros;
+    for (int i = 0; i < v->numAntigas; i++) {
+        if (resolverReferencia(grafo, v->antigas[i]) != NULL) falhou(v, passo, "referencia antiga resolvida", v->antigas[i].id);
+    }
+    return v->erros == errosAntes;
+}
+
+/**
+ * @brief Verifica que o instantaneo binario devolve o mesmo grafo (comparado por coordenadas)
+ */
+static bool verificarInstantaneo(Grafo* grafo, Verificacao* v, int passo, const char* ficheiro) {
+    if (!gravarGrafoBinario(grafo, ficheiro)) {
+        falhou(v, passo, "gravarGrafoBinario", -1);
+        return false;
+    }
+    Grafo* lido = carregarGrafoBinario(ficheiro);
+    remove(ficheiro);
+    if (lido == NULL) {
+        falhou(v, passo, "carregarGrafoBinario", -1);
+        return false;
+    }
+    int errosAntes = v->erros;
+    if (lido->numVertices != grafo->numVertices || lido->numArestas != grafo->numArestas) falhou(v, passo, "instantaneo com outro tamanho", lido->numVertices);
+    if (lido->metrica != grafo->metrica) falhou(v, passo, "instantaneo com outra metrica", (int)lido->metrica);
+    for (NoVertice* u = grafo->primeiro; u != NULL; u = u->proximo) {
+        NoVertice* copia = encontrarVerticePorCoordenadas(lido, u->dados.posicao.x, u->dados.posicao.y);
+        if (copia == NULL || copia->dados.frequencia != u->dados.frequencia) {
+            falhou(v, passo, "vertice diferente no instantaneo", u->id);
+            continue;
+        }
+        for (Aresta* a = u->primeiraAresta; a != NULL; a = a->proxima) {
+            Coordenada p = a->destino->dados.posicao;
+            NoVertice* destino = encontrarVerticePorCoordenadas(lido, p.x, p.y);
+            Aresta* b = copia->primeiraAresta;
+            while (b != NULL && b->destino != destino) b = b->proxima;
+            if (b == NULL) falhou(v, passo, "aresta em falta no instantaneo", u->id);
+            else if (fabs(b->peso - a->peso) > 1e-9) falhou(v, passo, "peso diferente no instantaneo", u->id);
+        }
+    }
+    verificarInvariantes(lido, v, passo);
+    libertarGrafo(lido);
+    return v->erros == errosAntes;
+}
+
+/**
+ * @brief Escolhe um vertice ao acaso (NULL se o grafo estiver vazio)
+ */
+static NoVertice* verticeAleatorio(Grafo* grafo, Verificacao* v) {
+    if (grafo->numVertices == 0) return NULL;
+    NoVertice* u;
+    do {
+        u = grafo->vertices[aleatorioAte(v, grafo->limiteIds)];
+    } while (u == NULL);
+    return u;
+}
+
+/**
+ * @brief Compara uma lista de vertices calculada agora com os ids guardados na cache
+ */
+static bool mesmosIds(NoVertice** vertices, int tamanho, const ResultadoConsulta* resultado) {
+    if (tamanho != resultado->tamanho) return false;
+    for (int i = 0; i < tamanho; i++) {
+        if (vertices[i]->id != resultado->ids[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Compara consultas a cache com as mesmas procuras feitas de novo sobre o grafo atual
+ * As origens sao escolhidas de preferencia entre os primeiros ids, para que muitas consultas encontrem
+ * resultados guardados antes das ultimas alteracoes e passem pela validacao por componente
+ * @return false em caso de erro de memoria
+ */
+static bool verificarCache(Grafo* grafo, CacheConsultas* cache, Verificacao* v, int passo) {
+    for (int q = 0; q < VERIFICAR_CONSULTAS && grafo->numVertices > 0; q++) {
+        NoVertice* origem = grafo->vertices[aleatorioAte(v, grafo->limiteIds < VERIFICAR_ORIGENS_CACHE ? grafo->limiteIds : VERIFICAR_ORIGENS_CACHE)];
+        if (origem == NULL) origem = verticeAleatorio(grafo, v);
+        NoVertice* destino = verticeAleatorio(grafo, v);
+        TipoConsulta tipo = (TipoConsulta)aleatorioAte(v, 3);
+        if (tipo == CONSULTA_CAMINHOS) tipo = CONSULTA_MENOS_SALTOS; // todos os caminhos numa clique crescem exponencialmente
+        ResultadoConsulta resultado;
+        if (!consultarCache(cache, tipo, origem, destino, 0, &resultado)) return false;
+
+        NoVertice** vertices = NULL;
+        int tamanho = 0;
+        bool encontrado;
+        if (tipo == CONSULTA_MENOS_SALTOS) {
+            int saltos = 0;
+            encontrado = caminhoMenosSaltos(grafo, origem, destino, &saltos, &vertices, &tamanho);
+        }
+        else {
+            bool* visitados = (bool*)calloc(grafo->numVertices, sizeof(bool));
+            if (visitados == NULL) return false;
+            encontrado = tipo == CONSULTA_LARGURA
+                ? buscaEmLargura(grafo, origem, visitados, &vertices, &tamanho)
+                : buscaEmProfundidade(grafo, origem, visitados, &vertices, &tamanho);
+            free(visitados);
+        }
+        if (!encontrado) tamanho = 0;
+        if (resultado.encontrado != encontrado || !mesmosIds(vertices, tamanho, &resultado)) {
+            falhou(v, passo, tipo == CONSULTA_LARGURA ? "cache de buscaEmLargura desatualizada"
+                : tipo == CONSULTA_PROFUNDIDADE ? "cache de buscaEmProfundidade desatualizada"
+                : "cache de caminhoMenosSaltos desatualizada", origem->id);
+        }
+        free(vertices);
+    }
+    return true;
+}
+
+/**
+ * @brief Aplica uma alteracao aleatoria, com a regra de ligacao de carregarDadosGrafo
+ * @return false em caso de erro de memoria
+ */
+static bool alteracaoAleatoria(Grafo* grafo, Verificacao* v, const ConfiguracaoVerificar* config, int passo) {
+    int tipo = aleatorioAte(v, 4);
+    int x = aleatorioAte(v, config->lado), y = aleatorioAte(v, config->lado);
+    char frequencia = VERIFICAR_FREQUENCIAS[aleatorioAte(v, (int)sizeof(VERIFICAR_FREQUENCIAS) - 1)];
+    if (tipo == 0 || grafo->numVertices == 0) {
+        if (encontrarVerticePorCoordenadas(grafo, x, y) != NULL) return true;
+        Antena antena = { frequencia, { x, y } };
+        NoVertice* novo = adicionarVertice(grafo, antena);
+        if (novo == NULL) return false;
+        int tamanho = 0;
+        NoVertice* const* membros = obterVerticesFrequencia(grafo, frequencia, &tamanho);
+        for (int i = 0; i < tamanho; i++) {
+            if (membros[i] != novo && !anexarArestaDupla(grafo, novo, membros[i])) return false;
+        }
+        return true;
+    }
+    NoVertice* u = verticeAleatorio(grafo, v);
+    RefVertice ref = obterReferencia(grafo, u->id);
+    if (resolverReferencia(grafo, ref) != u) falhou(v, passo, "referencia nova nao resolve", u->id);
+    if (tipo == 1) {
+        if (!removerVertice(grafo, ref)) falhou(v, passo, "removerVertice", ref.id);
+        if (removerVertice(grafo, ref) || moverVertice(grafo, ref, x, y) || alterarFrequencia(grafo, ref, frequencia)) {
+            falhou(v, passo, "referencia removida aceite", ref.id);
+        }
+        v->antigas[v->numAntigas++ % VERIFICAR_MAX_ANTIGAS] = ref;
+        if (v->numAntigas > VERIFICAR_MAX_ANTIGAS) v->numAntigas = VERIFICAR_MAX_ANTIGAS;
+        return true;
+    }
+    if (tipo == 2) {
+        bool ocupada = encontrarVerticePorCoordenadas(grafo, x, y) != NULL && encontrarVerticePorCoordenadas(grafo, x, y) != u;
+        if (moverVertice(grafo, ref, x, y) == ocupada) falhou(v, passo, "moverVertice", ref.id);
+        return true;
+    }
+    if (!alterarFrequencia(grafo, ref, frequencia)) return false;
+    if (u->dados.frequencia != frequencia) falhou(v, passo, "alterarFrequencia", ref.id);
+    return true;
+}
+
+/**
+ * @brief Grava um mapa aleatorio no formato lido por carregarDadosGrafo
+ */
+static bool gerarMapa(const ConfiguracaoVerificar* config, Verificacao* v, const char* ficheiro) {
+    FILE* fp = fopen(ficheiro, "w");
+    if (fp == NULL) return false;
+    for (int y = 0; y < config->lado; y++) {
+        for (int x = 0; x < config->lado; x++) {
+            bool antena = (double)(aleatorio(v) % 1000000) / 1000000.0 < config->densidade;
+            fputc(antena ? VERIFICAR_FREQUENCIAS[aleatorioAte(v, (int)sizeof(VERIFICAR_FREQUENCIAS) - 1)] : '.', fp);
+        }
+        fputc('\n', fp);
+    }
+    return fclose(fp) == 0;
+}
+
+static void mostrarUso(const char* programa) {
+    fprintf(stderr,
+        "Uso: %s [opcoes]\n"
+        "  --semente S            semente do gerador (omissao 1)\n"
+        "  --lado L               lado do mapa gerado, 2..250 (omissao 40)\n"
+        "  --densidade D          fracao de celulas com antena (omissao 0.05)\n"
+        "  --alteracoes N         alteracoes aleatorias (omissao 2000)\n"
+        "  --instantaneo K        verifica o instantaneo binario a cada K alteracoes (omissao 100)\n"
+        "  --temporario prefixo   prefixo dos ficheiros temporarios (omissao verificar_tmp)\n", programa);
+}
+
+/**
+ * @brief Le os argumentos da linha de comandos
+ */
+static bool lerArgumentos(int argc, char* argv[], ConfiguracaoVerificar* config) {
+    for (int i = 1; i < argc; i += 2) {
+        const char* opcao = argv[i];
+        const char* valor = i + 1 < argc ? argv[i + 1] : NULL;
+        if (valor == NULL) return false;
+        if (strcmp(opcao, "--semente") == 0) config->semente = strtoull(valor, NULL, 10);
+        else if (strcmp(opcao, "--lado") == 0) config->lado = atoi(valor);
+        else if (strcmp(opcao, "--densidade") == 0) config->densidade = atof(valor);
+        else if (strcmp(opcao, "--alteracoes") == 0) config->alteracoes = atoi(valor);
+        else if (strcmp(opcao, "--instantaneo") == 0) config->intervaloInstantaneo = atoi(valor);
+        else if (strcmp(opcao, "--temporario") == 0) config->temporario = valor;
+        else return false;
+    }
+    // carregarDadosGrafo le linhas de ate 255 caracteres
+    return config->lado >= 2 && config->lado <= 250 && config->densidade > 0 && config->densidade <= 1 &&
+        config->alteracoes >= 0 && config->intervaloInstantaneo >= 1;
+}
+
+int main(int argc, char* argv[]) {
+    ConfiguracaoVerificar config = { 1, 40, 0.05, 2000, 100, "verificar_tmp" };
+    if (!lerArgumentos(argc, argv, &config)) {
+        mostrarUso(argv[0]);
+        return 2;
+    }
+    Verificacao v;
+    memset(&v, 0, sizeof(v));
+    v.estado = config.semente * 0x9E3779B97F4A7C15ull + 1;
+
+    char mapa[512], instantaneo[512];
+    snprintf(mapa, sizeof(mapa), "%s.txt", config.temporario);
+    snprintf(instantaneo, sizeof(instantaneo), "%s.bin", config.temporario);
+    if (!gerarMapa(&config, &v, mapa)) {
+        fprintf(stderr, "Nao foi possivel gravar %s\n", mapa);
+        return 2;
+    }
+    Grafo* grafo = carregarDadosGrafo(mapa);
+    remove(mapa);
+    if (grafo == NULL) return 2;
+
+    CacheConsultas* cache = criarCacheConsultas(grafo, VERIFICAR_CAPACIDADE_CACHE);
+    if (cache == NULL) {
+        libertarGrafo(grafo);
+        return 2;
+    }
+    bool erroMemoria = false;
+    verificarInvariantes(grafo, &v, 0);
+    verificarInstantaneo(grafo, &v, 0, instantaneo);
+    for (int passo = 1; passo <= config.alteracoes && v.erros < VERIFICAR_MAX_ERROS; passo++) {
+        if (!alteracaoAleatoria(grafo, &v, &config, passo)) {
+            erroMemoria = true;
+            break;
+        }
+        verificarInvariantes(grafo, &v, passo);
+        verificarReferenciasAntigas(grafo, &v, passo);
+        if (!verificarCache(grafo, cache, &v, passo)) {
+            erroMemoria = true;
+            break;
+        }
+        if (passo % config.intervaloInstantaneo == 0) {
+            // cada instantaneo usa a metrica seguinte, para que a metrica e os pesos tambem sejam gravados e lidos
+            definirMetricaPesos(grafo, (MetricaPeso)((passo / config.intervaloInstantaneo) % 3));
+            verificarInstantaneo(grafo, &v, passo, instantaneo);
+        }
+    }
+    printf("alteracoes=%d vertices=%d arestas=%d ids=%d erros=%d\n",
+        config.alteracoes, grafo->numVertices, grafo->numArestas, grafo->limiteIds, v.erros);
+    printf("cache: acertos=%lu falhas=%lu invalidacoes=%lu\n", cache->acertos, cache->falhas, cache->invalidacoes);
+    libertarCacheConsultas(cache);
+    libertarGrafo(grafo);
+    if (erroMemoria) return 2;
+    return v.erros > 0 ? 1 : 0;
+}